@@ -0,0 +1,317 @@
+/**
+ * @file benchmark.cpp
+ * @brief Google Benchmark suite for the reductions, fit() and ci_slope()
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Sweeps n = 3, 10, 100, ..., 10⁹ for float and double and runs every
+ * reduction
+ * - sequentially and on the parallel backend (Stats::exec::seq / exec::par)
+ * - with the scalar kernels and with the best SIMD kernels of this machine
+ *
+ * Name scheme: <function>/<type>/<seq|par>/<isa>/n. Throughput is reported as
+ * bytes_per_second (input read plus output written) and, for the fits, as
+ * fits/s. Batched fits compare K calls of fit() with one call of fit_batch()
+ * over K series of the same total size.
+ *
+ * Two input arrays of 10⁹ doubles take 16 GB, so sizes above
+ * LINREG_BENCH_MAX_N (environment variable, default 2²⁶) are not registered.
+ *
+ * Usage:
+ * @code
+ * benchmark --benchmark_filter='fit/double/par'
+ * LINREG_BENCH_MAX_N=1000000000 benchmark --benchmark_filter='mean/float'
+ * @endcode
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "batch.h"
+#include "diagnostics.h"
+#include "linreg.h"
+#include "simd_kernels.h"
+#include "stats.h"
+
+namespace {
+
+	/// Largest n registered; LINREG_BENCH_MAX_N overrides the default of 2²⁶.
+	std::size_t max_n()
+	{
+		if (const char* env = std::getenv("LINREG_BENCH_MAX_N"))
+			return static_cast<std::size_t>(std::strtoull(env, nullptr, 10));
+		return std::size_t{ 1 } << 26;
+	}
+
+	/// Selects the kernels for the duration of one benchmark.
+	class IsaScope {
+	public:
+		explicit IsaScope(Stats::simd::Isa isa) : previous_(Stats::simd::active_isa()) { Stats::simd::set_isa(isa); }
+		~IsaScope() { Stats::simd::set_isa(previous_); }
+
+		IsaScope(const IsaScope&) = delete;
+		IsaScope& operator=(const IsaScope&) = delete;
+
+	private:
+		Stats::simd::Isa previous_;
+	};
+
+	/// Points on a noisy line y = 1 + 2x; fixed seed, so every run sees the same data.
+	template <typename T>
+	struct Data {
+		std::vector<T> x, y;
+
+		explicit Data(std::size_t n) : x(n), y(n)
+		{
+			std::mt19937_64 gen(42);
+			std::normal_distribution<T> noise(T{ 0 }, T{ 1 });
+			for (std::size_t i = 0; i < n; ++i) {
+				x[i] = static_cast<T>(i % 1000) * T{ 0.01 };
+				y[i] = T{ 1 } + T{ 2 } * x[i] + noise(gen);
+			}
+		}
+
+		[[nodiscard]] std::span<const T> xs() const noexcept { return x; }
+		[[nodiscard]] std::span<const T> ys() const noexcept { return y; }
+	};
+
+	void set_throughput(benchmark::State& state, std::size_t bytes_per_iteration)
+	{
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes_per_iteration));
+	}
+
+	void set_fit_rate(benchmark::State& state, std::size_t fits_per_iteration)
+	{
+		state.counters["fits/s"] = benchmark::Counter(
+			static_cast<double>(state.iterations() * fits_per_iteration), benchmark::Counter::kIsRate);
+	}
+
+	// ---------------------------------------------------------------
+	// Benchmarks; argument 0 is n (total number of points)
+	// ---------------------------------------------------------------
+
+	template <typename T, class Policy>
+	void bm_mean(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		const IsaScope scope(isa);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(Stats::mean(d.xs(), Policy{}));
+		set_throughput(state, n * sizeof(T));
+	}
+
+	template <typename T, class Policy>
+	void bm_shift(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		std::vector<T> out(n);
+		const IsaScope scope(isa);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(Stats::shift_into(d.xs(), std::span<T>(out), Policy{}));
+			benchmark::ClobberMemory();
+		}
+		// mean() reads x, the centering pass reads x again and writes out
+		set_throughput(state, 3 * n * sizeof(T));
+	}
+
+	template <typename T, class Policy>
+	void bm_inner_product(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		const IsaScope scope(isa);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(Stats::inner_product(d.xs(), d.ys(), Policy{}));
+		set_throughput(state, 2 * n * sizeof(T));
+	}
+
+	template <typename T, class Policy>
+	void bm_fit(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		const IsaScope scope(isa);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(LinearRegression::fit(d.xs(), d.ys(), Policy{}));
+		set_throughput(state, 2 * n * sizeof(T));
+		set_fit_rate(state, 1);
+	}
+
+	template <typename T, class Policy>
+	void bm_fit_fused(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		const IsaScope scope(isa);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(LinearRegression::fit_fused(d.xs(), d.ys(), Policy{}));
+		set_throughput(state, 2 * n * sizeof(T));
+		set_fit_rate(state, 1);
+	}
+
+	template <typename T, class Policy>
+	void bm_fit_coefficients(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		const IsaScope scope(isa);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(LinearRegression::fit(d.xs(), d.ys(), LinearRegression::FitRequest::coefficients, Policy{}));
+		set_throughput(state, 2 * n * sizeof(T));
+		set_fit_rate(state, 1);
+	}
+
+	template <typename T, class Policy>
+	void bm_fit_diagnostics(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto n = static_cast<std::size_t>(state.range(0));
+		const Data<T> d(n);
+		std::vector<T> residuals(n), leverage(n), standardized(n), cooks(n);
+		const LinearRegression::DiagnosticBuffers<T> out{ residuals, leverage, standardized, cooks };
+		const IsaScope scope(isa);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(LinearRegression::fit(d.xs(), d.ys(), out, Policy{}));
+			benchmark::ClobberMemory();
+		}
+		// Input read plus the four rows written
+		set_throughput(state, 6 * n * sizeof(T));
+		set_fit_rate(state, 1);
+	}
+
+	// Argument 1 is the length of each series; K = n / length
+
+	template <typename T, class Policy>
+	void bm_fit_single(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto length = static_cast<std::size_t>(state.range(1));
+		const auto k = static_cast<std::size_t>(state.range(0)) / length;
+		const Data<T> d(k * length);
+		const IsaScope scope(isa);
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < k; ++i)
+				benchmark::DoNotOptimize(LinearRegression::fit(
+					d.xs().subspan(i * length, length), d.ys().subspan(i * length, length), Policy{}));
+		}
+		set_throughput(state, 2 * k * length * sizeof(T));
+		set_fit_rate(state, k);
+	}
+
+	template <typename T, class Policy>
+	void bm_fit_batch(benchmark::State& state, Stats::simd::Isa isa)
+	{
+		const auto length = static_cast<std::size_t>(state.range(1));
+		const auto k = static_cast<std::size_t>(state.range(0)) / length;
+		const Data<T> d(k * length);
+		std::vector<LinearRegression::FitResult<T>> out(k);
+		const IsaScope scope(isa);
+		for (auto _ : state) {
+			LinearRegression::fit_batch(d.xs(), d.ys(), length, std::span<LinearRegression::FitResult<T>>(out), Policy{});
+			benchmark::ClobberMemory();
+		}
+		set_throughput(state, 2 * k * length * sizeof(T));
+		set_fit_rate(state, k);
+	}
+
+	template <typename T>
+	void bm_ci_slope(benchmark::State& state)
+	{
+		const Data<T> d(1000);
+		auto r = LinearRegression::fit(d.xs(), d.ys());
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(r);
+			benchmark::DoNotOptimize(LinearRegression::ci_slope(r, T{ 0.05 }));
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// ---------------------------------------------------------------
+	// Registration
+	// ---------------------------------------------------------------
+
+	std::vector<std::int64_t> sizes(std::size_t limit)
+	{
+		std::vector<std::int64_t> out{ 3 };
+		for (std::int64_t n = 10; n <= 1'000'000'000 && static_cast<std::size_t>(n) <= limit; n *= 10)
+			out.push_back(n);
+		return out;
+	}
+
+	template <typename T>
+	constexpr const char* type_name() { return std::is_same_v<T, float> ? "float" : "double"; }
+
+	template <class Policy>
+	constexpr const char* policy_name() { return std::is_same_v<Policy, Stats::exec::parallel_policy> ? "par" : "seq"; }
+
+	template <typename T, class Policy, class F>
+	void register_sweep(const char* name, F f, std::size_t limit)
+	{
+		std::vector<Stats::simd::Isa> isas{ Stats::simd::Isa::scalar };
+		if (Stats::simd::best_isa() != Stats::simd::Isa::scalar)
+			isas.push_back(Stats::simd::best_isa());
+		for (const auto isa : isas) {
+			const auto full = std::string(name) + "/" + type_name<T>() + "/" + policy_name<Policy>()
+				+ "/" + Stats::simd::isa_name(isa);
+			auto* b = benchmark::RegisterBenchmark(full.c_str(), f, isa);
+			for (const auto n : sizes(limit))
+				b->Arg(n);
+			b->UseRealTime();
+		}
+	}
+
+	template <typename T, class Policy, class F>
+	void register_batched(const char* name, F f, std::size_t limit)
+	{
+		const auto full = std::string(name) + "/" + type_name<T>() + "/" + policy_name<Policy>()
+			+ "/" + Stats::simd::isa_name(Stats::simd::best_isa());
+		auto* b = benchmark::RegisterBenchmark(full.c_str(), f, Stats::simd::best_isa());
+		for (const std::int64_t length : { 16, 256, 4096 }) {
+			for (const auto n : sizes(limit)) {
+				if (n >= 16 * length)
+					b->Args({ n, length });
+			}
+		}
+		b->UseRealTime();
+	}
+
+	template <typename T, class Policy>
+	void register_all(std::size_t limit)
+	{
+		register_sweep<T, Policy>("mean", bm_mean<T, Policy>, limit);
+		register_sweep<T, Policy>("shift", bm_shift<T, Policy>, limit);
+		register_sweep<T, Policy>("inner_product", bm_inner_product<T, Policy>, limit);
+		register_sweep<T, Policy>("fit", bm_fit<T, Policy>, limit);
+		register_sweep<T, Policy>("fit_fused", bm_fit_fused<T, Policy>, limit);
+		register_sweep<T, Policy>("fit_coefficients", bm_fit_coefficients<T, Policy>, limit);
+		register_sweep<T, Policy>("fit_diagnostics", bm_fit_diagnostics<T, Policy>, limit);
+		register_batched<T, Policy>("fit_single", bm_fit_single<T, Policy>, limit);
+		register_batched<T, Policy>("fit_batch", bm_fit_batch<T, Policy>, limit);
+	}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	const auto limit = max_n();
+	register_all<float, Stats::exec::sequenced_policy>(limit);
+	register_all<float, Stats::exec::parallel_policy>(limit);
+	register_all<double, Stats::exec::sequenced_policy>(limit);
+	register_all<double, Stats::exec::parallel_policy>(limit);
+	benchmark::RegisterBenchmark("ci_slope/float", bm_ci_slope<float>);
+	benchmark::RegisterBenchmark("ci_slope/double", bm_ci_slope<double>);
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
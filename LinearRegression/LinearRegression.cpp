@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <optional>
 #include <cstdio>
@@ -7,94 +8,34 @@
 #include <span>
 #include <random>
 #include <iostream>
+#include "csv_parser.h"
 #include "linreg.h"
+#include "gnuplot_wrapper.h"
 
-// Öffnet gnuplot per Pipe (Windows + Linux)
-std::optional<FILE*> open_gnuplot()
+int plot_chart(const std::span<double>& x, const std::span<double>& y)
 {
-    // Versucht, gnuplot zu starten
-    // Unter Windows verwenden wir _popen, unter Linux popen
-    // "gnuplot -persistent" sorgt dafür, dass das Fenster offen bleibt
-    FILE* gp{};
-#ifdef _WIN32
-    gp = _popen("gnuplot -persistent", "w");
-#else
-    gp = popen("gnuplot -persistent", "w");
-#endif
-    if (gp == nullptr) {
+    // Pipe zu gnuplot; Daten werden binär und gepuffert übertragen
+    GnuplotWrapper gp;
+    if (!gp.is_open()) {
         fprintf(stderr, "Error: Could not open gnuplot. Make sure it is installed and in your PATH.\n");
-        return std::nullopt;
+        return 1;
     }
-    return gp;
-}
-
-void close_gnuplot(FILE* gp)
-{
-#ifdef _WIN32
-    _pclose(gp);
-#else
-    pclose(gp);
-#endif
-}
-
-int plot_chart(const std::span<double>& x, const std::span<double>& y)
-{
-    auto res = LinearRegression::fit(x, y);
-    auto ci_pair = LinearRegression::ci_slope(res, 0.01); // 95%-KI, alpha=0.05
-
-    // Einfaches konstantes Konfidenzintervall (Demo)
-	double ci = 0.5 * (ci_pair.second - ci_pair.first); // Halbbreite des Intervalls
-
-    // ci = 0.3;
-
-    // Lineare Regression (Demo-Werte)
-    double a = res.beta0;   // Intercept
-    double b = res.beta1;   // Steigung
-
-    auto gpo = open_gnuplot();
-    if (gpo == std::nullopt) return 1;
-	auto gp = gpo.value();
 
     // Terminal: qt ist interaktiv; unterstützt meist Transparenz
-    fprintf(gp, "set term qt\n");  // optional, je nach System
-    fprintf(gp, "set grid\n");
-    fprintf(gp, "set key left top\n");
+    gp.send_command("set term qt");  // optional, je nach System
+    gp.send_command("set grid");
+    gp.send_command("set key left top");
 
     // Transparenz-Style für Füllungen (alpha 0..1)
-    fprintf(gp, "set style fill transparent solid 0.20 noborder\n");
-    fprintf(gp, "set border linewidth 1\n");
-
-    // Plot: erst CI-Band, dann Regression, dann Punkte (oben)
-    fprintf(gp,
-        "plot "
-        "'-' using 1:2:3 with filledcurves title '95%% CI', "
-        "'-' with lines lw 2 dashtype 0.8 title 'Regression', "
-        "'-' with points pt 7 ps 0.8 title 'Data'\n"
-    );
-
-    // 1) Konfidenzintervall (x, lower, upper)
-    for (double xi : x) {
-        double yhat = a + b * xi;
-        fprintf(gp, "%f %f %f\n", xi, yhat - ci, yhat + ci);
-    }
-    fprintf(gp, "e\n");
-
-    // 2) Regressionsgerade
-    for (double xi : x)
-        fprintf(gp, "%f %f\n", xi, a + b * xi);
-    fprintf(gp, "e\n");
-
-    // 3) Punktewolke
-    for (size_t i = 0; i < x.size(); ++i)
-        fprintf(gp, "%f %f\n", x[i], y[i]);
-    fprintf(gp, "e\n");
+    gp.send_command("set style fill transparent solid 0.20 noborder");
+    gp.send_command("set border linewidth 1");
 
-
-    fflush(gp);
-    close_gnuplot(gp);
+    // Plot: Prognose- und Konfidenzband (95%), Regressionsgerade, Punktewolke
+    // Große Punktewolken werden auf Bildschirmauflösung reduziert
+    return gp.plot(x, y) ? 0 : 1;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     {
         // Boost test
@@ -131,6 +72,18 @@ int main()
         plot_chart(x, y);
 
     }
+
+    // Test case 3: Datei (CSV, Spalten x und y) von der Kommandozeile
+    if (argc > 1) {
+        const std::vector<std::size_t> columns = { 0, 1 };
+        auto data = LinearRegression::parse_file<double>(argv[1], columns);
+        std::cout << argv[1] << ": " << data.stats.rows << " rows, "
+            << data.stats.malformed << " malformed rows skipped\n";
+
+        auto res = LinearRegression::fit(data.columns[0], data.columns[1]);
+        std::cout << "beta0 = " << res.beta0 << ", beta1 = " << res.beta1 << "\n";
+        plot_chart(data.columns[0], data.columns[1]);
+    }
     
     return 0;
 
@@ -0,0 +1,135 @@
+/**
+ * @file accumulator.h
+ * @brief Incremental (online) linear regression without storing the data
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * The accumulator keeps only the sufficient statistics of the points seen so
+ * far (count, means and centered co-moments). Points can be added one at a
+ * time or in chunks, a FitResult can be requested at any moment, and partial
+ * accumulators (per thread, per shard) combine in O(1) with merge().
+ */
+
+#pragma once
+
+#include <span>
+#include <stdexcept>
+#include "span_compatible.h"
+#include "stats.h"
+#include "linreg.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Online least-squares accumulator
+	 * @tparam T Floating-point type of the data and statistics
+	 *
+	 * Example:
+	 * @code
+	 * LinearRegression::Accumulator<double> acc;
+	 * for (auto [t, v] : telemetry)
+	 *     acc.push(t, v);
+	 * auto result = acc.result();   // same shape as LinearRegression::fit()
+	 *
+	 * // Combine partial results computed on other threads
+	 * acc.merge(other_acc);
+	 * @endcode
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	class Accumulator {
+	public:
+		Accumulator() = default;
+
+		/// @brief Starts from previously computed sufficient statistics.
+		explicit constexpr Accumulator(const Stats::CoMoments<T>& moments) noexcept
+			: moments_(moments) {}
+
+		/// @brief Adds a single point (Welford update, O(1)).
+		constexpr void push(T x, T y) noexcept
+		{
+			moments_.push(x, y);
+		}
+
+		/**
+		 * @brief Adds a chunk of points.
+		 * @throws std::invalid_argument if x and y differ in size.
+		 *
+		 * The chunk is reduced with the blocked kernel of Stats::co_moments()
+		 * and merged, which is faster and more accurate than pushing point by point.
+		 */
+		void push(std::span<const T> x, std::span<const T> y)
+		{
+			if (x.size() != y.size())
+				throw std::invalid_argument("Accumulator::push: vectors must have same size");
+			moments_.merge(Stats::co_moments(x, y));
+		}
+
+		/**
+		 * @brief Adds a chunk stored in another precision (e.g. float data into Accumulator<double>).
+		 * @throws std::invalid_argument if x and y differ in size.
+		 */
+		template <std::floating_point U>
+			requires (!std::same_as<U, T>)
+		void push(std::span<const U> x, std::span<const U> y)
+		{
+			if (x.size() != y.size())
+				throw std::invalid_argument("Accumulator::push: vectors must have same size");
+			moments_.merge(Stats::co_moments<U, T>(x, y));
+		}
+
+		/// @brief Convenience overload: accepts any SpanCompatible container.
+		template <Helper::SpanCompatible C>
+			requires std::same_as<typename C::value_type, T>
+		void push(const C& x, const C& y)
+		{
+			push(Helper::as_span(x), Helper::as_span(y));
+		}
+
+		/// @brief Combines the points of another accumulator into this one (O(1)).
+		constexpr Accumulator& merge(const Accumulator& other) noexcept
+		{
+			moments_.merge(other.moments_);
+			return *this;
+		}
+
+		/// @brief Regression statistics of all points seen so far (see fit_from_moments()).
+		[[nodiscard]]
+		constexpr FitResult<T> result() const
+		{
+			return fit_from_moments(moments_);
+		}
+
+		/// @brief Sufficient statistics of all points seen so far.
+		[[nodiscard]]
+		constexpr const Stats::CoMoments<T>& moments() const noexcept
+		{
+			return moments_;
+		}
+
+		/// @brief Number of points seen so far.
+		[[nodiscard]]
+		constexpr std::size_t size() const noexcept
+		{
+			return moments_.n;
+		}
+
+		/// @brief Discards all points.
+		constexpr void reset() noexcept
+		{
+			moments_ = {};
+		}
+
+	private:
+		Stats::CoMoments<T> moments_{};
+	};
+
+	/// @brief Merges two accumulators into a new one.
+	template <typename T>
+	[[nodiscard]]
+	constexpr Accumulator<T> merge(Accumulator<T> a, const Accumulator<T>& b) noexcept
+	{
+		return a.merge(b);
+	}
+
+} // namespace LinearRegression
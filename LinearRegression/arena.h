@@ -0,0 +1,159 @@
+/**
+ * @file arena.h
+ * @brief Per-thread scratch arena for temporaries of the reductions
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * fit() needs two centered copies of its input. Allocating them with the
+ * global heap on every call makes concurrent callers contend on the
+ * allocator, so they are taken from a per-thread std::pmr arena instead:
+ *
+ * - ScratchArena: a monotonic buffer owned by one thread. It is reset, not
+ *   freed, between uses, and it keeps the buffer up to max_retained bytes.
+ * - ScratchScope: RAII guard that hands out the calling thread's arena and
+ *   resets it when the outermost scope on that thread ends.
+ *
+ * Allocations that do not fit the retained buffer go to the upstream heap
+ * and are freed at the end of the scope, so a single huge fit does not pin
+ * its memory to the thread.
+ *
+ * Example:
+ * @code
+ * Stats::ScratchScope scratch;
+ * auto x0 = Stats::shift(x, scratch.resource());   // std::pmr::vector in the arena
+ * @endcode
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "instrumentation.h"
+
+namespace Stats {
+
+	/**
+	 * @brief Reusable monotonic arena; not thread-safe, one instance per thread.
+	 */
+	class ScratchArena {
+	public:
+		/// Largest buffer kept between uses (bytes).
+		static constexpr std::size_t max_retained = std::size_t{ 1 } << 24;
+
+		ScratchArena() { rebuild(); }
+
+		ScratchArena(const ScratchArena&) = delete;
+		ScratchArena& operator=(const ScratchArena&) = delete;
+
+		/// @brief Memory resource allocating from the arena.
+		[[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &*arena_; }
+
+		/**
+		 * @brief Invalidates every allocation and makes the memory reusable.
+		 *
+		 * If the last use overflowed into the heap, the retained buffer grows
+		 * to the high-water mark (up to max_retained) so the next use of the
+		 * same size is served without touching the heap. If that allocation
+		 * fails, the current buffer is kept; reset() never throws, since it
+		 * runs in the ScratchScope destructor.
+		 */
+		void reset() noexcept
+		{
+			const auto wanted = std::min(buffer_.size() + upstream_.peak, max_retained);
+			arena_.reset();
+			if (wanted > buffer_.size()) {
+				try {
+					buffer_.resize(wanted);
+					LINREG_COUNT_ALLOCATION();
+				}
+				catch (...) {
+					// Keep the smaller buffer; the next use overflows to the heap again
+				}
+			}
+			upstream_.bytes = upstream_.peak = 0;
+			rebuild();
+		}
+
+		/// @brief Bytes currently retained between uses.
+		[[nodiscard]] std::size_t capacity() const noexcept { return buffer_.size(); }
+
+	private:
+		/// Heap fallback that records how much the arena overflowed.
+		struct CountingResource final : std::pmr::memory_resource {
+			std::size_t bytes = 0;
+			std::size_t peak = 0;
+
+			void* do_allocate(std::size_t n, std::size_t align) override
+			{
+				void* p = std::pmr::new_delete_resource()->allocate(n, align);
+				LINREG_COUNT_ALLOCATION();
+				bytes += n;
+				peak = std::max(peak, bytes);
+				return p;
+			}
+
+			void do_deallocate(void* p, std::size_t n, std::size_t align) override
+			{
+				std::pmr::new_delete_resource()->deallocate(p, n, align);
+				bytes -= n;
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+			{
+				return this == &other;
+			}
+		};
+
+		void rebuild()
+		{
+			arena_.emplace(buffer_.data(), buffer_.size(), &upstream_);
+		}
+
+		std::vector<std::byte> buffer_ = std::vector<std::byte>(std::size_t{ 1 } << 16);
+		CountingResource upstream_;
+		std::optional<std::pmr::monotonic_buffer_resource> arena_;
+	};
+
+	namespace detail {
+
+		struct ThreadScratch {
+			ScratchArena arena;
+			int depth = 0;
+		};
+
+		[[nodiscard]]
+		inline ThreadScratch& thread_scratch()
+		{
+			thread_local ThreadScratch scratch;
+			return scratch;
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Borrows the calling thread's ScratchArena for the lifetime of the scope.
+	 *
+	 * Scopes nest; the arena is reset when the outermost one ends, so all
+	 * memory obtained from resource() must be released before that.
+	 */
+	class ScratchScope {
+	public:
+		ScratchScope() : scratch_(detail::thread_scratch()) { ++scratch_.depth; }
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+
+		~ScratchScope()
+		{
+			if (--scratch_.depth == 0)
+				scratch_.arena.reset();
+		}
+
+		[[nodiscard]] std::pmr::memory_resource* resource() noexcept { return scratch_.arena.resource(); }
+
+	private:
+		detail::ThreadScratch& scratch_;
+	};
+
+} // namespace Stats
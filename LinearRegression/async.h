@@ -0,0 +1,323 @@
+/**
+ * @file async.h
+ * @brief Awaitable fit() that runs chunked on a caller-supplied executor
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * co_await async_fit(executor, x, y, stop) computes the same statistics as
+ * fit(), but instead of blocking the calling thread (and the whole
+ * std::execution::par pool) it posts the work to the executor in tasks of
+ * AsyncFitOptions::chunk points:
+ *
+ * - After each chunk a task posts its successor and returns, so requests
+ *   queued on the executor in the meantime run before the next chunk.
+ * - At most AsyncFitOptions::concurrency tasks of one fit are in flight;
+ *   the default of 1 keeps a large fit on one core at a time.
+ * - The stop token is polled before every chunk. A stopped fit skips its
+ *   remaining chunks and the co_await throws FitCancelled.
+ *
+ * The fit takes two passes: per-chunk co-moments (as Stats::co_moments()),
+ * merged in chunk order with a fixed pairwise tree, then the explicit SSE
+ * (as fit()). The result therefore depends only on the data and the chunk
+ * size, not on the executor or the concurrency. The awaiting coroutine is
+ * resumed on the executor thread that finishes the last chunk.
+ *
+ * An exception thrown while computing a chunk stops the fit like a
+ * cancellation and is rethrown by the co_await. The awaitable is move-only
+ * and can be awaited once.
+ *
+ * x and y must stay alive and unchanged until the co_await completes.
+ *
+ * Example:
+ * @code
+ * struct Loop { void post(std::function<void()> f); } loop;   // any executor
+ *
+ * Task handle(Request req, std::stop_token stop)
+ * {
+ *     auto r = co_await LinearRegression::async_fit(loop, req.x, req.y, stop);
+ *     co_return respond(r.beta0, r.beta1);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "execution.h"
+#include "linreg.h"
+#include "span_compatible.h"
+#include "stats.h"
+
+namespace Stats::exec {
+
+	/**
+	 * @brief Requirements for a caller-supplied executor.
+	 *
+	 * ex.post(f) must run f() later, on any thread; it must not run f
+	 * inline before returning.
+	 */
+	template <class E>
+	concept Executor = requires(E & ex, std::function<void()> f) {
+		ex.post(std::move(f));
+	};
+
+} // namespace Stats::exec
+
+namespace LinearRegression {
+
+	/// @brief Thrown by co_await async_fit(...) if the stop token was triggered.
+	class FitCancelled : public std::runtime_error {
+	public:
+		FitCancelled() : std::runtime_error("async_fit: cancelled") {}
+	};
+
+	/// Default points per task of async_fit().
+	inline constexpr std::size_t default_async_chunk = std::size_t{ 1 } << 20;
+
+	/// @brief Scheduling of async_fit().
+	struct AsyncFitOptions {
+		std::size_t chunk = default_async_chunk;  ///< Points per task; bounds the time between yields
+		std::size_t concurrency = 1;              ///< Tasks of one fit in flight at a time
+	};
+
+	namespace detail {
+
+		/**
+		 * @brief Shared state of one async_fit(), owned by its posted tasks and the awaitable.
+		 *
+		 * Pass p (0: co-moments, 1: SSE) hands out chunks through next_[p];
+		 * the task that completes the last chunk (done_[p]) merges the
+		 * chunk results in order and starts the next pass or resumes the
+		 * awaiting coroutine.
+		 */
+		template <class T, class Acc, Stats::exec::Executor Executor>
+		class AsyncFitState : public std::enable_shared_from_this<AsyncFitState<T, Acc, Executor>> {
+		public:
+			AsyncFitState(Executor& executor, std::span<const T> x, std::span<const T> y,
+				std::stop_token stop, const AsyncFitOptions& options)
+				: executor_(&executor), x_(x), y_(y), stop_(std::move(stop)),
+				chunk_(std::max<std::size_t>(options.chunk, 1)),
+				chunks_((x.size() + chunk_ - 1) / chunk_),
+				concurrency_(std::clamp<std::size_t>(options.concurrency, 1, chunks_)),
+				moments_(chunks_), sse_(chunks_)
+			{
+			}
+
+			void start(std::coroutine_handle<> continuation)
+			{
+				continuation_ = continuation;
+				spawn(0);
+			}
+
+			[[nodiscard]] bool cancelled() const noexcept { return cancelled_.load(); }
+			/// Exception thrown by a chunk, or null.
+			[[nodiscard]] std::exception_ptr error() const noexcept { return failed_.load() ? error_ : nullptr; }
+			[[nodiscard]] const FitResult<Acc>& result() const noexcept { return result_; }
+
+		private:
+			void spawn(int pass)
+			{
+				// The first task may finish the fit and release the awaitable before the loop ends
+				const auto self = this->shared_from_this();
+				for (std::size_t i = 0; i < concurrency_; ++i)
+					post(pass);
+			}
+
+			void post(int pass)
+			{
+				executor_->post([self = this->shared_from_this(), pass] { self->step(pass); });
+			}
+
+			void step(int pass)
+			{
+				const auto c = next_[pass].fetch_add(1);
+				if (c >= chunks_)
+					return;
+
+				if (stop_.stop_requested())
+					cancelled_.store(true);
+				else if (!cancelled() && !failed_.load()) {
+					try {
+						run_chunk(pass, c);
+					}
+					catch (...) {
+						fail(std::current_exception());
+					}
+				}
+
+				if (done_[pass].fetch_add(1) + 1 == chunks_) {
+					finish_pass(pass);
+					return;
+				}
+				// Yield: whatever was queued meanwhile runs before the next chunk
+				if (next_[pass].load() < chunks_)
+					post(pass);
+			}
+
+			void run_chunk(int pass, std::size_t c)
+			{
+				const auto begin = c * chunk_;
+				const auto len = std::min(chunk_, x_.size() - begin);
+				const auto xs = x_.subspan(begin, len);
+				const auto ys = y_.subspan(begin, len);
+				if (pass == 0)
+					moments_[c] = Stats::co_moments<T, Acc>(xs, ys, Stats::exec::seq);
+				else
+					sse_[c] = residual_sum_of_squares(result_, xs, ys, Stats::exec::seq);
+			}
+
+			/// Keeps the first exception; the remaining chunks are skipped.
+			void fail(std::exception_ptr e) noexcept
+			{
+				if (!failed_.exchange(true))
+					error_ = std::move(e);
+			}
+
+			void finish_pass(int pass)
+			{
+				if (pass == 0) {
+					if (stop_.stop_requested())
+						cancelled_.store(true);
+					if (!cancelled() && !failed_.load()) {
+						result_ = fit_from_moments(Stats::detail::tree_reduce(moments_,
+							[](Stats::CoMoments<Acc> a, const Stats::CoMoments<Acc>& b) {
+								a.merge(b);
+								return a;
+							}));
+						if (result_.n != 0) {
+							spawn(1);
+							return;
+						}
+					}
+				}
+				else if (!failed_.load()) {
+					result_.sse = Stats::detail::tree_reduce(sse_, std::plus<>{});
+				}
+				continuation_.resume();
+			}
+
+			Executor* executor_;
+			std::span<const T> x_, y_;
+			std::stop_token stop_;
+			std::size_t chunk_, chunks_, concurrency_;
+			std::vector<Stats::CoMoments<Acc>> moments_;
+			std::vector<Acc> sse_;
+			std::atomic<std::size_t> next_[2]{}, done_[2]{};
+			std::atomic<bool> cancelled_{ false }, failed_{ false };
+			std::exception_ptr error_;
+			FitResult<Acc> result_{};
+			std::coroutine_handle<> continuation_;
+		};
+
+	} // namespace detail
+
+	/**
+	 * @brief Awaitable returned by async_fit(); co_await yields the FitResult.
+	 *
+	 * The work starts when the awaitable is co_awaited, not when it is created.
+	 * Move-only and single-use: a second co_await, or one on a moved-from
+	 * awaitable, throws std::logic_error.
+	 */
+	template <class T, class Acc, Stats::exec::Executor Executor>
+	class [[nodiscard]] AsyncFit {
+	public:
+		using State = detail::AsyncFitState<T, Acc, Executor>;
+
+		explicit AsyncFit(std::shared_ptr<State> state, bool stopped = false) noexcept
+			: state_(std::move(state)), stopped_(stopped)
+		{
+		}
+
+		AsyncFit(AsyncFit&& other) noexcept
+			: state_(std::move(other.state_)), stopped_(other.stopped_), awaited_(std::exchange(other.awaited_, true))
+		{
+		}
+
+		AsyncFit& operator=(AsyncFit&&) = delete;
+		AsyncFit(const AsyncFit&) = delete;
+		AsyncFit& operator=(const AsyncFit&) = delete;
+
+		/**
+		 * @brief Ready without suspending if there is nothing to compute (invalid input, stop already requested).
+		 * @throws std::logic_error if this awaitable was already awaited or moved from
+		 */
+		[[nodiscard]] bool await_ready()
+		{
+			if (std::exchange(awaited_, true))
+				throw std::logic_error("async_fit: awaitable used more than once");
+			return state_ == nullptr;
+		}
+
+		void await_suspend(std::coroutine_handle<> continuation)
+		{
+			// Keep the state alive locally: the coroutine may resume (and destroy *this) before start() returns
+			const auto state = state_;
+			state->start(continuation);
+		}
+
+		/// @throws the exception of a failed chunk, or FitCancelled if the stop token was triggered before the fit completed
+		[[nodiscard]] FitResult<Acc> await_resume() const
+		{
+			if (state_ != nullptr && state_->error())
+				std::rethrow_exception(state_->error());
+			if (stopped_ || (state_ != nullptr && state_->cancelled()))
+				throw FitCancelled();
+			return state_ != nullptr ? state_->result() : FitResult<Acc>{};
+		}
+
+	private:
+		std::shared_ptr<State> state_;
+		bool stopped_;
+		bool awaited_ = false;
+	};
+
+	/**
+	 * @brief Awaitable fit() running chunked on an executor, with cooperative cancellation
+	 * @tparam T Numeric type of the data
+	 * @tparam Acc Accumulator type of the reductions and of the result (default: T)
+	 * @param executor Executor satisfying Stats::exec::Executor; must outlive the fit
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @param stop Cancellation; polled before every chunk
+	 * @param options Chunk size and number of tasks in flight
+	 * @return Awaitable whose co_await yields FitResult<Acc>
+	 *
+	 * @note co_await yields an empty FitResult under the same conditions as
+	 *       fit(), throws FitCancelled if stop was requested before the fit
+	 *       completed, and rethrows an exception thrown by a chunk.
+	 */
+	template <typename T, typename Acc = T, Stats::exec::Executor Executor>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	AsyncFit<T, Acc, Executor> async_fit(Executor& executor, std::span<const T> x, std::span<const T> y,
+		std::stop_token stop = {}, const AsyncFitOptions& options = {})
+	{
+		using Result = AsyncFit<T, Acc, Executor>;
+		if (stop.stop_requested())
+			return Result(nullptr, true);
+		if (x.size() != y.size() || x.size() < 3)
+			return Result(nullptr);
+		return Result(std::make_shared<typename Result::State>(executor, x, y, std::move(stop), options));
+	}
+
+	/// @brief Container overload for async_fit function
+	template <Stats::exec::Executor Executor, Helper::SpanCompatible C>
+	auto async_fit(Executor& executor, const C& x, const C& y, std::stop_token stop = {},
+		const AsyncFitOptions& options = {})
+	{
+		return async_fit(executor, Helper::as_span(x), Helper::as_span(y), std::move(stop), options);
+	}
+
+} // namespace LinearRegression
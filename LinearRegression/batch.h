@@ -0,0 +1,126 @@
+/**
+ * @file batch.h
+ * @brief Batched linear regression over many independent series
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Fits K series in one call from a structure-of-arrays layout:
+ * - one x buffer and one y buffer holding all series back to back, with an
+ *   offsets array (series k occupies [offsets[k], offsets[k+1]))
+ * - a row-major K × L matrix of equal-length series
+ *
+ * Each series is reduced with the allocation-free kernel of
+ * Stats::co_moments(), and the batch is dispatched to the parallel backend
+ * once instead of once per series. The execution policy applies to the
+ * batch as a whole (its total number of points).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "execution.h"
+#include "stats.h"
+#include "linreg.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Fits every series of a concatenated buffer
+	 * @tparam T Floating-point type
+	 * @param x All x values, series stored back to back
+	 * @param y All y values, same layout as x
+	 * @param offsets K+1 non-decreasing start indices; offsets[K] == x.size()
+	 * @param out Receives K results (series k → out[k])
+	 * @throws std::invalid_argument if the buffer sizes or offsets are inconsistent
+	 *
+	 * A series that cannot be fitted (fewer than 3 points, Sxx = 0) yields an
+	 * empty FitResult, exactly as fit() does.
+	 *
+	 * Example:
+	 * @code
+	 * std::vector<std::size_t> offsets = {0, 30, 75, 120};   // 3 series
+	 * std::vector<LinearRegression::FitResult<double>> out(3);
+	 * LinearRegression::fit_batch<double>(x, y, offsets, out);
+	 * @endcode
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	void fit_batch(std::span<const T> x, std::span<const T> y,
+		std::span<const std::size_t> offsets, std::span<FitResult<T>> out, const Policy& policy = {})
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("fit_batch: x and y must have same size");
+		if (offsets.size() != out.size() + 1 || offsets.back() != x.size())
+			throw std::invalid_argument("fit_batch: offsets must hold K+1 entries ending at x.size()");
+		if (!std::is_sorted(offsets.begin(), offsets.end()))
+			throw std::invalid_argument("fit_batch: offsets must be non-decreasing");
+
+		// One parallel dispatch for the whole batch; each series runs sequentially
+		Stats::detail::bulk(policy, x.size(), out.size(),
+			[x, y, offsets, out](std::size_t k) {
+				const auto begin = offsets[k];
+				const auto len = offsets[k + 1] - begin;
+				out[k] = fit_from_moments(Stats::co_moments(
+					x.subspan(begin, len), y.subspan(begin, len), Stats::exec::seq));
+			});
+	}
+
+	/// @brief fit_batch() returning a new vector of K results.
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::vector<FitResult<T>> fit_batch(std::span<const T> x, std::span<const T> y,
+		std::span<const std::size_t> offsets, const Policy& policy = {})
+	{
+		if (offsets.empty())
+			throw std::invalid_argument("fit_batch: offsets must hold K+1 entries ending at x.size()");
+		std::vector<FitResult<T>> out(offsets.size() - 1);
+		fit_batch(x, y, offsets, std::span<FitResult<T>>(out), policy);
+		return out;
+	}
+
+	/**
+	 * @brief Fits every row of a row-major matrix of equal-length series
+	 * @tparam T Floating-point type
+	 * @param x K × length matrix of x values (row k = series k)
+	 * @param y K × length matrix of y values
+	 * @param length Number of points per series
+	 * @param out Receives K = x.size() / length results
+	 * @throws std::invalid_argument if the sizes are inconsistent
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	void fit_batch(std::span<const T> x, std::span<const T> y,
+		std::size_t length, std::span<FitResult<T>> out, const Policy& policy = {})
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("fit_batch: x and y must have same size");
+		if (length == 0 || x.size() != out.size() * length)
+			throw std::invalid_argument("fit_batch: matrix size must equal K * length");
+
+		Stats::detail::bulk(policy, x.size(), out.size(),
+			[x, y, length, out](std::size_t k) {
+				const auto begin = k * length;
+				out[k] = fit_from_moments(Stats::co_moments(
+					x.subspan(begin, length), y.subspan(begin, length), Stats::exec::seq));
+			});
+	}
+
+	/// @brief Row-major fit_batch() returning a new vector of K results.
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::vector<FitResult<T>> fit_batch(std::span<const T> x, std::span<const T> y, std::size_t length,
+		const Policy& policy = {})
+	{
+		if (length == 0)
+			throw std::invalid_argument("fit_batch: matrix size must equal K * length");
+		std::vector<FitResult<T>> out(x.size() / length);
+		fit_batch(x, y, length, std::span<FitResult<T>>(out), policy);
+		return out;
+	}
+
+} // namespace LinearRegression
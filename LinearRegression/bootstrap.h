@@ -0,0 +1,316 @@
+/**
+ * @file bootstrap.h
+ * @brief Bootstrap confidence intervals for the regression line
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * ci_slope() relies on normally distributed residuals. The bootstrap instead
+ * refits the line on B resamples of the data and reads the interval off the
+ * distribution of the refitted coefficients (percentile method).
+ *
+ * Resampling schemes (BootstrapMethod):
+ * - pairs:         draw n of the (xᵢ, yᵢ) pairs with replacement. Valid for
+ *                  heteroscedastic errors and random x.
+ * - pairs_poisson: as pairs, but every point is drawn Poisson(1) times
+ *                  independently, so the resample size is n only on average.
+ *                  Converges to the same distribution for large n and needs
+ *                  no per-resample buffer.
+ * - residuals:     keep x, set y*ᵢ = ŷᵢ + e*ᵢ with e* drawn from the residuals
+ *                  (scaled by √(n / (n - 2))). Assumes homoscedastic errors.
+ *
+ * No resampled copies of x and y are built. A pairs resample is a vector of
+ * draw counts cᵢ, and the refit is the weighted fit with wᵢ = cᵢ computed by
+ * the weighted moment kernel of Stats::weighted_co_moments(). For
+ * pairs_poisson the counts of each L1 block are generated right before the
+ * block is reduced. The residual refit reduces to two sums,
+ * β₁* = β₁ + Σ(xᵢ - x̄)e*ᵢ / Sxx and ȳ* = ȳ + Σe*ᵢ / n.
+ *
+ * Resamples run in parallel (one task per resample). Resample b draws from
+ * its own counter-based stream Stats::CounterRng(seed, b), so the result
+ * depends only on the data and the seed, not on the thread count.
+ *
+ * Example:
+ * @code
+ * LinearRegression::BootstrapOptions opt;
+ * opt.resamples = 10'000;
+ * auto boot = LinearRegression::bootstrap(x, y, opt);
+ * auto [lo, hi] = LinearRegression::ci_slope(boot, 0.05);
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "arena.h"
+#include "execution.h"
+#include "linreg.h"
+#include "random.h"
+#include "span_compatible.h"
+#include "stats.h"
+#include "weighted.h"
+
+namespace LinearRegression {
+
+	/// @brief Resampling scheme of bootstrap().
+	enum class BootstrapMethod {
+		pairs,          ///< n pairs drawn with replacement
+		pairs_poisson,  ///< Every pair drawn Poisson(1) times
+		residuals       ///< Residuals drawn with replacement, x fixed
+	};
+
+	/// @brief Options of bootstrap().
+	struct BootstrapOptions {
+		std::size_t resamples = 2000;                ///< Number of resamples B
+		BootstrapMethod method = BootstrapMethod::pairs;
+		std::uint64_t seed = 0x2545F4914F6CDD1DULL;  ///< Seed of the resampling streams
+	};
+
+	/**
+	 * @brief Refitted coefficients of every resample
+	 *
+	 * beta0[b] and beta1[b] belong to resample b. A resample that cannot be
+	 * fitted (fewer than 3 distinct points drawn, Sxx = 0) holds NaN.
+	 */
+	template <typename T>
+	struct BootstrapResult {
+		FitResult<T> fit;         ///< Fit of the original data
+		std::vector<T> beta0;     ///< Intercept of each resample
+		std::vector<T> beta1;     ///< Slope of each resample
+	};
+
+	namespace detail {
+
+		/// P(K <= k) of K ~ Poisson(1); beyond the table the tail is below 1e-17.
+		inline constexpr std::array<double, 19> poisson1_cdf = [] {
+			std::array<double, 19> cdf{};
+			double term = 0.36787944117144233;  // e⁻¹
+			double sum = 0;
+			for (std::size_t k = 0; k < cdf.size(); ++k) {
+				sum += term;
+				cdf[k] = sum;
+				term /= static_cast<double>(k + 1);
+			}
+			return cdf;
+		}();
+
+		/// Poisson(1) variate from 64 random bits (inverse CDF).
+		[[nodiscard]]
+		inline unsigned poisson1(std::uint64_t r) noexcept
+		{
+			const double u = Stats::detail::uniform01(r);
+			// Branch-free for k < 6 (probability 0.9994); the table walk covers the tail
+			unsigned k = 0;
+			for (std::size_t j = 0; j < 6; ++j)
+				k += u >= poisson1_cdf[j];
+			while (k < poisson1_cdf.size() && u >= poisson1_cdf[k])
+				++k;
+			return k;
+		}
+
+		/// Coefficients of a weighted refit; NaN if the resample is degenerate.
+		template <typename T>
+		[[nodiscard]]
+		std::pair<T, T> refit(const Stats::WeightedCoMoments<T>& m) noexcept
+		{
+			const auto r = fit_from_moments(m);
+			if (r.n == 0)
+				return { std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN() };
+			return { r.beta0, r.beta1 };
+		}
+
+		/// Multinomial pairs resample: draw counts into scratch, one weighted pass.
+		template <typename T, typename Acc>
+		[[nodiscard]]
+		std::pair<Acc, Acc> resample_pairs(std::span<const T> x, std::span<const T> y, const Stats::CounterRng& rng)
+		{
+			const auto n = x.size();
+			Stats::ScratchScope scratch;
+			std::pmr::vector<T> counts(n, T{ 0 }, scratch.resource());
+			for (std::size_t k = 0; k < n; ++k)
+				counts[Stats::detail::uniform_index(rng(k), n)] += T{ 1 };
+			const auto m = Stats::detail::weighted_reduce<T, Acc>(x, y, std::span<const T>(counts), Stats::exec::seq);
+			return refit(m.m);
+		}
+
+		/// Poisson pairs resample: counts of each block are drawn in L1, never stored.
+		template <typename T, typename Acc>
+		[[nodiscard]]
+		std::pair<Acc, Acc> resample_poisson(std::span<const T> x, std::span<const T> y, const Stats::CounterRng& rng)
+		{
+			constexpr auto block = Stats::detail::co_moment_block;
+			std::array<T, block> counts;
+			Stats::WeightedCoMoments<Acc> m{};
+			for (std::size_t i = 0; i < x.size(); i += block) {
+				const auto len = std::min(block, x.size() - i);
+				for (std::size_t k = 0; k < len; ++k)
+					counts[k] = static_cast<T>(poisson1(rng(i + k)));
+				m.merge(Stats::detail::block_weighted_co_moments<T, Acc>(counts.data(), x.data() + i, y.data() + i, len).m);
+			}
+			return refit(m);
+		}
+
+		/// Residual resample: β₁* and β₀* from two sums over the drawn residuals.
+		template <typename T, typename Acc>
+		[[nodiscard]]
+		std::pair<Acc, Acc> resample_residuals(std::span<const T> x, std::span<const Acc> residuals,
+			const FitResult<Acc>& base, const Stats::CounterRng& rng) noexcept
+		{
+			const auto n = x.size();
+			Acc se{}, sxe{};
+			for (std::size_t i = 0; i < n; ++i) {
+				const Acc e = residuals[Stats::detail::uniform_index(rng(i), n)];
+				se += e;
+				sxe += (static_cast<Acc>(x[i]) - base.mean_x) * e;
+			}
+			const Acc b1 = base.beta1 + sxe / base.sxx;
+			const Acc b0 = base.mean_y + se / static_cast<Acc>(n) - b1 * base.mean_x;
+			return { b0, b1 };
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Refits the line on bootstrap resamples of the data
+	 * @tparam T Numeric type of the data
+	 * @tparam Acc Accumulator type of the refits and of the result (default: T)
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @param options Number of resamples, scheme and seed
+	 * @param policy Execution policy; resamples are the parallel tasks
+	 *        (default: Stats::exec::automatic)
+	 * @return Coefficients of every resample; empty vectors if the data
+	 *         cannot be fitted (see fit())
+	 *
+	 * Cost per resample: one pass over x and y plus n random numbers. pairs
+	 * additionally keeps n counts of type T in the per-thread scratch arena
+	 * and scatters into them; pairs_poisson and residuals do not.
+	 */
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	BootstrapResult<Acc> bootstrap(std::span<const T> x, std::span<const T> y,
+		const BootstrapOptions& options = {}, const Policy& policy = {})
+	{
+		BootstrapResult<Acc> result;
+		result.fit = fit<T, Acc>(x, y, policy);
+		if (result.fit.n == 0)
+			return result;
+
+		const auto n = x.size();
+		const auto resamples = options.resamples;
+		result.beta0.resize(resamples);
+		result.beta1.resize(resamples);
+
+		// Residuals of the original fit, inflated by √(n / (n - 2)) to undo
+		// the shrinkage of fitted residuals
+		std::vector<Acc> residuals;
+		if (options.method == BootstrapMethod::residuals) {
+			residuals.resize(n);
+			const auto scale = std::sqrt(static_cast<Acc>(n) / static_cast<Acc>(n - 2));
+			const auto& f = result.fit;
+			Stats::detail::bulk(policy, n, (n + Stats::detail::par_chunk - 1) / Stats::detail::par_chunk,
+				[&](std::size_t c) {
+					const auto begin = c * Stats::detail::par_chunk;
+					const auto end = std::min(begin + Stats::detail::par_chunk, n);
+					for (auto i = begin; i < end; ++i)
+						residuals[i] = scale * (static_cast<Acc>(y[i]) - (f.beta0 + f.beta1 * static_cast<Acc>(x[i])));
+				});
+		}
+
+		Stats::detail::bulk(policy, n * resamples, resamples, [&](std::size_t b) {
+			const Stats::CounterRng rng(options.seed, b);
+			std::pair<Acc, Acc> coefficients;
+			switch (options.method) {
+			case BootstrapMethod::pairs_poisson:
+				coefficients = detail::resample_poisson<T, Acc>(x, y, rng);
+				break;
+			case BootstrapMethod::residuals:
+				coefficients = detail::resample_residuals<T, Acc>(x, std::span<const Acc>(residuals), result.fit, rng);
+				break;
+			default:
+				coefficients = detail::resample_pairs<T, Acc>(x, y, rng);
+				break;
+			}
+			result.beta0[b] = coefficients.first;
+			result.beta1[b] = coefficients.second;
+		});
+		return result;
+	}
+
+	/// @brief Container overload for bootstrap function
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	BootstrapResult<typename C::value_type> bootstrap(const C& x, const C& y,
+		const BootstrapOptions& options = {}, const Policy& policy = {})
+	{
+		return bootstrap(Helper::as_span(x), Helper::as_span(y), options, policy);
+	}
+
+	/**
+	 * @brief Percentile interval of bootstrap replicates
+	 * @param samples Replicates in any order; NaN entries are ignored
+	 * @param alpha Significance level (e.g., 0.05 for a 95% interval)
+	 * @return The α/2 and 1 - α/2 quantiles (linear interpolation)
+	 * @throws std::invalid_argument if no replicate is finite
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::pair<T, T> percentile_interval(std::span<const T> samples, const T alpha)
+	{
+		std::vector<T> sorted;
+		sorted.reserve(samples.size());
+		std::copy_if(samples.begin(), samples.end(), std::back_inserter(sorted), [](T v) { return !std::isnan(v); });
+		if (sorted.empty())
+			throw std::invalid_argument("percentile_interval: no valid bootstrap replicate");
+
+		auto quantile = [&](T p) {
+			const auto h = p * static_cast<T>(sorted.size() - 1);
+			const auto lo = static_cast<std::size_t>(std::floor(h));
+			const auto hi = std::min(lo + 1, sorted.size() - 1);
+			std::nth_element(sorted.begin(), sorted.begin() + lo, sorted.end());
+			const T a = sorted[lo];
+			const T b = hi == lo ? a : *std::min_element(sorted.begin() + lo + 1, sorted.end());
+			return a + (h - static_cast<T>(lo)) * (b - a);
+		};
+		const T lower = quantile(T{ 0.5 } * alpha);
+		const T upper = quantile(T{ 1 } - T{ 0.5 } * alpha);
+		return { lower, upper };
+	}
+
+	/**
+	 * @brief Bootstrap percentile confidence interval for the slope
+	 * @param boot Result of bootstrap()
+	 * @param alpha Significance level (e.g., 0.05 for 95% confidence)
+	 * @return Pair of (lower bound, upper bound) for the slope
+	 * @throws std::invalid_argument if no resample could be fitted
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::pair<T, T> ci_slope(const BootstrapResult<T>& boot, const T alpha)
+	{
+		return percentile_interval(std::span<const T>(boot.beta1), alpha);
+	}
+
+	/// @brief Bootstrap percentile confidence interval for the intercept (see ci_slope()).
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::pair<T, T> ci_intercept(const BootstrapResult<T>& boot, const T alpha)
+	{
+		return percentile_interval(std::span<const T>(boot.beta0), alpha);
+	}
+
+} // namespace LinearRegression
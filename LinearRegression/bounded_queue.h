@@ -0,0 +1,135 @@
+/**
+ * @file bounded_queue.h
+ * @brief Bounded lock-free queue for one producer thread
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * A ring of slots with per-slot sequence numbers (after D. Vyukov's bounded
+ * queue). Exactly one thread pushes; dequeuing is lock-free for several
+ * threads, which lets the producer itself discard the oldest element when the
+ * ring is full (drop-oldest backpressure) while a consumer keeps popping.
+ *
+ * try_push()/try_pop() never block. wait_for_space() and wait_for_data()
+ * park the calling thread with std::atomic::wait until the other side moves.
+ */
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Helper {
+
+	template <class T>
+	class BoundedQueue {
+	public:
+		/// @param capacity Number of slots, rounded up to a power of two (at least 2).
+		explicit BoundedQueue(std::size_t capacity)
+			: mask_(std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity) - 1),
+			slots_(std::make_unique<Slot[]>(mask_ + 1))
+		{
+			for (std::size_t i = 0; i <= mask_; ++i)
+				slots_[i].seq.store(i, std::memory_order_relaxed);
+		}
+
+		BoundedQueue(const BoundedQueue&) = delete;
+		BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+		[[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+		/**
+		 * @brief Appends v unless the ring is full (producer thread only).
+		 * @param tag Producer-side marker of the element, see try_discard_front().
+		 * @return false if the ring is full; v is left untouched then.
+		 */
+		bool try_push(T& v, bool tag = false)
+		{
+			const auto pos = tail_.load(std::memory_order_relaxed);
+			Slot& s = slots_[pos & mask_];
+			if (s.seq.load(std::memory_order_acquire) != pos)
+				return false;
+			s.value = std::move(v);
+			s.tag = tag;
+			s.seq.store(pos + 1, std::memory_order_release);
+			tail_.store(pos + 1, std::memory_order_release);
+			tail_.notify_one();
+			return true;
+		}
+
+		/// @brief Removes the oldest element into out; false if the queue is empty.
+		bool try_pop(T& out)
+		{
+			return pop_front(out, false);
+		}
+
+		/**
+		 * @brief Drops the oldest element if it was pushed with tag = true (producer thread only).
+		 * @return true if an element was dropped; false if the queue is empty, the
+		 *         oldest element is untagged, or a consumer dequeued it first.
+		 */
+		bool try_discard_front()
+		{
+			T dropped;
+			return pop_front(dropped, true);
+		}
+
+		/// @brief Blocks until a consumer has dequeued since `observed` (see dequeued()).
+		void wait_for_space(std::size_t observed) const noexcept { head_.wait(observed, std::memory_order_acquire); }
+
+		/// @brief Blocks until the producer has pushed since `observed` (see pushed()).
+		void wait_for_data(std::size_t observed) const noexcept { tail_.wait(observed, std::memory_order_acquire); }
+
+		/// @brief Total number of elements ever dequeued.
+		[[nodiscard]] std::size_t dequeued() const noexcept { return head_.load(std::memory_order_acquire); }
+
+		/// @brief Total number of elements ever pushed.
+		[[nodiscard]] std::size_t pushed() const noexcept { return tail_.load(std::memory_order_acquire); }
+
+	private:
+		struct Slot {
+			std::atomic<std::size_t> seq{ 0 };
+			T value{};
+			bool tag = false;  // written and read by the producer only
+		};
+
+		bool pop_front(T& out, bool only_tagged)
+		{
+			auto pos = head_.load(std::memory_order_relaxed);
+			for (;;) {
+				Slot& s = slots_[pos & mask_];
+				const auto seq = s.seq.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+				if (diff < 0)
+					return false;  // empty
+				if (diff > 0) {
+					// Another thread took this slot
+					if (only_tagged)
+						return false;
+					pos = head_.load(std::memory_order_relaxed);
+					continue;
+				}
+				if (only_tagged && !s.tag)
+					return false;
+				if (head_.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+					out = std::move(s.value);
+					s.seq.store(pos + mask_ + 1, std::memory_order_release);
+					head_.notify_all();
+					return true;
+				}
+				if (only_tagged)
+					return false;  // lost the race to a consumer
+			}
+		}
+
+		// Producer and consumer counters on separate cache lines (64 bytes on
+		// current x86-64 and AArch64 cores)
+		static constexpr std::size_t cache_line = 64;
+
+		const std::size_t mask_;
+		std::unique_ptr<Slot[]> slots_;
+		alignas(cache_line) std::atomic<std::size_t> head_{ 0 };
+		alignas(cache_line) std::atomic<std::size_t> tail_{ 0 };
+	};
+
+} // namespace Helper
@@ -0,0 +1,335 @@
+/**
+ * @file csv_parser.h
+ * @brief Numeric CSV / whitespace-separated text parser for regression input
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Parses selected columns of numeric text into structure-of-arrays buffers:
+ * - std::from_chars for the conversion (locale independent, no allocation)
+ * - delimiter-separated fields or runs of blanks (CsvOptions::whitespace)
+ * - blank lines and comment lines are skipped, malformed rows are skipped
+ *   and counted (or reported as an error, see MalformedRows)
+ * - large inputs are split at line boundaries into chunks that are parsed in
+ *   parallel according to the execution policy
+ *
+ * parse_columns() writes into caller-provided spans, so the output can live
+ * in any buffer or arena; parse_text() / parse_file() allocate vectors.
+ *
+ * Example:
+ * @code
+ * std::vector<std::size_t> columns = {0, 2};               // x = field 0, y = field 2
+ * auto data = LinearRegression::parse_file<double>("sensor.csv", columns);
+ * auto r = LinearRegression::fit(data.columns[0], data.columns[1]);
+ * std::cout << data.stats.malformed << " rows skipped\n";
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "execution.h"
+#include "mapped_file.h"
+
+namespace LinearRegression {
+
+	/// @brief Handling of rows with a missing or non-numeric selected field.
+	enum class MalformedRows {
+		skip,  ///< Drop the row and count it in ParseStats::malformed
+		fail   ///< Throw std::runtime_error naming the first malformed line
+	};
+
+	/// @brief Text format options.
+	struct CsvOptions {
+		char delimiter = ',';       ///< Field separator (ignored if whitespace)
+		bool whitespace = false;    ///< Fields are separated by runs of blanks and tabs
+		bool skip_header = true;    ///< The first line holds column names
+		char comment = '#';         ///< Lines starting with this character are skipped ('\0': none)
+		MalformedRows malformed = MalformedRows::skip;
+	};
+
+	/// @brief Outcome of a parse.
+	struct ParseStats {
+		std::size_t rows = 0;                  ///< Rows written to the output
+		std::size_t malformed = 0;             ///< Rows dropped as malformed
+		std::size_t skipped = 0;               ///< Blank and comment lines
+		std::size_t first_malformed_line = 0;  ///< 1-based line number, 0 if none
+	};
+
+	namespace detail {
+
+		/// Bytes per parallel parse task; boundaries are moved to the next line end.
+		inline constexpr std::size_t parse_chunk_bytes = std::size_t{ 1 } << 20;
+
+		[[nodiscard]]
+		constexpr bool is_blank(char c) noexcept
+		{
+			return c == ' ' || c == '\t';
+		}
+
+		/// @brief Parses one numeric field; surrounding blanks and a leading '+' are accepted.
+		template <typename T>
+		[[nodiscard]]
+		bool parse_value(const char* b, const char* e, T& value) noexcept
+		{
+			while (b < e && is_blank(*b))
+				++b;
+			while (e > b && is_blank(e[-1]))
+				--e;
+			if (e - b > 1 && *b == '+' && b[1] != '-')
+				++b;
+			const auto [ptr, ec] = std::from_chars(b, e, value);
+			return ec == std::errc{} && ptr == e && b != e;
+		}
+
+		/**
+		 * @brief Extracts the fields `columns` of one line [b, e)
+		 * @param values Receives values[k] = field columns[k]
+		 * @return false if a field is missing or not a number
+		 */
+		template <typename T>
+		[[nodiscard]]
+		bool parse_fields(const char* b, const char* e, std::span<const std::size_t> columns,
+			const CsvOptions& options, std::span<T> values) noexcept
+		{
+			std::size_t found = 0;
+			std::size_t field = 0;
+			const char* f = b;
+			if (options.whitespace) {
+				while (f < e && is_blank(*f))
+					++f;
+			}
+			while (found < columns.size() && f <= e) {
+				const char* fe = options.whitespace
+					? std::find_if(f, e, is_blank)
+					: std::find(f, e, options.delimiter);
+				for (std::size_t k = 0; k < columns.size(); ++k) {
+					if (columns[k] != field)
+						continue;
+					if (!parse_value(f, fe, values[k]))
+						return false;
+					++found;
+				}
+				if (fe == e)
+					break;
+				f = fe + 1;
+				if (options.whitespace) {
+					while (f < e && is_blank(*f))
+						++f;
+					if (f == e)
+						break;
+				}
+				++field;
+			}
+			return found == columns.size();
+		}
+
+		/// @brief Line kinds that are not data.
+		[[nodiscard]]
+		inline bool is_ignorable(const char* b, const char* e, const CsvOptions& options) noexcept
+		{
+			while (b < e && is_blank(*b))
+				++b;
+			return b == e || (options.comment != '\0' && *b == options.comment);
+		}
+
+		/// @brief [b, e) without a trailing '\r'.
+		[[nodiscard]]
+		inline const char* line_stop(const char* b, const char* eol) noexcept
+		{
+			return (eol > b && eol[-1] == '\r') ? eol - 1 : eol;
+		}
+
+		/// @brief Text after the header line (if any) and the number of header lines.
+		[[nodiscard]]
+		inline std::pair<std::string_view, std::size_t> body_of(std::string_view text, const CsvOptions& options) noexcept
+		{
+			if (!options.skip_header || text.empty())
+				return { text, 0 };
+			const auto eol = text.find('\n');
+			return { eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1), 1 };
+		}
+
+		/// @brief Number of lines in [b, e), counting an unterminated last line.
+		[[nodiscard]]
+		inline std::size_t count_lines(const char* b, const char* e) noexcept
+		{
+			const auto n = static_cast<std::size_t>(std::count(b, e, '\n'));
+			return n + (e > b && e[-1] != '\n');
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Upper bound for the number of rows parse_columns() writes
+	 *
+	 * Counts the lines after the header; use it to size the output buffers.
+	 */
+	[[nodiscard]]
+	inline std::size_t max_rows(std::string_view text, const CsvOptions& options = {}) noexcept
+	{
+		const auto body = detail::body_of(text, options).first;
+		return detail::count_lines(body.data(), body.data() + body.size());
+	}
+
+	/**
+	 * @brief Parses selected columns of numeric text into preallocated buffers
+	 * @tparam T Floating-point type
+	 * @param text Complete input text
+	 * @param columns Zero-based field indices; output k receives field columns[k]
+	 * @param out One buffer per column, each with at least max_rows(text) elements
+	 * @param options Format options
+	 * @param policy Execution policy; the parallel decision uses the text size
+	 * @return ParseStats; rows are stored in out[k][0 .. stats.rows) in input order
+	 * @throws std::invalid_argument if out does not match columns or is too small
+	 * @throws std::runtime_error on a malformed row if options.malformed == MalformedRows::fail
+	 *
+	 * Every chunk writes its rows directly into the region of out reserved by
+	 * its line count; gaps left by skipped lines are closed afterwards.
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	ParseStats parse_columns(std::string_view text, std::span<const std::size_t> columns,
+		std::span<const std::span<T>> out, const CsvOptions& options = {}, const Policy& policy = {})
+	{
+		if (out.size() != columns.size())
+			throw std::invalid_argument("parse_columns: one output buffer per column required");
+		if (columns.empty())
+			return {};
+
+		const auto [body, header_lines] = detail::body_of(text, options);
+		const char* const base = body.data();
+		const char* const end = base + body.size();
+
+		// Chunk boundaries at line ends
+		std::vector<const char*> bounds{ base };
+		while (bounds.back() != end) {
+			const auto* guess = bounds.back() + std::min<std::size_t>(detail::parse_chunk_bytes, end - bounds.back());
+			const auto* eol = std::find(guess, end, '\n');
+			bounds.push_back(eol == end ? end : eol + 1);
+		}
+		const auto chunks = bounds.size() - 1;
+
+		struct ChunkResult {
+			std::size_t lines = 0;       // output slots reserved
+			std::size_t first_line = 0;  // global 1-based line number of the first line
+			ParseStats stats;
+		};
+		std::vector<ChunkResult> results(chunks);
+
+		Stats::detail::bulk(policy, body.size(), chunks, [&](std::size_t c) {
+			results[c].lines = detail::count_lines(bounds[c], bounds[c + 1]);
+		});
+		std::size_t slots = 0;
+		for (auto& r : results) {
+			r.first_line = header_lines + slots + 1;
+			slots += r.lines;
+		}
+		for (const auto& o : out)
+			if (o.size() < slots)
+				throw std::invalid_argument("parse_columns: output buffers smaller than max_rows()");
+
+		std::vector<std::size_t> first_slot(chunks);
+		std::exclusive_scan(results.begin(), results.end(), first_slot.begin(), std::size_t{ 0 },
+			[](std::size_t a, const auto& r) { return a + r.lines; });
+
+		Stats::detail::bulk(policy, body.size(), chunks, [&](std::size_t c) {
+			auto& r = results[c];
+			std::vector<T> values(columns.size());
+			std::size_t slot = first_slot[c];
+			std::size_t line = r.first_line;
+			for (const char* p = bounds[c]; p < bounds[c + 1]; ++line) {
+				const char* eol = std::find(p, bounds[c + 1], '\n');
+				const char* stop = detail::line_stop(p, eol);
+				if (detail::is_ignorable(p, stop, options)) {
+					++r.stats.skipped;
+				}
+				else if (detail::parse_fields(p, stop, columns, options, std::span<T>(values))) {
+					for (std::size_t k = 0; k < columns.size(); ++k)
+						out[k][slot] = values[k];
+					++slot;
+					++r.stats.rows;
+				}
+				else {
+					if (r.stats.malformed++ == 0)
+						r.stats.first_malformed_line = line;
+				}
+				p = eol + (eol < bounds[c + 1]);
+			}
+		});
+
+		// Close the gaps left by skipped lines (chunks only move towards the front)
+		ParseStats total;
+		for (std::size_t c = 0; c < chunks; ++c) {
+			const auto& s = results[c].stats;
+			if (total.rows != first_slot[c]) {
+				for (const auto& o : out)
+					std::copy_n(o.begin() + static_cast<std::ptrdiff_t>(first_slot[c]), s.rows,
+						o.begin() + static_cast<std::ptrdiff_t>(total.rows));
+			}
+			total.rows += s.rows;
+			total.skipped += s.skipped;
+			if (total.malformed == 0 && s.malformed != 0)
+				total.first_malformed_line = s.first_malformed_line;
+			total.malformed += s.malformed;
+		}
+
+		if (total.malformed != 0 && options.malformed == MalformedRows::fail)
+			throw std::runtime_error("parse_columns: malformed row in line " + std::to_string(total.first_malformed_line));
+		return total;
+	}
+
+	/// @brief Parsed columns and parse statistics.
+	template <typename T>
+	struct ParsedColumns {
+		std::vector<std::vector<T>> columns;  ///< columns[k] holds the requested field k
+		ParseStats stats;
+	};
+
+	/**
+	 * @brief Parses selected columns of numeric text into new vectors
+	 * @throws std::runtime_error on a malformed row if options.malformed == MalformedRows::fail
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	ParsedColumns<T> parse_text(std::string_view text, std::span<const std::size_t> columns,
+		const CsvOptions& options = {}, const Policy& policy = {})
+	{
+		ParsedColumns<T> result;
+		const auto rows = max_rows(text, options);
+		result.columns.assign(columns.size(), std::vector<T>(rows));
+		std::vector<std::span<T>> out(result.columns.begin(), result.columns.end());
+		result.stats = parse_columns(text, columns, std::span<const std::span<T>>(out), options, policy);
+		for (auto& c : result.columns)
+			c.resize(result.stats.rows);
+		return result;
+	}
+
+	/**
+	 * @brief Parses selected columns of a text file (memory-mapped, see MappedFile)
+	 * @throws std::runtime_error if the file cannot be mapped, or on a malformed
+	 *         row if options.malformed == MalformedRows::fail
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	ParsedColumns<T> parse_file(const std::filesystem::path& path, std::span<const std::size_t> columns,
+		const CsvOptions& options = {}, const Policy& policy = {})
+	{
+		const MappedFile file(path);
+		const std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+		return parse_text<T>(text, columns, options, policy);
+	}
+
+} // namespace LinearRegression
@@ -0,0 +1,193 @@
+/**
+ * @file diagnostics.h
+ * @brief Residual diagnostics computed in the SSE pass of fit()
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * fit(x, y, out) is fit() with an opt-in diagnostics mode: the final pass
+ * over the data, which fit() uses only to sum the squared residuals, also
+ * writes per-point diagnostics into caller-provided buffers and reduces the
+ * summary statistics:
+ *
+ *   residual                eᵢ = yᵢ - β₀ - β₁xᵢ
+ *   leverage                hᵢ = 1/n + (xᵢ - x̄)² / Sxx
+ *   standardized residual   rᵢ = eᵢ / (s √(1 - hᵢ))
+ *   Cook's distance         Dᵢ = rᵢ² hᵢ / (2 (1 - hᵢ))
+ *   Durbin-Watson           DW = Σᵢ₌₂ⁿ (eᵢ - eᵢ₋₁)² / SSE
+ *   max |residual|          with the index of the point
+ *
+ * The residual scale s² = SSE / (n - 2) is needed before the pass, so it is
+ * taken from the sums of squares, SSE = Syy - β₁Sxy (see fit_from_moments());
+ * the SSE of the result is still summed explicitly in the pass. Each buffer
+ * is optional: empty spans are not written, and no memory is allocated
+ * beyond what fit() needs.
+ *
+ * Points with leverage 1 (e.g. the single point away from a cluster of
+ * identical x) and perfect fits (s = 0) give NaN standardized residuals and
+ * Cook's distances, like the textbook formulas.
+ *
+ * Example:
+ * @code
+ * std::vector<double> lev(x.size()), cooks(x.size());
+ * auto r = LinearRegression::fit(x, y, LinearRegression::DiagnosticBuffers<double>{ .leverage = lev, .cooks_distance = cooks });
+ * if (r.durbin_watson < 1.5) { ... }                 // positive autocorrelation
+ * auto influential = std::ranges::count_if(cooks, [&](double d) { return d > 4.0 / r.n; });
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include "instrumentation.h"
+#include "linreg.h"
+#include "simd_kernels.h"
+#include "span_compatible.h"
+#include "stats.h"
+
+namespace LinearRegression {
+
+	/// @brief Caller-provided per-point outputs of the diagnostics fit; each is empty or of size n.
+	template <class T>
+	struct DiagnosticBuffers {
+		std::span<T> residuals{};       ///< eᵢ
+		std::span<T> leverage{};        ///< hᵢ
+		std::span<T> standardized{};    ///< rᵢ (internally studentized residuals)
+		std::span<T> cooks_distance{};  ///< Dᵢ
+	};
+
+	/// @brief FitResult with the summary statistics of the residual diagnostics.
+	template <class T>
+	struct DiagnosticFitResult : FitResult<T> {
+		T durbin_watson;                 ///< Σ(eᵢ - eᵢ₋₁)² / SSE; about 2 for uncorrelated residuals
+		T max_abs_residual;              ///< max |eᵢ|
+		std::size_t max_residual_index;  ///< Index of the point with the largest |eᵢ|
+	};
+
+	namespace detail {
+
+		/// @brief Partial result of the diagnostics pass over one chunk.
+		template <class Acc>
+		struct DiagnosticPartial {
+			Stats::simd::DiagnosticSums<Acc> sums;
+			std::size_t max_block = 0;  ///< Start of the block holding max |eᵢ|
+
+			/// Commutative: equal maxima keep the earlier block
+			friend DiagnosticPartial operator+(const DiagnosticPartial& a, const DiagnosticPartial& b) noexcept
+			{
+				const bool first = a.sums.max_abs > b.sums.max_abs
+					|| (a.sums.max_abs == b.sums.max_abs && a.max_block <= b.max_block);
+				return { a.sums + b.sums, first ? a.max_block : b.max_block };
+			}
+		};
+
+		template <class T>
+		[[nodiscard]]
+		T* row_or_null(std::span<T> s) noexcept
+		{
+			return s.empty() ? nullptr : s.data();
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Fits a line and computes the residual diagnostics in the SSE pass
+	 * @tparam T Numeric type of the data
+	 * @tparam Acc Accumulator type of the reductions, the result and the buffers (default: T)
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @param out Buffers for residuals, leverage, standardized residuals and Cook's distances
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @return DiagnosticFitResult<Acc>; the FitResult part equals fit(x, y, policy)
+	 *
+	 * The pass runs blockwise (Stats::detail::co_moment_block) with the
+	 * vectorized simd::diagnostics() kernel, chunked on the parallel backend
+	 * like every other reduction. The index of the largest residual is found
+	 * by rescanning the one block that holds the maximum.
+	 *
+	 * @note Returns empty DiagnosticFitResult under the same conditions as
+	 *       fit(), or if a non-empty buffer does not have n elements.
+	 */
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	DiagnosticFitResult<Acc> fit(std::span<const T> x, std::span<const T> y, const DiagnosticBuffers<Acc>& out,
+		const Policy& policy = {})
+	{
+		// fit() without its SSE pass, then one pass reading x, y and writing the rows
+		LINREG_STAGE_POLICY(fit, 12 * x.size() * sizeof(T) + (out.residuals.size() + out.leverage.size()
+			+ out.standardized.size() + out.cooks_distance.size()) * sizeof(Acc), policy, x.size());
+
+		const auto n = x.size();
+		if (y.size() != n || n < 3) {
+			return {};
+		}
+		for (const auto& buffer : { out.residuals, out.leverage, out.standardized, out.cooks_distance }) {
+			if (!buffer.empty() && buffer.size() != n) {
+				return {};
+			}
+		}
+
+		auto result = DiagnosticFitResult<Acc>{};
+		static_cast<FitResult<Acc>&>(result) = detail::centered_fit<T, Acc>(x, y, policy);
+		if (result.n == 0) {
+			return {};
+		}
+
+		// Residual scale from the sums of squares, as in fit_from_moments()
+		const Acc sse_moments = std::max(result.syy - result.beta1 * result.sxy, Acc{ 0 });
+		const Stats::simd::DiagnosticCoefficients<Acc> c{
+			result.beta0, result.beta1, result.mean_x,
+			Acc{ 1 } / static_cast<Acc>(n), Acc{ 1 } / result.sxx,
+			Acc{ 1 } / std::sqrt(sse_moments / static_cast<Acc>(n - 2))
+		};
+		const Stats::simd::DiagnosticRows<Acc> o{
+			detail::row_or_null(out.residuals), detail::row_or_null(out.leverage),
+			detail::row_or_null(out.standardized), detail::row_or_null(out.cooks_distance)
+		};
+
+		const auto block = Stats::detail::co_moment_block;
+		const auto total = Stats::detail::chunked_reduce(policy, n, detail::DiagnosticPartial<Acc>{},
+			[&c, &o, px = x.data(), py = y.data(), block](std::size_t begin, std::size_t len) {
+				detail::DiagnosticPartial<Acc> acc{};
+				for (std::size_t i = begin; i < begin + len; i += block) {
+					const auto blk = std::min(block, begin + len - i);
+					// Blocks after the first pair their first residual with the one before
+					acc = acc + detail::DiagnosticPartial<Acc>{
+						Stats::simd::diagnostics(px + i, py + i, blk, c, o.at(i), i > 0), i };
+				}
+				return acc;
+			});
+
+		result.sse = total.sums.sse;
+		result.durbin_watson = total.sums.dw / total.sums.sse;
+		result.max_abs_residual = total.sums.max_abs;
+
+		// Position of the maximum within its block
+		result.max_residual_index = total.max_block;
+		Acc best{ -1 };
+		for (std::size_t i = total.max_block; i < std::min(total.max_block + block, n); ++i) {
+			const Acc e = std::abs(Stats::simd::detail::residual_scalar(x.data(), y.data(),
+				static_cast<std::ptrdiff_t>(i), c));
+			if (e > best) {
+				best = e;
+				result.max_residual_index = i;
+			}
+		}
+
+		return result;
+	}
+
+	/// @brief Container overload for the diagnostics fit
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	DiagnosticFitResult<typename C::value_type> fit(const C& x, const C& y,
+		const DiagnosticBuffers<typename C::value_type>& out, const Policy& policy = {})
+	{
+		return fit(Helper::as_span(x), Helper::as_span(y), out, policy);
+	}
+
+} // namespace LinearRegression
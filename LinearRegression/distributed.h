@@ -0,0 +1,236 @@
+/**
+ * @file distributed.h
+ * @brief Serializable partial moments for fits over sharded data
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * A line fit needs only (n, x̄, ȳ, Sxx, Syy, Sxy), and partial results of
+ * disjoint shards merge exactly (CoMoments::merge()). So instead of
+ * shipping x and y to one machine, every worker sends the co-moments of its
+ * shard in a few dozen bytes:
+ *
+ * - serialize_moments():   CoMoments → fixed-size byte record
+ * - deserialize_moments(): byte record → CoMoments (validated)
+ * - merge_serialized():    merges two records, for inner nodes of a reduction tree
+ * - reduce_moments():      merges many partials in a fixed pairwise tree
+ *
+ * Record layout, version 1 (all fields little-endian, on every host):
+ *
+ *   offset  size  field
+ *   0       4     magic "LRCM"
+ *   4       1     version (1)
+ *   5       1     dtype (1 = float32, 2 = float64)
+ *   6       2     reserved (zero)
+ *   8       8     n
+ *   16      5·w   x̄, ȳ, Sxx, Syy, Sxy as IEEE-754, w = 4 (float32) or 8 (float64)
+ *
+ * That is 36 bytes for float and 56 bytes for double (long double is
+ * stored as float64). A record of either dtype can be read into any T.
+ *
+ * Example:
+ * @code
+ * // worker k
+ * auto bytes = Stats::serialize_moments(Stats::co_moments(x_shard, y_shard));
+ * send(bytes);
+ *
+ * // coordinator
+ * std::vector<Stats::CoMoments<double>> parts;
+ * for (const auto& msg : received)
+ *     parts.push_back(Stats::deserialize_moments<double>(msg));
+ * auto r = LinearRegression::fit_from_moments(Stats::reduce_moments<double>(parts));
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "execution.h"
+#include "stats.h"
+
+namespace Stats {
+
+	/// @brief Current version of the co-moment record.
+	inline constexpr std::uint8_t moments_version = 1;
+
+	namespace detail {
+
+		inline constexpr std::array<std::byte, 4> moments_magic = {
+			std::byte{ 'L' }, std::byte{ 'R' }, std::byte{ 'C' }, std::byte{ 'M' }
+		};
+		inline constexpr std::size_t moments_header_size = 16;
+
+		/// float is stored as float32, double and long double as float64.
+		template <std::floating_point T>
+		inline constexpr bool stored_as_float32 = std::is_same_v<T, float>;
+
+		[[nodiscard]]
+		constexpr std::size_t moments_record_size(bool float32) noexcept
+		{
+			return moments_header_size + 5 * (float32 ? 4 : 8);
+		}
+
+		template <std::unsigned_integral U>
+		constexpr void store_le(std::byte* p, U v) noexcept
+		{
+			for (std::size_t i = 0; i < sizeof(U); ++i)
+				p[i] = static_cast<std::byte>((v >> (8 * i)) & 0xFF);
+		}
+
+		template <std::unsigned_integral U>
+		[[nodiscard]]
+		constexpr U load_le(const std::byte* p) noexcept
+		{
+			U v = 0;
+			for (std::size_t i = 0; i < sizeof(U); ++i)
+				v |= static_cast<U>(std::to_integer<U>(p[i]) << (8 * i));
+			return v;
+		}
+
+		template <std::floating_point T>
+		constexpr void store_value(std::byte* p, T v, bool float32) noexcept
+		{
+			if (float32)
+				store_le(p, std::bit_cast<std::uint32_t>(static_cast<float>(v)));
+			else
+				store_le(p, std::bit_cast<std::uint64_t>(static_cast<double>(v)));
+		}
+
+		template <std::floating_point T>
+		[[nodiscard]]
+		constexpr T load_value(const std::byte* p, bool float32) noexcept
+		{
+			if (float32)
+				return static_cast<T>(std::bit_cast<float>(load_le<std::uint32_t>(p)));
+			return static_cast<T>(std::bit_cast<double>(load_le<std::uint64_t>(p)));
+		}
+
+	} // namespace detail
+
+	/// @brief Size in bytes of the record that serialize_moments() writes for CoMoments<T>.
+	template <std::floating_point T>
+	inline constexpr std::size_t serialized_moments_size = detail::moments_record_size(detail::stored_as_float32<T>);
+
+	/**
+	 * @brief Encodes co-moments as a version-1 record (see file comment).
+	 * @param m Co-moments of one shard.
+	 * @return The record; its size depends only on T.
+	 */
+	template <std::floating_point T>
+	[[nodiscard]]
+	constexpr std::array<std::byte, serialized_moments_size<T>> serialize_moments(const CoMoments<T>& m) noexcept
+	{
+		static_assert(std::numeric_limits<float>::is_iec559 && std::numeric_limits<double>::is_iec559,
+			"the record stores IEEE-754 values");
+		constexpr bool float32 = detail::stored_as_float32<T>;
+		constexpr std::size_t w = float32 ? 4 : 8;
+
+		std::array<std::byte, serialized_moments_size<T>> out{};
+		for (std::size_t i = 0; i < detail::moments_magic.size(); ++i)
+			out[i] = detail::moments_magic[i];
+		out[4] = std::byte{ moments_version };
+		out[5] = std::byte{ float32 ? std::uint8_t{ 1 } : std::uint8_t{ 2 } };
+		detail::store_le(out.data() + 8, static_cast<std::uint64_t>(m.n));
+
+		const T values[] = { m.mean_x, m.mean_y, m.sxx, m.syy, m.sxy };
+		for (std::size_t i = 0; i < 5; ++i)
+			detail::store_value(out.data() + detail::moments_header_size + i * w, values[i], float32);
+		return out;
+	}
+
+	/**
+	 * @brief Decodes a record written by serialize_moments().
+	 * @tparam T Type of the result; need not match the stored dtype.
+	 * @param bytes The record (exactly its size).
+	 * @return The co-moments.
+	 * @throws std::invalid_argument if magic, version, dtype or size do not
+	 *         match, the reserved bytes are not zero, or the values are not
+	 *         finite or Sxx, Syy are negative.
+	 */
+	template <std::floating_point T>
+	[[nodiscard]]
+	CoMoments<T> deserialize_moments(std::span<const std::byte> bytes)
+	{
+		if (bytes.size() < detail::moments_header_size)
+			throw std::invalid_argument("deserialize_moments: record is truncated");
+		for (std::size_t i = 0; i < detail::moments_magic.size(); ++i) {
+			if (bytes[i] != detail::moments_magic[i])
+				throw std::invalid_argument("deserialize_moments: not a co-moment record");
+		}
+		if (std::to_integer<std::uint8_t>(bytes[4]) != moments_version)
+			throw std::invalid_argument("deserialize_moments: unsupported version");
+
+		const auto dtype = std::to_integer<std::uint8_t>(bytes[5]);
+		if (dtype != 1 && dtype != 2)
+			throw std::invalid_argument("deserialize_moments: unknown dtype");
+		if (bytes[6] != std::byte{ 0 } || bytes[7] != std::byte{ 0 })
+			throw std::invalid_argument("deserialize_moments: reserved bytes must be zero");
+		const bool float32 = dtype == 1;
+		if (bytes.size() != detail::moments_record_size(float32))
+			throw std::invalid_argument("deserialize_moments: record has the wrong size");
+
+		const auto n = detail::load_le<std::uint64_t>(bytes.data() + 8);
+		if (n > std::numeric_limits<std::size_t>::max())
+			throw std::invalid_argument("deserialize_moments: count does not fit into size_t");
+
+		const std::size_t w = float32 ? 4 : 8;
+		const auto value = [&](std::size_t i) {
+			return detail::load_value<T>(bytes.data() + detail::moments_header_size + i * w, float32);
+		};
+		CoMoments<T> m{ static_cast<std::size_t>(n), value(0), value(1), value(2), value(3), value(4) };
+
+		if (!std::isfinite(m.mean_x) || !std::isfinite(m.mean_y) || !std::isfinite(m.sxx)
+			|| !std::isfinite(m.syy) || !std::isfinite(m.sxy))
+			throw std::invalid_argument("deserialize_moments: values must be finite");
+		if (m.sxx < T{ 0 } || m.syy < T{ 0 })
+			throw std::invalid_argument("deserialize_moments: sums of squares must not be negative");
+		return m;
+	}
+
+	/**
+	 * @brief Merges co-moments in a fixed pairwise tree.
+	 * @param parts Partial results, e.g. one per shard.
+	 * @return The co-moments of the union of the shards.
+	 *
+	 * The tree shape depends only on parts.size() (see detail::tree_reduce()),
+	 * so the result has the same rounding for any arrival order of the
+	 * partials once they are put into shard order.
+	 */
+	template <std::floating_point T>
+	[[nodiscard]]
+	CoMoments<T> reduce_moments(std::span<const CoMoments<T>> parts)
+	{
+		if (parts.empty())
+			return {};
+		std::vector<CoMoments<T>> values(parts.begin(), parts.end());
+		return detail::tree_reduce(values, [](CoMoments<T> a, const CoMoments<T>& b) {
+			a.merge(b);
+			return a;
+		});
+	}
+
+	/**
+	 * @brief Merges two records into one, for the inner nodes of a reduction tree.
+	 * @tparam T Precision of the merge and of the output record.
+	 * @throws std::invalid_argument if either record is invalid (see deserialize_moments()).
+	 */
+	template <std::floating_point T>
+	[[nodiscard]]
+	std::array<std::byte, serialized_moments_size<T>> merge_serialized(std::span<const std::byte> a,
+		std::span<const std::byte> b)
+	{
+		auto m = deserialize_moments<T>(a);
+		m.merge(deserialize_moments<T>(b));
+		return serialize_moments(m);
+	}
+
+} // namespace Stats
@@ -0,0 +1,289 @@
+/**
+ * @file execution.h
+ * @brief Execution policies for the Stats:: reductions and LinearRegression::fit.
+ *
+ * Policies:
+ * - exec::seq        calling thread only (vectorized kernels, no thread pool)
+ * - exec::par        always dispatch to the parallel backend (std::execution::par)
+ * - exec::automatic  stay on the calling thread below a size threshold (default)
+ * - exec::on(pool)   dispatch to a caller-supplied thread pool
+ * - exec::deterministic  parallel, but bit-identical for any thread count
+ *
+ * The threshold of exec::automatic is tunable globally with
+ * set_parallel_threshold() or per call with automatic_policy{ n }.
+ *
+ * Notes:
+ * - Work is split into fixed chunks of detail::par_chunk elements, so the
+ *   dispatch cost is paid once per chunk rather than once per element.
+ * - exec::par and exec::automatic combine chunk results in whatever order the
+ *   backend chooses, so the last bits can vary between runs. exec::deterministic
+ *   always uses the same chunks and combines them in a fixed pairwise tree,
+ *   whether it runs sequentially or in parallel. Results then depend only on
+ *   the data and the active SIMD path (see Stats::simd::set_isa()).
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace Stats {
+
+	namespace exec {
+
+		/// Default size (elements) from which exec::automatic goes parallel.
+		inline constexpr std::size_t default_parallel_threshold = std::size_t{ 1 } << 17;
+
+		namespace detail {
+			[[nodiscard]]
+			inline std::atomic<std::size_t>& parallel_threshold_state() noexcept
+			{
+				static std::atomic<std::size_t> threshold{ default_parallel_threshold };
+				return threshold;
+			}
+		} // namespace detail
+
+		/// @brief Current global threshold of exec::automatic.
+		[[nodiscard]]
+		inline std::size_t parallel_threshold() noexcept
+		{
+			return detail::parallel_threshold_state().load(std::memory_order_relaxed);
+		}
+
+		/// @brief Sets the global threshold of exec::automatic (elements per call).
+		inline void set_parallel_threshold(std::size_t n) noexcept
+		{
+			detail::parallel_threshold_state().store(n, std::memory_order_relaxed);
+		}
+
+		/// @brief Run on the calling thread.
+		struct sequenced_policy {
+			[[nodiscard]] constexpr bool parallel(std::size_t) const noexcept { return false; }
+		};
+
+		/// @brief Always use the standard parallel backend.
+		struct parallel_policy {
+			[[nodiscard]] constexpr bool parallel(std::size_t) const noexcept { return true; }
+		};
+
+		/// @brief Parallel backend only for inputs of at least `threshold` elements.
+		struct automatic_policy {
+			std::size_t threshold = 0;  ///< 0 selects the global parallel_threshold()
+
+			[[nodiscard]] bool parallel(std::size_t n) const noexcept
+			{
+				return n >= (threshold != 0 ? threshold : parallel_threshold());
+			}
+		};
+
+		/**
+		 * @brief Reproducible reduction: fixed chunking and a fixed combine tree.
+		 *
+		 * Runs in parallel from `threshold` elements on (0: global parallel_threshold()),
+		 * but the result does not depend on the thread count or scheduling.
+		 */
+		struct deterministic_policy {
+			std::size_t threshold = 0;  ///< 0 selects the global parallel_threshold()
+
+			[[nodiscard]] bool parallel(std::size_t n) const noexcept
+			{
+				return n >= (threshold != 0 ? threshold : parallel_threshold());
+			}
+		};
+
+		/**
+		 * @brief Requirements for a caller-supplied thread pool.
+		 *
+		 * pool.parallel_for(count, f) must invoke f(i) for every i in [0, count),
+		 * possibly concurrently, and return once all invocations have finished.
+		 */
+		template <class Pool>
+		concept ThreadPool = requires(Pool & pool, std::size_t count, std::function<void(std::size_t)> f) {
+			pool.parallel_for(count, f);
+		};
+
+		/// @brief Dispatch to a caller-supplied thread pool (see on()).
+		template <ThreadPool Pool>
+		struct pool_policy {
+			Pool* pool;
+			std::size_t threshold = 0;  ///< Inputs below this size run on the calling thread
+
+			[[nodiscard]] constexpr bool parallel(std::size_t n) const noexcept { return n >= threshold; }
+		};
+
+		/**
+		 * @brief Policy that runs parallel work on `pool` instead of the std backend.
+		 * @param pool Thread pool satisfying ThreadPool; must outlive the calls.
+		 * @param threshold Inputs smaller than this stay on the calling thread.
+		 *
+		 * Example:
+		 * @code
+		 * struct MyPool {
+		 *     void parallel_for(std::size_t n, const std::function<void(std::size_t)>& f);
+		 * } pool;
+		 * auto r = LinearRegression::fit(x, y, Stats::exec::on(pool));
+		 * @endcode
+		 */
+		template <ThreadPool Pool>
+		[[nodiscard]]
+		constexpr pool_policy<Pool> on(Pool& pool, std::size_t threshold = 0) noexcept
+		{
+			return { &pool, threshold };
+		}
+
+		inline constexpr sequenced_policy seq{};
+		inline constexpr parallel_policy par{};
+		inline constexpr automatic_policy automatic{};
+		inline constexpr deterministic_policy deterministic{};
+
+		template <class T>
+		inline constexpr bool is_pool_policy = false;
+		template <class Pool>
+		inline constexpr bool is_pool_policy<pool_policy<Pool>> = true;
+
+	} // namespace exec
+
+	/// @brief Any of the policies in Stats::exec.
+	template <class P>
+	concept ExecutionPolicy = requires(const P & p, std::size_t n) {
+		{ p.parallel(n) } -> std::convertible_to<bool>;
+	};
+
+	namespace detail {
+
+		/// Elements per parallel task; large enough to amortize the dispatch.
+		inline constexpr std::size_t par_chunk = std::size_t{ 1 } << 16;
+
+		/// @brief Random-access iterator over chunk indices (no index array needed).
+		class IndexIterator {
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::size_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::size_t*;
+			using reference = std::size_t;
+
+			constexpr IndexIterator() noexcept = default;
+			explicit constexpr IndexIterator(std::size_t i) noexcept : i_(i) {}
+
+			constexpr reference operator*() const noexcept { return i_; }
+			constexpr reference operator[](difference_type d) const noexcept { return i_ + d; }
+			constexpr IndexIterator& operator++() noexcept { ++i_; return *this; }
+			constexpr IndexIterator operator++(int) noexcept { auto t = *this; ++i_; return t; }
+			constexpr IndexIterator& operator--() noexcept { --i_; return *this; }
+			constexpr IndexIterator operator--(int) noexcept { auto t = *this; --i_; return t; }
+			constexpr IndexIterator& operator+=(difference_type d) noexcept { i_ += d; return *this; }
+			constexpr IndexIterator& operator-=(difference_type d) noexcept { i_ -= d; return *this; }
+			friend constexpr IndexIterator operator+(IndexIterator a, difference_type d) noexcept { return a += d; }
+			friend constexpr IndexIterator operator+(difference_type d, IndexIterator a) noexcept { return a += d; }
+			friend constexpr IndexIterator operator-(IndexIterator a, difference_type d) noexcept { return a -= d; }
+			friend constexpr difference_type operator-(IndexIterator a, IndexIterator b) noexcept
+			{
+				return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+			}
+			friend constexpr auto operator<=>(IndexIterator, IndexIterator) noexcept = default;
+
+		private:
+			std::size_t i_{};
+		};
+
+		/**
+		 * @brief Runs f(i) for i in [0, count) according to the policy.
+		 * @param policy Execution policy.
+		 * @param work Problem size (elements) used for the parallel decision.
+		 * @param count Number of tasks.
+		 * @param f Task callable.
+		 */
+		template <ExecutionPolicy Policy, class F>
+		void bulk(const Policy& policy, std::size_t work, std::size_t count, F f)
+		{
+			if (count <= 1 || !policy.parallel(work)) {
+				for (std::size_t i = 0; i < count; ++i)
+					f(i);
+			}
+			else if constexpr (exec::is_pool_policy<Policy>) {
+				policy.pool->parallel_for(count, std::function<void(std::size_t)>(std::ref(f)));
+			}
+			else {
+				std::for_each(std::execution::par, IndexIterator{ 0 }, IndexIterator{ count }, f);
+			}
+		}
+
+		/**
+		 * @brief Combines values[0..n) in a fixed pairwise tree (overwrites values).
+		 *
+		 * The tree shape depends only on n, which makes the rounding of the
+		 * combined result reproducible; pairwise combination also keeps the
+		 * error growth logarithmic in the number of values.
+		 */
+		template <class R, class Combine>
+		[[nodiscard]]
+		R tree_reduce(std::vector<R>& values, Combine combine)
+		{
+			const auto n = values.size();
+			for (std::size_t stride = 1; stride < n; stride *= 2) {
+				for (std::size_t i = 0; i + stride < n; i += 2 * stride)
+					values[i] = combine(values[i], values[i + stride]);
+			}
+			return values.front();
+		}
+
+		/**
+		 * @brief Reduction over fixed-size chunks of [0, n).
+		 * @param policy Execution policy.
+		 * @param n Number of elements.
+		 * @param init Initial value.
+		 * @param chunk_fn Callable (begin, length) -> R reducing one chunk.
+		 * @param combine Associative, commutative binary operation on R.
+		 *
+		 * Sequential execution reduces the whole range with a single chunk_fn call,
+		 * except under exec::deterministic, which always evaluates the same
+		 * chunks and combines them with tree_reduce().
+		 */
+		template <ExecutionPolicy Policy, class R, class F, class Combine = std::plus<>>
+		[[nodiscard]]
+		R chunked_reduce(const Policy& policy, std::size_t n, R init, F chunk_fn, Combine combine = {})
+		{
+			if (n == 0)
+				return init;
+
+			const auto chunks = (n + par_chunk - 1) / par_chunk;
+			auto task = [n, &chunk_fn](std::size_t c) {
+				const auto begin = c * par_chunk;
+				return chunk_fn(begin, std::min(par_chunk, n - begin));
+			};
+
+			if constexpr (std::same_as<Policy, exec::deterministic_policy>) {
+				if (chunks <= 1)
+					return combine(init, chunk_fn(std::size_t{ 0 }, n));
+				std::vector<R> partials(chunks);
+				bulk(policy, n, chunks, [&](std::size_t c) { partials[c] = task(c); });
+				return combine(init, tree_reduce(partials, combine));
+			}
+
+			if (chunks <= 1 || !policy.parallel(n))
+				return combine(init, chunk_fn(std::size_t{ 0 }, n));
+
+			if constexpr (exec::is_pool_policy<Policy>) {
+				// The pool only runs tasks, so partial results go into a per-chunk buffer
+				std::vector<R> partials(chunks);
+				bulk(policy, n, chunks, [&](std::size_t c) { partials[c] = task(c); });
+				for (const auto& p : partials)
+					init = combine(init, p);
+				return init;
+			}
+			else {
+				return std::transform_reduce(std::execution::par,
+					IndexIterator{ 0 }, IndexIterator{ chunks },
+					init, combine, task);
+			}
+		}
+
+	} // namespace detail
+
+} // namespace Stats
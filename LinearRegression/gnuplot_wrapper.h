@@ -1,17 +1,93 @@
+/**
+ * @file gnuplot_wrapper.h
+ * @brief Asynchronous pipe to gnuplot with buffered text or binary inline data
+ *
+ * The wrapper owns a writer thread. send_command(), send_data() and plot()
+ * only serialize their data and hand it over through a bounded lock-free
+ * queue (see bounded_queue.h); the writer thread does all pipe I/O, so a
+ * slow gnuplot never blocks the caller as long as the queue has room. The pipe
+ * is flushed whenever the queue runs empty, and flush() returns a future that
+ * is ready once everything queued before it has reached gnuplot.
+ *
+ * Backpressure (full queue) is configurable for plot() frames:
+ * - block        wait until the writer has made room
+ * - drop_oldest  discard the oldest queued frame, keeping the newest plots
+ * - drop_newest  discard the frame being submitted
+ * Commands, data blocks and flush requests are never dropped; they wait.
+ *
+ * Datasets are sent inline ('-') after the plot command, either as text
+ * (one "%.17g" line per record, terminated by "e") or in gnuplot's binary
+ * format: the columns are interleaved into float64 records and written with
+ * large fwrite() calls, so a plot costs one pass over memory instead of one
+ * formatted print per number.
+ *
+ * plot() draws a fitted line with its confidence and prediction bands. The
+ * bands are evaluated on a fixed grid, the line is sent as its 2 endpoints,
+ * and the scatter is optionally decimated to one point per screen cell.
+ *
+ * The queue has a single producer: all member functions of one wrapper must
+ * be called from the same thread (or be externally serialized). Only the
+ * writer thread runs concurrently with them.
+ */
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <initializer_list>
+#include <limits>
+#include <optional>
 #include <span>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
+#include "bounded_queue.h"
+#include "linreg.h"
+#include "predict.h"
 
 class GnuplotWrapper {
 public:
-	GnuplotWrapper() {
+	/// @brief What plot() does when the queue is full.
+	enum class Backpressure { block, drop_oldest, drop_newest };
+
+	/// @brief Options of plot().
+	struct PlotOptions {
+		bool binary = true;           ///< Send datasets in gnuplot's binary format
+		bool decimate = true;         ///< Keep one scatter point per screen cell
+		std::size_t width = 1920;     ///< Horizontal cells used for decimation
+		std::size_t height = 1080;    ///< Vertical cells used for decimation
+		std::size_t band_points = 200;  ///< Grid size of the CI/PI bands
+		double alpha = 0.05;          ///< Significance level of the bands
+	};
+
+	/**
+	 * @param backpressure Policy for plot() frames when the queue is full
+	 * @param queue_capacity Messages in flight (rounded up to a power of two)
+	 */
+	explicit GnuplotWrapper(Backpressure backpressure = Backpressure::block, std::size_t queue_capacity = 64)
+		: policy(backpressure), queue(queue_capacity) {
+		// Binary data must pass unchanged, hence "wb" on Windows
 #ifdef _WIN32
-		gp = _popen("gnuplot -persistent", "w");
+		gp = _popen("gnuplot -persistent", "wb");
 #else
 		gp = popen("gnuplot -persistent", "w");
 #endif
+		if (gp != nullptr) {
+			setvbuf(gp, nullptr, _IOFBF, pipe_buffer);
+			writer = std::thread([this] { run(); });
+		}
 	}
 	~GnuplotWrapper() {
+		if (gp == nullptr)
+			return;
+		Message stop;
+		stop.kind = Message::Kind::stop;
+		enqueue(stop, false);
+		writer.join();
 #ifdef _WIN32
 		_pclose(gp);
 #else
@@ -19,35 +95,274 @@ public:
 #endif
 	}
 
+	GnuplotWrapper(const GnuplotWrapper&) = delete;
+	GnuplotWrapper& operator=(const GnuplotWrapper&) = delete;
+
 	bool is_open() const {
 		return gp != nullptr;
 	}
 
 	void send_command(const char* cmd) {
+		send_command(std::string_view(cmd));
+	}
+
+	/// @brief Queues one command line (never dropped).
+	void send_command(std::string_view s) {
 		if (gp == nullptr) {
 			fprintf(stderr, "Error: Gnuplot not initialized.\n");
 			return;
 		}
-		fprintf(gp, "%s\n", cmd);
-		fflush(gp);
+		Message m;
+		m.bytes.reserve(s.size() + 1);
+		m.bytes.append(s).push_back('\n');
+		enqueue(m, false);
 	}
 
-	void send_command(std::string_view s) {
-		send_command(s.data());
-	}
-
-	void plot(const std::span<double>& x, const std::span<double>& y) {
-		fprintf(gp,
-			"plot "
-			"'-' using 1:2:3 with filledcurves title '95%% CI', "
-			"'-' with lines lw 2 dashtype 0.8 title 'Regression', "
-			"'-' with points pt 7 ps 0.8 title 'Data'\n"
-		);
-		for (size_t i = 0; i < x.size(); ++i)
-			fprintf(gp, "%f %f\n", x[i], y[i]);
-		fprintf(gp, "e\n");
-	};
+	/**
+	 * @brief Inline data specifier for a dataset of the given shape
+	 * @return "'-'" in text mode, "'-' binary record=N format='%float64...'" otherwise
+	 */
+	static std::string inline_source(std::size_t records, std::size_t columns, bool binary) {
+		if (!binary)
+			return "'-'";
+		std::string s = "'-' binary record=" + std::to_string(records) + " format='";
+		for (std::size_t c = 0; c < columns; ++c)
+			s += "%float64";
+		return s + "'";
+	}
+
+	/**
+	 * @brief Queues one inline dataset (send after a plot command naming it; never dropped)
+	 * @param columns Equally sized columns; record i is (columns[0][i], columns[1][i], ...)
+	 * @param binary Binary records (matching inline_source()) or text lines
+	 */
+	void send_data(std::initializer_list<std::span<const double>> columns, bool binary) {
+		if (gp == nullptr)
+			return;
+		Message m;
+		append_data(m.bytes, columns, binary);
+		enqueue(m, false);
+	}
+
+	/**
+	 * @brief Returns a future that is ready once all previously queued messages
+	 *        have been written and the pipe has been flushed
+	 */
+	std::future<void> flush() {
+		Message m;
+		m.kind = Message::Kind::flush;
+		auto done = m.done.emplace().get_future();
+		if (gp == nullptr)
+			m.done->set_value();
+		else
+			enqueue(m, false);
+		return done;
+	}
+
+	/// @brief Number of plot() frames discarded by the backpressure policy.
+	std::size_t dropped() const {
+		return dropped_frames.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Reduces a scatter to at most one point per cell of a width × height grid
+	 *
+	 * The grid spans the bounding box of the finite points; the first point
+	 * falling into a cell is kept. At screen resolution the plot looks the
+	 * same. Points with a NaN or infinite coordinate are dropped.
+	 */
+	static void decimate(std::span<const double> x, std::span<const double> y,
+		std::size_t width, std::size_t height, std::vector<double>& xo, std::vector<double>& yo) {
+		xo.clear();
+		yo.clear();
+		const auto n = std::min(x.size(), y.size());
+		if (n == 0 || width == 0 || height == 0)
+			return;
+		const auto finite = [&](std::size_t i) { return std::isfinite(x[i]) && std::isfinite(y[i]); };
+		double xmin = std::numeric_limits<double>::infinity(), xmax = -xmin, ymin = xmin, ymax = -xmin;
+		for (std::size_t i = 0; i < n; ++i) {
+			if (!finite(i))
+				continue;
+			xmin = std::min(xmin, x[i]);
+			xmax = std::max(xmax, x[i]);
+			ymin = std::min(ymin, y[i]);
+			ymax = std::max(ymax, y[i]);
+		}
+		if (xmin > xmax)
+			return;  // no finite point
+		// A range that overflows to inf gives a zero scale, i.e. a single cell
+		const double sx = xmax > xmin ? static_cast<double>(width - 1) / (xmax - xmin) : 0.0;
+		const double sy = ymax > ymin ? static_cast<double>(height - 1) / (ymax - ymin) : 0.0;
+		// Cell index clamped to [0, cells - 1]; NaN (inf · 0) maps to 0
+		const auto cell_of = [](double v, double lo, double scale, std::size_t cells) {
+			const double c = (v - lo) * scale;
+			return c >= 0.0 ? static_cast<std::size_t>(std::min(c, static_cast<double>(cells - 1))) : std::size_t{ 0 };
+		};
+
+		std::vector<bool> taken(width * height);
+		for (std::size_t i = 0; i < n; ++i) {
+			if (!finite(i))
+				continue;
+			const auto cx = cell_of(x[i], xmin, sx, width);
+			const auto cy = cell_of(y[i], ymin, sy, height);
+			const auto cell = cy * width + cx;
+			if (!taken[cell]) {
+				taken[cell] = true;
+				xo.push_back(x[i]);
+				yo.push_back(y[i]);
+			}
+		}
+	}
+
+	/**
+	 * @brief Queues a plot of the data with the fitted line, its confidence and prediction bands
+	 * @return false if gnuplot is not open, the data cannot be fitted, or the
+	 *         frame was dropped (Backpressure::drop_newest)
+	 *
+	 * The fit, the bands and the serialization run on the calling thread;
+	 * writing to gnuplot happens on the writer thread.
+	 */
+	bool plot(std::span<const double> x, std::span<const double> y, const PlotOptions& options) {
+		if (gp == nullptr) {
+			fprintf(stderr, "Error: Gnuplot not initialized.\n");
+			return false;
+		}
+		const auto res = LinearRegression::fit(x, y);
+		if (res.n == 0 || options.band_points < 2)
+			return false;
+
+		// Bands on a grid over the range of x
+		const auto [xmin, xmax] = std::minmax_element(x.begin(), x.end());
+		const auto m = options.band_points;
+		std::vector<double> grid(m), fit(m), ci_lo(m), ci_hi(m), pi_lo(m), pi_hi(m);
+		for (std::size_t i = 0; i < m; ++i)
+			grid[i] = *xmin + (*xmax - *xmin) * static_cast<double>(i) / static_cast<double>(m - 1);
+		LinearRegression::predict_bands(res, std::span<const double>(grid), options.alpha,
+			{ fit, ci_lo, ci_hi, pi_lo, pi_hi });
+
+		// The regression line is straight: its endpoints suffice
+		const double ends[2] = { *xmin, *xmax };
+		double ends_y[2];
+		LinearRegression::predict(res, std::span<const double>(ends), std::span<double>(ends_y));
+
+		std::vector<double> dx, dy;
+		if (options.decimate)
+			decimate(x, y, options.width, options.height, dx, dy);
+		const std::span<const double> px = options.decimate ? std::span<const double>(dx) : x;
+		const std::span<const double> py = options.decimate ? std::span<const double>(dy) : y;
+
+		// One frame: the plot command followed by its four datasets
+		const auto level = 100.0 * (1.0 - options.alpha);
+		const auto b = options.binary;
+		char title[32];
+		snprintf(title, sizeof(title), "%g%%", level);
+		Message frame;
+		frame.bytes = "plot "
+			+ inline_source(m, 3, b) + " using 1:2:3 with filledcurves title '" + title + " PI', "
+			+ inline_source(m, 3, b) + " using 1:2:3 with filledcurves title '" + title + " CI', "
+			+ inline_source(2, 2, b) + " using 1:2 with lines lw 2 dashtype 0.8 title 'Regression', "
+			+ inline_source(px.size(), 2, b) + " using 1:2 with points pt 7 ps 0.8 title 'Data'\n";
+		append_data(frame.bytes, { grid, pi_lo, pi_hi }, b);
+		append_data(frame.bytes, { grid, ci_lo, ci_hi }, b);
+		append_data(frame.bytes, { ends, ends_y }, b);
+		append_data(frame.bytes, { px, py }, b);
+		return enqueue(frame, true);
+	}
+
+	/// @brief plot() with default PlotOptions.
+	bool plot(std::span<const double> x, std::span<const double> y) {
+		return plot(x, y, PlotOptions{});
+	}
 
 private:
+	/// Unit of work of the writer thread.
+	struct Message {
+		enum class Kind { data, flush, stop } kind = Kind::data;
+		std::string bytes;          ///< Written to the pipe as is (Kind::data)
+		std::optional<std::promise<void>> done;  ///< Engaged (and fulfilled after the flush) for Kind::flush only
+	};
+
+	/// Size of the stdio buffer of the pipe (bytes).
+	static constexpr std::size_t pipe_buffer = std::size_t{ 1 } << 20;
+
+	/// Serializes columns as interleaved float64 records or as text lines.
+	static void append_data(std::string& out, std::initializer_list<std::span<const double>> columns, bool binary) {
+		if (columns.size() == 0)
+			return;
+		const auto records = columns.begin()->size();
+		if (binary) {
+			auto pos = out.size();
+			out.resize(pos + records * columns.size() * sizeof(double));
+			for (std::size_t i = 0; i < records; ++i)
+				for (auto col : columns) {
+					std::memcpy(out.data() + pos, &col[i], sizeof(double));
+					pos += sizeof(double);
+				}
+		}
+		else {
+			char buf[32];
+			for (std::size_t i = 0; i < records; ++i) {
+				bool first = true;
+				for (auto col : columns) {
+					if (!first)
+						out.push_back(' ');
+					first = false;
+					const auto r = std::to_chars(buf, buf + sizeof(buf), col[i], std::chars_format::general, 17);
+					out.append(buf, r.ptr);
+				}
+				out.push_back('\n');
+			}
+			out += "e\n";
+		}
+	}
+
+	/// Hands m to the writer thread; frames follow the backpressure policy.
+	bool enqueue(Message& m, bool frame) {
+		for (;;) {
+			const auto seen = queue.dequeued();
+			if (queue.try_push(m, frame))
+				return true;
+			if (frame && policy == Backpressure::drop_newest) {
+				dropped_frames.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			if (frame && policy == Backpressure::drop_oldest && queue.try_discard_front()) {
+				dropped_frames.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			queue.wait_for_space(seen);
+		}
+	}
+
+	/// Writer thread: drains the queue into the pipe, flushing when it runs empty.
+	void run() {
+		Message m;
+		for (;;) {
+			const auto seen = queue.pushed();
+			if (!queue.try_pop(m)) {
+				fflush(gp);
+				queue.wait_for_data(seen);
+				continue;
+			}
+			switch (m.kind) {
+			case Message::Kind::data:
+				fwrite(m.bytes.data(), 1, m.bytes.size(), gp);
+				break;
+			case Message::Kind::flush:
+				fflush(gp);
+				m.done->set_value();
+				m.done.reset();
+				break;
+			case Message::Kind::stop:
+				fflush(gp);
+				return;
+			}
+		}
+	}
+
+	Backpressure policy;
 	FILE* gp{};
-};
\ No newline at end of file
+	Helper::BoundedQueue<Message> queue;
+	std::atomic<std::size_t> dropped_frames{ 0 };
+	std::thread writer;
+};
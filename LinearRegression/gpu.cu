@@ -0,0 +1,432 @@
+/**
+ * @file gpu.cu
+ * @brief CUDA implementation of the Stats::gpu reductions declared in gpu.h
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Compiled only with LINREG_WITH_CUDA (requires CUDA 11.1 or later and a
+ * device of compute capability 6.0 or higher for double atomicAdd).
+ *
+ * Every call plans a list of tasks, each one contiguous range of at most
+ * stage_elements points: either a run of whole short series or one chunk of
+ * a long series. Task t is uploaded into slot t % 2 and reduced on the
+ * stream of that slot, so the copy of task t + 1 overlaps the kernel of
+ * task t. A kernel writes five shifted sums (Σdx, Σdy, Σdx², Σdy², Σdx·dy)
+ * per series or chunk; the host turns them into CoMoments and merges the
+ * chunks of a long series in order.
+ */
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "gpu.h"
+
+namespace Stats::gpu {
+
+	namespace {
+
+		/// Points per task and staging slot (per array).
+		constexpr std::size_t stage_elements = std::size_t{ 1 } << 22;
+		/// Series longer than this are reduced by all blocks, not by one warp.
+		constexpr std::size_t long_series = std::size_t{ 1 } << 16;
+		/// Inputs of at least this size are page-locked in place instead of staged.
+		constexpr std::size_t register_min_bytes = std::size_t{ 64 } << 20;
+
+		constexpr int slots = 2;
+		constexpr int block_threads = 256;
+		constexpr int warp_size = 32;
+		constexpr int sums = 5;
+
+		void check(cudaError_t status, const char* what)
+		{
+			if (status != cudaSuccess)
+				throw std::runtime_error(std::string("gpu: ") + what + ": " + cudaGetErrorString(status));
+		}
+
+		struct DeviceFree {
+			void operator()(void* p) const noexcept { cudaFree(p); }
+		};
+		struct HostFree {
+			void operator()(void* p) const noexcept { cudaFreeHost(p); }
+		};
+		struct StreamDestroy {
+			void operator()(cudaStream_t s) const noexcept
+			{
+				cudaStreamSynchronize(s);
+				cudaStreamDestroy(s);
+			}
+		};
+		struct EventDestroy {
+			void operator()(cudaEvent_t e) const noexcept { cudaEventDestroy(e); }
+		};
+
+		template <class T>
+		using device_ptr = std::unique_ptr<T[], DeviceFree>;
+		template <class T>
+		using pinned_ptr = std::unique_ptr<T[], HostFree>;
+		using stream_ptr = std::unique_ptr<std::remove_pointer_t<cudaStream_t>, StreamDestroy>;
+		using event_ptr = std::unique_ptr<std::remove_pointer_t<cudaEvent_t>, EventDestroy>;
+
+		template <class T>
+		[[nodiscard]] device_ptr<T> device_alloc(std::size_t n)
+		{
+			void* p = nullptr;
+			check(cudaMalloc(&p, std::max<std::size_t>(n, 1) * sizeof(T)), "cudaMalloc");
+			return device_ptr<T>(static_cast<T*>(p));
+		}
+
+		template <class T>
+		[[nodiscard]] pinned_ptr<T> pinned_alloc(std::size_t n)
+		{
+			void* p = nullptr;
+			check(cudaMallocHost(&p, std::max<std::size_t>(n, 1) * sizeof(T)), "cudaMallocHost");
+			return pinned_ptr<T>(static_cast<T*>(p));
+		}
+
+		[[nodiscard]] stream_ptr make_stream()
+		{
+			cudaStream_t s = nullptr;
+			check(cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking), "cudaStreamCreate");
+			return stream_ptr(s);
+		}
+
+		[[nodiscard]] event_ptr make_event()
+		{
+			cudaEvent_t e = nullptr;
+			check(cudaEventCreateWithFlags(&e, cudaEventDisableTiming), "cudaEventCreate");
+			return event_ptr(e);
+		}
+
+		/// @brief Makes a device current for the lifetime of the guard.
+		class DeviceGuard {
+		public:
+			explicit DeviceGuard(int device)
+			{
+				check(cudaGetDevice(&previous_), "cudaGetDevice");
+				check(cudaSetDevice(device), "cudaSetDevice");
+			}
+			~DeviceGuard() { cudaSetDevice(previous_); }
+			DeviceGuard(const DeviceGuard&) = delete;
+			DeviceGuard& operator=(const DeviceGuard&) = delete;
+
+		private:
+			int previous_ = 0;
+		};
+
+		/**
+		 * @brief One input array and its device slots.
+		 *
+		 * upload() copies a range into a device slot asynchronously: straight
+		 * from the caller's memory if it could be page-locked, otherwise via a
+		 * pinned staging buffer per slot, which is refilled only after its
+		 * previous copy has finished.
+		 */
+		template <class T>
+		class Source {
+		public:
+			Source(std::span<const T> data, std::size_t capacity) : data_(data)
+			{
+				if (data.size_bytes() >= register_min_bytes) {
+					auto* p = const_cast<T*>(data.data());
+					registered_ = cudaHostRegister(p, data.size_bytes(), cudaHostRegisterReadOnly) == cudaSuccess
+						|| cudaHostRegister(p, data.size_bytes(), cudaHostRegisterDefault) == cudaSuccess;
+					// e.g. cudaErrorHostMemoryAlreadyRegistered; stage instead
+					static_cast<void>(cudaGetLastError());
+				}
+				for (int s = 0; s < slots; ++s) {
+					device_[s] = device_alloc<T>(capacity);
+					if (!registered_) {
+						staging_[s] = pinned_alloc<T>(capacity);
+						copied_[s] = make_event();
+					}
+				}
+			}
+
+			~Source()
+			{
+				if (registered_)
+					cudaHostUnregister(const_cast<T*>(data_.data()));
+			}
+
+			Source(const Source&) = delete;
+			Source& operator=(const Source&) = delete;
+
+			[[nodiscard]] const T* upload(int slot, std::size_t begin, std::size_t len, cudaStream_t stream)
+			{
+				if (len == 0)
+					return device_[slot].get();
+				const T* src = data_.data() + begin;
+				if (!registered_) {
+					check(cudaEventSynchronize(copied_[slot].get()), "cudaEventSynchronize");
+					std::memcpy(staging_[slot].get(), src, len * sizeof(T));
+					src = staging_[slot].get();
+				}
+				check(cudaMemcpyAsync(device_[slot].get(), src, len * sizeof(T), cudaMemcpyHostToDevice, stream),
+					"cudaMemcpyAsync");
+				if (!registered_)
+					check(cudaEventRecord(copied_[slot].get(), stream), "cudaEventRecord");
+				return device_[slot].get();
+			}
+
+		private:
+			std::span<const T> data_;
+			bool registered_ = false;
+			device_ptr<T> device_[slots];
+			pinned_ptr<T> staging_[slots];
+			event_ptr copied_[slots];
+		};
+
+		/// @brief Uploaded range of a task: whole series [first, first + count) or one chunk of series first.
+		struct Task {
+			std::size_t first = 0;
+			std::size_t count = 0;  ///< 0 for a chunk of a long series
+			std::size_t begin = 0;
+			std::size_t len = 0;
+			std::size_t slot = 0;   ///< Index of the five sums of a chunk
+		};
+
+		__device__ inline void warp_reduce(double (&s)[sums])
+		{
+			for (int offset = warp_size / 2; offset > 0; offset /= 2) {
+				for (int j = 0; j < sums; ++j)
+					s[j] += __shfl_down_sync(0xFFFFFFFFu, s[j], offset);
+			}
+		}
+
+		template <class T>
+		__device__ inline void accumulate(double (&s)[sums], T x, T y, double x0, double y0)
+		{
+			const double dx = static_cast<double>(x) - x0;
+			const double dy = static_cast<double>(y) - y0;
+			s[0] += dx;
+			s[1] += dy;
+			s[2] += dx * dx;
+			s[3] += dy * dy;
+			s[4] += dx * dy;
+		}
+
+		/// Shifted sums of one chunk; every block adds its share to out[0..5).
+		template <class T>
+		__global__ void __launch_bounds__(block_threads)
+		chunk_sums_kernel(const T* __restrict__ x, const T* __restrict__ y, std::size_t n,
+			double x0, double y0, double* __restrict__ out)
+		{
+			double s[sums] = {};
+			const auto stride = static_cast<std::size_t>(blockDim.x) * gridDim.x;
+			for (auto i = static_cast<std::size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride)
+				accumulate(s, x[i], y[i], x0, y0);
+			warp_reduce(s);
+
+			__shared__ double partial[block_threads / warp_size][sums];
+			const int lane = threadIdx.x % warp_size;
+			const int warp = threadIdx.x / warp_size;
+			if (lane == 0) {
+				for (int j = 0; j < sums; ++j)
+					partial[warp][j] = s[j];
+			}
+			__syncthreads();
+			if (warp == 0) {
+				for (int j = 0; j < sums; ++j)
+					s[j] = lane < block_threads / warp_size ? partial[lane][j] : 0.0;
+				warp_reduce(s);
+				if (lane == 0) {
+					for (int j = 0; j < sums; ++j)
+						atomicAdd(out + j, s[j]);
+				}
+			}
+		}
+
+		/// Shifted sums of whole series, one warp per series; series k writes out[5k..5k+5).
+		template <class T>
+		__global__ void __launch_bounds__(block_threads)
+		series_sums_kernel(const T* __restrict__ x, const T* __restrict__ y, const std::size_t* __restrict__ offsets,
+			std::size_t first, std::size_t count, std::size_t base, double* __restrict__ out)
+		{
+			const int lane = threadIdx.x % warp_size;
+			const auto warps = static_cast<std::size_t>(blockDim.x) * gridDim.x / warp_size;
+			// k is the same for all lanes of a warp, so the shuffles see full warps
+			for (auto k = (static_cast<std::size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warp_size; k < count; k += warps) {
+				const auto begin = offsets[first + k] - base;
+				const auto end = offsets[first + k + 1] - base;
+				double s[sums] = {};
+				if (begin < end) {
+					const double x0 = x[begin], y0 = y[begin];
+					for (auto i = begin + lane; i < end; i += warp_size)
+						accumulate(s, x[i], y[i], x0, y0);
+				}
+				warp_reduce(s);
+				if (lane == 0) {
+					for (int j = 0; j < sums; ++j)
+						out[(first + k) * sums + j] = s[j];
+				}
+			}
+		}
+
+		/// CoMoments of n points from their sums shifted by (x0, y0), as in LinearRegression::detail::ShiftedSums.
+		[[nodiscard]] CoMoments<double> from_shifted(std::size_t n, double x0, double y0, const double* s) noexcept
+		{
+			if (n == 0)
+				return {};
+			const auto cnt = static_cast<double>(n);
+			const double mx = s[0] / cnt, my = s[1] / cnt;
+			return { n, x0 + mx, y0 + my,
+				std::max(s[2] - s[0] * mx, 0.0), std::max(s[3] - s[1] * my, 0.0), s[4] - s[0] * my };
+		}
+
+		/// Splits the batch into tasks of at most stage_elements points.
+		[[nodiscard]] std::vector<Task> plan(std::span<const std::size_t> offsets, std::size_t& chunks)
+		{
+			std::vector<Task> tasks;
+			chunks = 0;
+			const auto count = offsets.size() - 1;
+			for (std::size_t k = 0; k < count;) {
+				if (offsets[k + 1] - offsets[k] > long_series) {
+					for (auto begin = offsets[k]; begin < offsets[k + 1]; begin += stage_elements)
+						tasks.push_back({ k, 0, begin, std::min(stage_elements, offsets[k + 1] - begin), chunks++ });
+					++k;
+					continue;
+				}
+				auto last = k + 1;
+				while (last < count && offsets[last + 1] - offsets[last] <= long_series
+					&& offsets[last + 1] - offsets[k] <= stage_elements)
+					++last;
+				tasks.push_back({ k, last - k, offsets[k], offsets[last] - offsets[k], 0 });
+				k = last;
+			}
+			return tasks;
+		}
+
+		[[nodiscard]] unsigned grid_size(std::size_t threads, int multiprocessors) noexcept
+		{
+			const auto blocks = (threads + block_threads - 1) / block_threads;
+			return static_cast<unsigned>(std::clamp<std::size_t>(blocks, 1, static_cast<std::size_t>(multiprocessors) * 8));
+		}
+
+		template <class T>
+		void reduce_series(std::span<const T> x, std::span<const T> y, std::span<const std::size_t> offsets,
+			std::span<CoMoments<double>> out, int device)
+		{
+			if (out.empty())
+				return;
+			const DeviceGuard guard(device);
+			int multiprocessors = 0;
+			check(cudaDeviceGetAttribute(&multiprocessors, cudaDevAttrMultiProcessorCount, device), "cudaDeviceGetAttribute");
+
+			std::size_t chunks = 0;
+			const auto tasks = plan(offsets, chunks);
+			const auto count = out.size();
+
+			// Short series own sums [5k, 5k+5), chunk j of a long series [5(K+j), 5(K+j)+5)
+			auto d_sums = device_alloc<double>((count + chunks) * sums);
+			auto d_offsets = device_alloc<std::size_t>(offsets.size());
+			check(cudaMemset(d_sums.get(), 0, (count + chunks) * sums * sizeof(double)), "cudaMemset");
+			check(cudaMemcpy(d_offsets.get(), offsets.data(), offsets.size_bytes(), cudaMemcpyHostToDevice), "cudaMemcpy");
+			check(cudaDeviceSynchronize(), "cudaDeviceSynchronize");
+
+			{
+				const auto capacity = std::min(x.size(), stage_elements);
+				Source<T> sx(x, capacity), sy(y, capacity);
+				// Declared after the sources, so the streams are drained before the buffers go away
+				stream_ptr streams[slots] = { make_stream(), make_stream() };
+
+				for (std::size_t t = 0; t < tasks.size(); ++t) {
+					const auto& task = tasks[t];
+					const int slot = static_cast<int>(t % slots);
+					auto* stream = streams[slot].get();
+					const T* dx = sx.upload(slot, task.begin, task.len, stream);
+					const T* dy = sy.upload(slot, task.begin, task.len, stream);
+					if (task.count != 0) {
+						series_sums_kernel<T><<<grid_size(task.count * warp_size, multiprocessors), block_threads, 0, stream>>>(
+							dx, dy, d_offsets.get(), task.first, task.count, task.begin, d_sums.get());
+					}
+					else {
+						chunk_sums_kernel<T><<<grid_size(task.len, multiprocessors), block_threads, 0, stream>>>(
+							dx, dy, task.len, static_cast<double>(x[task.begin]), static_cast<double>(y[task.begin]),
+							d_sums.get() + (count + task.slot) * sums);
+					}
+					check(cudaGetLastError(), "kernel launch");
+				}
+				for (auto& stream : streams)
+					check(cudaStreamSynchronize(stream.get()), "cudaStreamSynchronize");
+			}
+
+			std::vector<double> host((count + chunks) * sums);
+			check(cudaMemcpy(host.data(), d_sums.get(), host.size() * sizeof(double), cudaMemcpyDeviceToHost), "cudaMemcpy");
+
+			for (std::size_t k = 0; k < count; ++k) {
+				const auto begin = offsets[k];
+				const auto len = offsets[k + 1] - begin;
+				out[k] = len == 0 ? CoMoments<double>{}
+					: from_shifted(len, x[begin], y[begin], host.data() + k * sums);
+			}
+			// Chunks of a long series overwrite its (unused) short-series slot, merged in order
+			std::size_t current = count;
+			for (const auto& task : tasks) {
+				if (task.count != 0)
+					continue;
+				if (task.first != current) {
+					current = task.first;
+					out[current] = {};
+				}
+				out[current].merge(from_shifted(task.len, x[task.begin], y[task.begin],
+					host.data() + (count + task.slot) * sums));
+			}
+		}
+
+		template <class T>
+		[[nodiscard]] CoMoments<double> reduce(std::span<const T> x, std::span<const T> y, int device)
+		{
+			if (x.size() != y.size())
+				throw std::invalid_argument("co_moments: vectors must have same size");
+			CoMoments<double> out{};
+			const std::size_t offsets[] = { 0, x.size() };
+			reduce_series(x, y, std::span<const std::size_t>(offsets), std::span<CoMoments<double>>(&out, 1), device);
+			return out;
+		}
+
+	} // namespace
+
+	bool available() noexcept
+	{
+		static const bool present = [] {
+			int count = 0;
+			const bool ok = cudaGetDeviceCount(&count) == cudaSuccess && count > 0;
+			static_cast<void>(cudaGetLastError());
+			return ok;
+		}();
+		return present;
+	}
+
+	CoMoments<double> co_moments(std::span<const float> x, std::span<const float> y, int device)
+	{
+		return reduce(x, y, device);
+	}
+
+	CoMoments<double> co_moments(std::span<const double> x, std::span<const double> y, int device)
+	{
+		return reduce(x, y, device);
+	}
+
+	void co_moments_batch(std::span<const float> x, std::span<const float> y,
+		std::span<const std::size_t> offsets, std::span<CoMoments<double>> out, int device)
+	{
+		detail::check_batch(x, y, offsets, out.size());
+		reduce_series(x, y, offsets, out, device);
+	}
+
+	void co_moments_batch(std::span<const double> x, std::span<const double> y,
+		std::span<const std::size_t> offsets, std::span<CoMoments<double>> out, int device)
+	{
+		detail::check_batch(x, y, offsets, out.size());
+		reduce_series(x, y, offsets, out, device);
+	}
+
+} // namespace Stats::gpu
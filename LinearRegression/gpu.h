@@ -0,0 +1,303 @@
+/**
+ * @file gpu.h
+ * @brief Optional CUDA backend for huge and batched fits
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Stats::exec::gpu is a policy for the reductions that dominate very large
+ * inputs: fit(), fit_fused(), fit_batch() and Stats::co_moments() accept it
+ * in place of the CPU policies. The device computes the co-moments; the fit
+ * itself follows on the host in closed form (fit_from_moments()).
+ *
+ * With LINREG_WITH_CUDA defined, the Stats::gpu functions are implemented in
+ * gpu.cu (link it into the program). The data stream through the device in
+ * chunks of a few MiB on two CUDA streams, so the host-to-device copy of one
+ * chunk overlaps the reduction of the previous one:
+ *
+ * - Large inputs are page-locked in place (cudaHostRegister) for the call,
+ *   so the copies run asynchronously straight from the caller's memory.
+ *   Otherwise the host copies each chunk into a pinned staging buffer first.
+ * - Long series are reduced by all thread blocks with the sums shifted by
+ *   the first point of the chunk; the chunk results are merged on the host
+ *   (CoMoments::merge()). Short series are packed into chunks whole and
+ *   reduced one warp per series.
+ * - The device always accumulates in double, for float and double data.
+ *
+ * Without LINREG_WITH_CUDA, or when no device is present, everything runs
+ * on the CPU under exec::automatic, so code written against exec::gpu
+ * builds and runs everywhere. Inputs below gpu_policy::threshold stay on
+ * the CPU too: for them the transfer costs more than the reduction.
+ *
+ * Sums of a chunk are combined with atomics, so the last bits can vary
+ * between runs as under exec::par. fit(x, y, exec::gpu) derives the SSE
+ * from the sums like fit_fused() (no second pass over the data).
+ *
+ * Example:
+ * @code
+ * // nvcc -std=c++20 -DLINREG_WITH_CUDA -c gpu.cu; c++ -std=c++20 -DLINREG_WITH_CUDA main.cpp gpu.o -lcudart
+ * auto r = LinearRegression::fit(x, y, Stats::exec::gpu);                        // billions of points
+ * auto rs = LinearRegression::fit_batch<float>(x, y, offsets, Stats::exec::gpu); // many series
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "batch.h"
+#include "execution.h"
+#include "instrumentation.h"
+#include "linreg.h"
+#include "span_compatible.h"
+#include "stats.h"
+
+namespace Stats {
+
+	namespace exec {
+
+		/// Default size (elements) from which exec::gpu offloads to the device.
+		inline constexpr std::size_t default_gpu_threshold = std::size_t{ 1 } << 22;
+
+		/**
+		 * @brief Offload the co-moment reduction to a CUDA device.
+		 *
+		 * Not an ExecutionPolicy: it selects the overloads in gpu.h, which fall
+		 * back to exec::automatic below the threshold or without a device.
+		 */
+		struct gpu_policy {
+			int device = 0;             ///< CUDA device ordinal
+			std::size_t threshold = 0;  ///< 0 selects default_gpu_threshold
+		};
+
+		inline constexpr gpu_policy gpu{};
+
+	} // namespace exec
+
+	namespace gpu {
+
+#if defined(LINREG_WITH_CUDA)
+		/// @brief Whether a CUDA device is present (checked once).
+		[[nodiscard]] bool available() noexcept;
+
+		/**
+		 * @brief Co-moments of a paired sample, reduced on the device.
+		 * @param device CUDA device ordinal
+		 * @throws std::invalid_argument if sizes differ
+		 * @throws std::runtime_error if a CUDA call fails
+		 */
+		[[nodiscard]] CoMoments<double> co_moments(std::span<const float> x, std::span<const float> y, int device = 0);
+		[[nodiscard]] CoMoments<double> co_moments(std::span<const double> x, std::span<const double> y, int device = 0);
+
+		/**
+		 * @brief Co-moments of every series of a concatenated buffer (layout of fit_batch()).
+		 * @param out Receives K = offsets.size() - 1 results
+		 * @throws std::invalid_argument if the buffer sizes or offsets are inconsistent
+		 * @throws std::runtime_error if a CUDA call fails
+		 */
+		void co_moments_batch(std::span<const float> x, std::span<const float> y,
+			std::span<const std::size_t> offsets, std::span<CoMoments<double>> out, int device = 0);
+		void co_moments_batch(std::span<const double> x, std::span<const double> y,
+			std::span<const std::size_t> offsets, std::span<CoMoments<double>> out, int device = 0);
+#endif
+
+		namespace detail {
+
+			/// Element types the device kernels are instantiated for.
+			template <class T>
+			inline constexpr bool device_type = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+			template <class T>
+			void check_batch(std::span<const T> x, std::span<const T> y,
+				std::span<const std::size_t> offsets, std::size_t count)
+			{
+				if (x.size() != y.size())
+					throw std::invalid_argument("fit_batch: x and y must have same size");
+				if (offsets.size() != count + 1 || offsets.back() != x.size())
+					throw std::invalid_argument("fit_batch: offsets must hold K+1 entries ending at x.size()");
+				if (!std::is_sorted(offsets.begin(), offsets.end()))
+					throw std::invalid_argument("fit_batch: offsets must be non-decreasing");
+			}
+
+			/// @brief Whether to run n elements on the device.
+			[[nodiscard]]
+			inline bool offload([[maybe_unused]] const exec::gpu_policy& policy, [[maybe_unused]] std::size_t n) noexcept
+			{
+#if defined(LINREG_WITH_CUDA)
+				return n >= (policy.threshold != 0 ? policy.threshold : exec::default_gpu_threshold) && available();
+#else
+				return false;
+#endif
+			}
+
+		} // namespace detail
+
+	} // namespace gpu
+
+	namespace detail {
+
+		template <std::floating_point To, std::floating_point From>
+		[[nodiscard]]
+		constexpr CoMoments<To> moments_cast(const CoMoments<From>& m) noexcept
+		{
+			return { m.n, static_cast<To>(m.mean_x), static_cast<To>(m.mean_y),
+				static_cast<To>(m.sxx), static_cast<To>(m.syy), static_cast<To>(m.sxy) };
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief co_moments() on the device (see file comment).
+	 * @tparam Acc Result type; the device accumulates in double.
+	 * @throws std::invalid_argument if sizes differ
+	 * @throws std::runtime_error if a CUDA call fails
+	 */
+	template <std::floating_point T, std::floating_point Acc = T>
+	[[nodiscard]]
+	CoMoments<Acc> co_moments(std::span<const T> x, std::span<const T> y, [[maybe_unused]] const exec::gpu_policy& policy)
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("co_moments: vectors must have same size");
+#if defined(LINREG_WITH_CUDA)
+		if constexpr (gpu::detail::device_type<T>) {
+			if (gpu::detail::offload(policy, x.size()))
+				return detail::moments_cast<Acc>(gpu::co_moments(x, y, policy.device));
+		}
+#endif
+		return co_moments<T, Acc>(x, y, exec::automatic);
+	}
+
+	/// @brief Convenience overload: accepts any SpanCompatible container.
+	template <Helper::SpanCompatible C>
+	[[nodiscard]]
+	auto co_moments(const C& x, const C& y, const exec::gpu_policy& policy)
+	{
+		return co_moments(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+} // namespace Stats
+
+namespace LinearRegression {
+
+	/**
+	 * @brief fit() with the co-moments reduced on the device
+	 * @tparam Acc Type of the result (default: T)
+	 * @return FitResult<Acc>, as fit_from_moments() of the device co-moments
+	 *
+	 * @note Returns empty FitResult under the same conditions as fit().
+	 */
+	template <typename T, typename Acc = T>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	FitResult<Acc> fit(std::span<const T> x, std::span<const T> y, const Stats::exec::gpu_policy& policy)
+	{
+		LINREG_STAGE(fit, 2 * x.size() * sizeof(T));
+		if (x.size() != y.size() || x.size() < 3) {
+			return {};
+		}
+		return fit_from_moments(Stats::co_moments<T, Acc>(x, y, policy));
+	}
+
+	/// @brief Container overload for the device fit
+	template <Helper::SpanCompatible C>
+	[[nodiscard]]
+	FitResult<typename C::value_type> fit(const C& x, const C& y, const Stats::exec::gpu_policy& policy)
+	{
+		return fit(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	/// @brief fit_fused() with the co-moments reduced on the device; same as fit(x, y, exec::gpu).
+	template <typename T, typename Acc = T>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	FitResult<Acc> fit_fused(std::span<const T> x, std::span<const T> y, const Stats::exec::gpu_policy& policy)
+	{
+		return fit<T, Acc>(x, y, policy);
+	}
+
+	/// @brief Container overload for the device fit_fused
+	template <Helper::SpanCompatible C>
+	[[nodiscard]]
+	FitResult<typename C::value_type> fit_fused(const C& x, const C& y, const Stats::exec::gpu_policy& policy)
+	{
+		return fit_fused(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	/**
+	 * @brief fit_batch() with all series reduced on the device in one pipeline
+	 * @throws std::invalid_argument if the buffer sizes or offsets are inconsistent
+	 * @throws std::runtime_error if a CUDA call fails
+	 *
+	 * The policy threshold applies to the batch as a whole.
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	void fit_batch(std::span<const T> x, std::span<const T> y,
+		std::span<const std::size_t> offsets, std::span<FitResult<T>> out, const Stats::exec::gpu_policy& policy)
+	{
+		Stats::gpu::detail::check_batch(x, y, offsets, out.size());
+#if defined(LINREG_WITH_CUDA)
+		if constexpr (Stats::gpu::detail::device_type<T>) {
+			if (Stats::gpu::detail::offload(policy, x.size())) {
+				std::vector<Stats::CoMoments<double>> moments(out.size());
+				Stats::gpu::co_moments_batch(x, y, offsets, moments, policy.device);
+				for (std::size_t k = 0; k < out.size(); ++k)
+					out[k] = fit_from_moments(Stats::detail::moments_cast<T>(moments[k]));
+				return;
+			}
+		}
+#endif
+		(void)policy;
+		fit_batch(x, y, offsets, out, Stats::exec::automatic);
+	}
+
+	/// @brief Device fit_batch() returning a new vector of K results.
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::vector<FitResult<T>> fit_batch(std::span<const T> x, std::span<const T> y,
+		std::span<const std::size_t> offsets, const Stats::exec::gpu_policy& policy)
+	{
+		if (offsets.empty())
+			throw std::invalid_argument("fit_batch: offsets must hold K+1 entries ending at x.size()");
+		std::vector<FitResult<T>> out(offsets.size() - 1);
+		fit_batch(x, y, offsets, std::span<FitResult<T>>(out), policy);
+		return out;
+	}
+
+	/// @brief Device fit_batch() over the rows of a row-major K × length matrix.
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	void fit_batch(std::span<const T> x, std::span<const T> y,
+		std::size_t length, std::span<FitResult<T>> out, const Stats::exec::gpu_policy& policy)
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("fit_batch: x and y must have same size");
+		if (length == 0 || x.size() != out.size() * length)
+			throw std::invalid_argument("fit_batch: matrix size must equal K * length");
+
+		std::vector<std::size_t> offsets(out.size() + 1);
+		for (std::size_t k = 0; k < offsets.size(); ++k)
+			offsets[k] = k * length;
+		fit_batch(x, y, std::span<const std::size_t>(offsets), out, policy);
+	}
+
+	/// @brief Row-major device fit_batch() returning a new vector of K results.
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::vector<FitResult<T>> fit_batch(std::span<const T> x, std::span<const T> y, std::size_t length,
+		const Stats::exec::gpu_policy& policy)
+	{
+		if (length == 0)
+			throw std::invalid_argument("fit_batch: matrix size must equal K * length");
+		std::vector<FitResult<T>> out(x.size() / length);
+		fit_batch(x, y, length, std::span<FitResult<T>>(out), policy);
+		return out;
+	}
+
+} // namespace LinearRegression
@@ -0,0 +1,261 @@
+/**
+ * @file grouped.h
+ * @brief Group-by regression: one fit per key in a single pass over unsorted rows
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * fit_grouped(keys, x, y) fits y ~ x separately for every distinct key of a
+ * table given column-wise, e.g. (device_id, t, value), without sorting or
+ * partitioning the rows first:
+ *
+ * - Each worker scans a contiguous range of rows and accumulates into its
+ *   own open-addressing hash table (linear probing, power-of-two capacity,
+ *   at most half full). Probing touches only compact {key, index} slots;
+ *   the accumulators live in a dense array in order of first appearance.
+ * - The accumulator of a group is shifted around its first point (x₀, y₀),
+ *   Σ(x - x₀), Σ(x - x₀)², ..., so the update per row is a handful of adds
+ *   and multiplies with no division, and large offsets such as Unix time
+ *   stamps do not cancel.
+ * - At the end the per-worker tables are converted to Stats::CoMoments and
+ *   merged into the table of the first worker, in range order.
+ *
+ * Results are returned in order of the first appearance of each key. Under
+ * exec::deterministic the rows are split into a fixed number of ranges, so
+ * the results do not depend on the thread count.
+ *
+ * Example:
+ * @code
+ * std::vector<std::uint32_t> device = ...;
+ * std::vector<double> t = ..., value = ...;
+ * for (const auto& g : LinearRegression::fit_grouped(device, t, value))
+ *     std::cout << g.key << ": slope " << g.fit.beta1 << '\n';
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "execution.h"
+#include "linreg.h"
+#include "random.h"
+#include "span_compatible.h"
+#include "stats.h"
+
+namespace LinearRegression {
+
+	/// @brief Fit of one group returned by fit_grouped().
+	template <class Key, class T>
+	struct GroupFit {
+		Key key;          ///< Group key
+		FitResult<T> fit; ///< Empty FitResult if the group has < 3 points or Sxx = 0
+	};
+
+	namespace detail {
+
+		/// Row ranges of exec::deterministic (independent of the thread count).
+		inline constexpr std::size_t grouped_deterministic_ranges = 64;
+
+		/// @brief Co-moment sums shifted by the first point of the group.
+		template <class Acc>
+		struct ShiftedSums {
+			std::size_t n = 0;
+			Acc x0{}, y0{};                ///< First point
+			Acc sx{}, sy{};                ///< Σdx, Σdy
+			Acc sxx{}, syy{}, sxy{};       ///< Σdx², Σdy², Σdx·dy
+
+			void push(Acc x, Acc y) noexcept
+			{
+				if (n++ == 0) {
+					x0 = x;
+					y0 = y;
+					return;
+				}
+				const Acc dx = x - x0;
+				const Acc dy = y - y0;
+				sx += dx;
+				sy += dy;
+				sxx += dx * dx;
+				syy += dy * dy;
+				sxy += dx * dy;
+			}
+
+			[[nodiscard]] Stats::CoMoments<Acc> moments() const noexcept
+			{
+				const auto cnt = static_cast<Acc>(n);
+				const Acc mx = sx / cnt, my = sy / cnt;
+				return { n, x0 + mx, y0 + my,
+					std::max(sxx - sx * mx, Acc{ 0 }), std::max(syy - sy * my, Acc{ 0 }), sxy - sx * my };
+			}
+		};
+
+		/**
+		 * @brief Open-addressing hash map from integral keys to dense values.
+		 *
+		 * Linear probing over {key, index} slots; index 0 marks an empty slot,
+		 * otherwise it is one past the position of the value in values().
+		 */
+		template <std::integral Key, class V>
+		class GroupTable {
+		public:
+			GroupTable() : slots_(initial_slots) {}
+
+			/// @brief Value of key, default-constructed on first use.
+			[[nodiscard]] V& operator[](Key key)
+			{
+				auto mask = slots_.size() - 1;
+				auto i = hash(key) & mask;
+				while (slots_[i].index != 0) {
+					if (slots_[i].key == key)
+						return values_[slots_[i].index - 1];
+					i = (i + 1) & mask;
+				}
+				// Keep the load factor at or below 1/2, so probe sequences stay short
+				if (2 * (values_.size() + 1) > slots_.size()) {
+					grow();
+					mask = slots_.size() - 1;
+					i = hash(key) & mask;
+					while (slots_[i].index != 0)
+						i = (i + 1) & mask;
+				}
+				keys_.push_back(key);
+				values_.emplace_back();
+				slots_[i] = { key, values_.size() };
+				return values_.back();
+			}
+
+			[[nodiscard]] std::span<const Key> keys() const noexcept { return keys_; }
+			[[nodiscard]] std::span<V> values() noexcept { return values_; }
+			[[nodiscard]] std::span<const V> values() const noexcept { return values_; }
+
+			/// @brief Frees all memory without allocating; the table must not be used afterwards.
+			void release() noexcept
+			{
+				std::vector<Slot>().swap(slots_);
+				std::vector<Key>().swap(keys_);
+				std::vector<V>().swap(values_);
+			}
+
+		private:
+			static constexpr std::size_t initial_slots = 1024;
+
+			struct Slot {
+				Key key{};
+				std::size_t index = 0;
+			};
+
+			[[nodiscard]] static std::size_t hash(Key key) noexcept
+			{
+				return static_cast<std::size_t>(Stats::detail::splitmix64(static_cast<std::uint64_t>(key)));
+			}
+
+			void grow()
+			{
+				std::vector<Slot> slots(2 * slots_.size());
+				const auto mask = slots.size() - 1;
+				for (std::size_t g = 0; g < keys_.size(); ++g) {
+					auto i = hash(keys_[g]) & mask;
+					while (slots[i].index != 0)
+						i = (i + 1) & mask;
+					slots[i] = { keys_[g], g + 1 };
+				}
+				slots_ = std::move(slots);
+			}
+
+			std::vector<Slot> slots_;
+			std::vector<Key> keys_;
+			std::vector<V> values_;
+		};
+
+		/// @brief Number of row ranges (one hash table each) for n rows.
+		template <Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		std::size_t grouped_ranges(const Policy& policy, std::size_t n) noexcept
+		{
+			const auto chunks = std::max<std::size_t>(1, (n + Stats::detail::par_chunk - 1) / Stats::detail::par_chunk);
+			if constexpr (std::same_as<Policy, Stats::exec::deterministic_policy>)
+				return std::min(chunks, grouped_deterministic_ranges);
+			if (!policy.parallel(n))
+				return 1;
+			return std::min<std::size_t>(chunks, std::max(1u, std::thread::hardware_concurrency()));
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Fits a line per distinct key in one pass over unsorted rows
+	 * @tparam Key Integral key type (e.g. a device id)
+	 * @tparam T Numeric type of x and y
+	 * @tparam Acc Accumulator type of the sums and of the results (default: T)
+	 * @param keys Group key of every row
+	 * @param x Independent variable of every row
+	 * @param y Dependent variable of every row
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @return One GroupFit per distinct key, in order of first appearance
+	 * @throws std::invalid_argument if keys, x and y differ in size
+	 *
+	 * Each group is fitted from its co-moments, as by fit_from_moments(); a
+	 * group with fewer than 3 rows or constant x yields an empty FitResult.
+	 * No copy of the rows is made; memory is O(groups × workers).
+	 */
+	template <std::integral Key, typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	std::vector<GroupFit<Key, Acc>> fit_grouped(std::span<const Key> keys, std::span<const T> x, std::span<const T> y,
+		const Policy& policy = {})
+	{
+		if (keys.size() != x.size() || x.size() != y.size())
+			throw std::invalid_argument("fit_grouped: keys, x and y must have same size");
+
+		const auto n = x.size();
+		const auto ranges = detail::grouped_ranges(policy, n);
+		std::vector<detail::GroupTable<Key, detail::ShiftedSums<Acc>>> tables(ranges);
+
+		Stats::detail::bulk(policy, n, ranges, [&](std::size_t r) {
+			const auto begin = n * r / ranges;
+			const auto end = n * (r + 1) / ranges;
+			auto& table = tables[r];
+			for (std::size_t i = begin; i < end; ++i)
+				table[keys[i]].push(static_cast<Acc>(x[i]), static_cast<Acc>(y[i]));
+		});
+
+		// Merge in range order, so keys keep the order of their first appearance
+		detail::GroupTable<Key, Stats::CoMoments<Acc>> merged;
+		for (auto& table : tables) {
+			const auto table_keys = table.keys();
+			const auto sums = table.values();
+			for (std::size_t g = 0; g < table_keys.size(); ++g)
+				merged[table_keys[g]].merge(sums[g].moments());
+			table.release();  // free the memory early
+		}
+
+		const auto merged_keys = merged.keys();
+		const auto moments = std::as_const(merged).values();
+		std::vector<GroupFit<Key, Acc>> out(merged_keys.size());
+		Stats::detail::bulk(policy, n, out.size(), [&](std::size_t g) {
+			out[g] = { merged_keys[g], fit_from_moments(moments[g]) };
+		});
+		return out;
+	}
+
+	/// @brief Container overload for fit_grouped function
+	template <std::ranges::contiguous_range K, Helper::SpanCompatible C,
+		Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::integral<std::ranges::range_value_t<K>>
+	[[nodiscard]]
+	auto fit_grouped(const K& keys, const C& x, const C& y, const Policy& policy = {})
+	{
+		const std::span<const std::ranges::range_value_t<K>> key_span(std::ranges::data(keys), std::ranges::size(keys));
+		return fit_grouped(key_span, Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+} // namespace LinearRegression
@@ -0,0 +1,352 @@
+/**
+ * @file instrumentation.h
+ * @brief Optional per-stage counters for the hot paths of fit() and the reductions
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Compiled in only with LINREG_INSTRUMENTATION defined. Without it the hooks
+ * in the library (LINREG_STAGE, LINREG_STAGE_POLICY, LINREG_COUNT_ALLOCATION)
+ * expand to nothing, snapshot() returns zeros and no callback is invoked.
+ *
+ * Instrumented stages: fit, shift, inner_product (also inner_products()),
+ * ci_slope and t_quantile (the lookup of t_quantile_cached()). For every stage
+ * the process-wide counters record
+ * - calls, total and maximum wall time
+ * - bytes the stage reads and writes (a model of the passes, not measured)
+ * - heap allocations on the calling thread at the instrumented sites (arena
+ *   overflow and growth, quantile memo insertion, the vector returned by
+ *   shift()); other allocations are not counted
+ * - the execution path: calling thread, std::execution::par or a caller pool,
+ *   and the SIMD instruction set that was active
+ *
+ * Stages nest: the time, bytes and allocations of fit() include those of the
+ * shift() and inner_products() calls it makes.
+ *
+ * Export:
+ * - snapshot(): copy of all counters; Snapshot::prometheus() renders them in
+ *   the Prometheus text exposition format
+ * - set_callback(): a function called with an Event after every stage
+ *
+ * Example:
+ * @code
+ * // compile with -DLINREG_INSTRUMENTATION
+ * Stats::instrumentation::set_callback([](const Stats::instrumentation::Event& e) {
+ *     if (e.ns > 1'000'000) log_slow(e);
+ * });
+ * ...
+ * std::cout << Stats::instrumentation::snapshot().prometheus();
+ * @endcode
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "execution.h"
+#include "simd_kernels.h"
+
+namespace Stats::instrumentation {
+
+	/// @brief True if the library was compiled with LINREG_INSTRUMENTATION.
+#if defined(LINREG_INSTRUMENTATION)
+	inline constexpr bool enabled = true;
+#else
+	inline constexpr bool enabled = false;
+#endif
+
+	/// @brief Instrumented stage.
+	enum class Stage {
+		fit,
+		shift,
+		inner_product,
+		ci_slope,
+		t_quantile
+	};
+	inline constexpr std::size_t stage_count = 5;
+
+	/// @brief Where the parallel work of a stage ran.
+	enum class Path {
+		seq,   ///< Calling thread
+		par,   ///< std::execution::par
+		pool   ///< Caller-supplied pool (exec::on)
+	};
+	inline constexpr std::size_t path_count = 3;
+	inline constexpr std::size_t isa_count = 4;
+
+	/// @brief Printable name of a stage.
+	[[nodiscard]]
+	constexpr const char* stage_name(Stage stage) noexcept
+	{
+		switch (stage) {
+		case Stage::fit:           return "fit";
+		case Stage::shift:         return "shift";
+		case Stage::inner_product: return "inner_product";
+		case Stage::ci_slope:      return "ci_slope";
+		default:                   return "t_quantile";
+		}
+	}
+
+	/// @brief Printable name of an execution path.
+	[[nodiscard]]
+	constexpr const char* path_name(Path path) noexcept
+	{
+		switch (path) {
+		case Path::par:  return "par";
+		case Path::pool: return "pool";
+		default:         return "seq";
+		}
+	}
+
+	/// @brief One completed stage, as passed to the callback.
+	struct Event {
+		Stage stage;
+		Path path;
+		simd::Isa isa;              ///< Instruction set active during the stage
+		std::uint64_t ns;           ///< Wall time
+		std::uint64_t bytes;        ///< Bytes read and written
+		std::uint64_t allocations;  ///< Heap allocations on the calling thread
+	};
+
+	/// @brief Accumulated counters of one stage.
+	struct StageCounters {
+		std::uint64_t calls{};
+		std::uint64_t ns_total{};
+		std::uint64_t ns_max{};
+		std::uint64_t bytes{};
+		std::uint64_t allocations{};
+		std::array<std::uint64_t, path_count> path_calls{};  ///< Indexed by Path
+		std::array<std::uint64_t, isa_count> isa_calls{};    ///< Indexed by simd::Isa
+	};
+
+	/// @brief Copy of all counters at one point in time.
+	struct Snapshot {
+		std::array<StageCounters, stage_count> stages{};
+
+		[[nodiscard]] const StageCounters& operator[](Stage stage) const noexcept
+		{
+			return stages[static_cast<std::size_t>(stage)];
+		}
+
+		/// @brief Counters in the Prometheus text exposition format.
+		[[nodiscard]] std::string prometheus() const
+		{
+			std::string out;
+			auto metric = [&](const char* name, const char* type, const char* help, auto value_of) {
+				out += std::string("# HELP ") + name + " " + help + "\n# TYPE " + name + " " + type + "\n";
+				for (std::size_t s = 0; s < stage_count; ++s) {
+					out += std::string(name) + "{stage=\"" + stage_name(static_cast<Stage>(s)) + "\"} "
+						+ value_of(stages[s]) + "\n";
+				}
+			};
+			auto integer = [](std::uint64_t v) { return std::to_string(v); };
+			auto seconds = [](std::uint64_t ns) {
+				// Exact decimal seconds with nanosecond resolution
+				auto frac = std::to_string(ns % 1'000'000'000);
+				return std::to_string(ns / 1'000'000'000) + "." + std::string(9 - frac.size(), '0') + frac;
+			};
+
+			metric("linreg_stage_calls_total", "counter", "Completed calls of the stage.",
+				[&](const StageCounters& c) { return integer(c.calls); });
+			metric("linreg_stage_seconds_total", "counter", "Wall time spent in the stage.",
+				[&](const StageCounters& c) { return seconds(c.ns_total); });
+			metric("linreg_stage_seconds_max", "gauge", "Longest single call of the stage.",
+				[&](const StageCounters& c) { return seconds(c.ns_max); });
+			metric("linreg_stage_bytes_total", "counter", "Bytes read and written by the stage.",
+				[&](const StageCounters& c) { return integer(c.bytes); });
+			metric("linreg_stage_allocations_total", "counter", "Heap allocations during the stage.",
+				[&](const StageCounters& c) { return integer(c.allocations); });
+
+			out += "# HELP linreg_stage_path_calls_total Calls of the stage by execution path.\n"
+				"# TYPE linreg_stage_path_calls_total counter\n";
+			for (std::size_t s = 0; s < stage_count; ++s) {
+				for (std::size_t p = 0; p < path_count; ++p) {
+					out += std::string("linreg_stage_path_calls_total{stage=\"") + stage_name(static_cast<Stage>(s))
+						+ "\",path=\"" + path_name(static_cast<Path>(p)) + "\"} "
+						+ integer(stages[s].path_calls[p]) + "\n";
+				}
+			}
+			out += "# HELP linreg_stage_isa_calls_total Calls of the stage by SIMD instruction set.\n"
+				"# TYPE linreg_stage_isa_calls_total counter\n";
+			for (std::size_t s = 0; s < stage_count; ++s) {
+				for (std::size_t i = 0; i < isa_count; ++i) {
+					out += std::string("linreg_stage_isa_calls_total{stage=\"") + stage_name(static_cast<Stage>(s))
+						+ "\",isa=\"" + simd::isa_name(static_cast<simd::Isa>(i)) + "\"} "
+						+ integer(stages[s].isa_calls[i]) + "\n";
+				}
+			}
+			return out;
+		}
+	};
+
+	/// @brief Receives every completed stage; must not throw.
+	using Callback = void (*)(const Event&);
+
+	namespace detail {
+
+		// Counters of one stage on a cache line of their own, so concurrent
+		// stages do not contend
+		struct alignas(64) AtomicCounters {
+			std::atomic<std::uint64_t> calls{ 0 };
+			std::atomic<std::uint64_t> ns_total{ 0 };
+			std::atomic<std::uint64_t> ns_max{ 0 };
+			std::atomic<std::uint64_t> bytes{ 0 };
+			std::atomic<std::uint64_t> allocations{ 0 };
+			std::array<std::atomic<std::uint64_t>, path_count> path_calls{};
+			std::array<std::atomic<std::uint64_t>, isa_count> isa_calls{};
+		};
+
+		[[nodiscard]]
+		inline std::array<AtomicCounters, stage_count>& registry() noexcept
+		{
+			static std::array<AtomicCounters, stage_count> counters;
+			return counters;
+		}
+
+		[[nodiscard]]
+		inline std::atomic<Callback>& callback_state() noexcept
+		{
+			static std::atomic<Callback> callback{ nullptr };
+			return callback;
+		}
+
+		/// Heap allocations made by the calling thread so far.
+		[[nodiscard]]
+		inline std::uint64_t& thread_allocations() noexcept
+		{
+			thread_local std::uint64_t count = 0;
+			return count;
+		}
+
+		inline void count_allocation() noexcept { ++thread_allocations(); }
+
+		/// Path the parallel helpers of execution.h take for n elements.
+		template <ExecutionPolicy Policy>
+		[[nodiscard]]
+		Path path_of(const Policy& policy, std::size_t n) noexcept
+		{
+			if (n <= Stats::detail::par_chunk || !policy.parallel(n))
+				return Path::seq;
+			return exec::is_pool_policy<Policy> ? Path::pool : Path::par;
+		}
+
+		inline void record(const Event& e) noexcept
+		{
+			auto& c = registry()[static_cast<std::size_t>(e.stage)];
+			c.calls.fetch_add(1, std::memory_order_relaxed);
+			c.ns_total.fetch_add(e.ns, std::memory_order_relaxed);
+			c.bytes.fetch_add(e.bytes, std::memory_order_relaxed);
+			c.allocations.fetch_add(e.allocations, std::memory_order_relaxed);
+			c.path_calls[static_cast<std::size_t>(e.path)].fetch_add(1, std::memory_order_relaxed);
+			c.isa_calls[static_cast<std::size_t>(e.isa)].fetch_add(1, std::memory_order_relaxed);
+			auto max = c.ns_max.load(std::memory_order_relaxed);
+			while (max < e.ns && !c.ns_max.compare_exchange_weak(max, e.ns, std::memory_order_relaxed)) {
+			}
+			if (const auto cb = callback_state().load(std::memory_order_acquire))
+				cb(e);
+		}
+
+		/// Times the enclosing scope as one call of a stage.
+		class ScopedStage {
+		public:
+			ScopedStage(Stage stage, Path path, std::uint64_t bytes) noexcept
+				: stage_(stage), path_(path), bytes_(bytes),
+				allocations_(thread_allocations()), start_(std::chrono::steady_clock::now())
+			{
+			}
+
+			ScopedStage(const ScopedStage&) = delete;
+			ScopedStage& operator=(const ScopedStage&) = delete;
+
+			~ScopedStage()
+			{
+				const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_).count();
+				record({ stage_, path_, simd::active_isa(), static_cast<std::uint64_t>(ns), bytes_,
+					thread_allocations() - allocations_ });
+			}
+
+		private:
+			Stage stage_;
+			Path path_;
+			std::uint64_t bytes_;
+			std::uint64_t allocations_;
+			std::chrono::steady_clock::time_point start_;
+		};
+
+	} // namespace detail
+
+	/// @brief Copy of the current counters (all zero without LINREG_INSTRUMENTATION).
+	[[nodiscard]]
+	inline Snapshot snapshot() noexcept
+	{
+		Snapshot s;
+		for (std::size_t i = 0; i < stage_count; ++i) {
+			const auto& c = detail::registry()[i];
+			auto& out = s.stages[i];
+			out.calls = c.calls.load(std::memory_order_relaxed);
+			out.ns_total = c.ns_total.load(std::memory_order_relaxed);
+			out.ns_max = c.ns_max.load(std::memory_order_relaxed);
+			out.bytes = c.bytes.load(std::memory_order_relaxed);
+			out.allocations = c.allocations.load(std::memory_order_relaxed);
+			for (std::size_t p = 0; p < path_count; ++p)
+				out.path_calls[p] = c.path_calls[p].load(std::memory_order_relaxed);
+			for (std::size_t a = 0; a < isa_count; ++a)
+				out.isa_calls[a] = c.isa_calls[a].load(std::memory_order_relaxed);
+		}
+		return s;
+	}
+
+	/// @brief Sets every counter to zero; stages running concurrently may be partly counted.
+	inline void reset() noexcept
+	{
+		for (auto& c : detail::registry()) {
+			c.calls.store(0, std::memory_order_relaxed);
+			c.ns_total.store(0, std::memory_order_relaxed);
+			c.ns_max.store(0, std::memory_order_relaxed);
+			c.bytes.store(0, std::memory_order_relaxed);
+			c.allocations.store(0, std::memory_order_relaxed);
+			for (auto& p : c.path_calls)
+				p.store(0, std::memory_order_relaxed);
+			for (auto& a : c.isa_calls)
+				a.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @brief Installs the function called after every stage (nullptr removes it).
+	 *
+	 * The callback runs on the thread that executed the stage, inside the
+	 * library call, so it should be short and must not throw.
+	 * @return The previous callback.
+	 */
+	inline Callback set_callback(Callback callback) noexcept
+	{
+		return detail::callback_state().exchange(callback, std::memory_order_acq_rel);
+	}
+
+} // namespace Stats::instrumentation
+
+#define LINREG_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define LINREG_INSTRUMENTATION_NAME_(line) LINREG_INSTRUMENTATION_CONCAT_(linreg_stage_, line)
+
+#if defined(LINREG_INSTRUMENTATION)
+/// Times the rest of the enclosing scope as a stage on the calling thread.
+#define LINREG_STAGE(stage, bytes)                                                    \
+	const ::Stats::instrumentation::detail::ScopedStage LINREG_INSTRUMENTATION_NAME_(__LINE__){ \
+		::Stats::instrumentation::Stage::stage, ::Stats::instrumentation::Path::seq,  \
+		static_cast<std::uint64_t>(bytes) }
+/// Times the rest of the enclosing scope as a stage over n elements run with policy.
+#define LINREG_STAGE_POLICY(stage, bytes, policy, n)                                  \
+	const ::Stats::instrumentation::detail::ScopedStage LINREG_INSTRUMENTATION_NAME_(__LINE__){ \
+		::Stats::instrumentation::Stage::stage,                                       \
+		::Stats::instrumentation::detail::path_of(policy, n),                         \
+		static_cast<std::uint64_t>(bytes) }
+/// Counts one heap allocation of the calling thread.
+#define LINREG_COUNT_ALLOCATION() ::Stats::instrumentation::detail::count_allocation()
+#else
+#define LINREG_STAGE(stage, bytes) static_cast<void>(0)
+#define LINREG_STAGE_POLICY(stage, bytes, policy, n) static_cast<void>(0)
+#define LINREG_COUNT_ALLOCATION() static_cast<void>(0)
+#endif
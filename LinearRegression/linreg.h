@@ -17,9 +17,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
 #include <utility>
 #include <cmath>
 #include <boost/math/distributions/students_t.hpp>
+#include "arena.h"
+#include "instrumentation.h"
+#include "quantile_cache.h"
 #include "span_compatible.h"
 #include "stats.h"
 
@@ -43,14 +51,102 @@ namespace LinearRegression {
 		T sxy;          ///< Sum of products of deviations: Σ(xᵢ - x̄)(yᵢ - ȳ)
 		T sse;          ///< Sum of squared errors (residuals): Σ(yᵢ - ŷᵢ)²
 		std::size_t n;  ///< Number of data points used in the fit
+		T mean_x;       ///< Mean of x (x̄): needed for intercept and prediction intervals
+		T mean_y;       ///< Mean of y (ȳ)
 	};
 
+	namespace detail {
+
+		/**
+		 * @brief Everything of fit() except the SSE pass (sse = 0)
+		 *
+		 * Expects x.size() == y.size() >= 3; returns an empty FitResult if Sxx = 0.
+		 * The final pass over the residuals is left to the caller, so variants
+		 * that compute more per residual (see diagnostics.h) share this part.
+		 */
+		template <typename T, typename Acc, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		FitResult<Acc> centered_fit(std::span<const T> x, std::span<const T> y, const Policy& policy)
+		{
+			// Center both variables around their means for numerical stability
+			// This prevents potential overflow/underflow with very large values
+			// The centered copies live in the per-thread scratch arena (see arena.h),
+			// so concurrent fits do not contend on the global allocator
+			Stats::ScratchScope scratch;
+			auto x0 = Stats::shift<T, Acc>(x, scratch.resource(), policy);  // x0[i] = x[i] - mean(x)
+			auto y0 = Stats::shift<T, Acc>(y, scratch.resource(), policy);  // y0[i] = y[i] - mean(y)
+
+			// Initialize result structure
+			auto fitResult = FitResult<Acc>{};
+			fitResult.n = x.size();
+
+			// Sums of squares and cross-products in one fused pass:
+			// Sxx = Σ(xᵢ - x̄)² measures spread/variance of x
+			// Syy = Σ(yᵢ - ȳ)² measures spread/variance of y
+			// Sxy = Σ(xᵢ - x̄)(yᵢ - ȳ) measures covariance between x and y
+			const auto sums = Stats::inner_products<T, Acc>(std::span<const T>(x0), std::span<const T>(y0), policy);
+			fitResult.sxx = sums.xx;
+			fitResult.syy = sums.yy;
+			fitResult.sxy = sums.xy;
+
+			// Check for degenerate case: all x values are identical
+			// If Sxx = 0, slope is undefined (division by zero)
+			if (fitResult.sxx == 0.0) {
+				return {}; // Cannot fit a line when x doesn't vary
+			}
+
+			// Calculate slope coefficient using least squares formula
+			// β₁ = Sxy / Sxx
+			// This gives the change in y per unit change in x
+			fitResult.beta1 = fitResult.sxy / fitResult.sxx;
+
+			// Calculate intercept using the formula: β₀ = ȳ - β₁x̄
+			// The regression line always passes through the point (x̄, ȳ)
+			fitResult.mean_x = Stats::mean<T, Acc>(x, policy);
+			fitResult.mean_y = Stats::mean<T, Acc>(y, policy);
+			fitResult.beta0 = fitResult.mean_y - fitResult.beta1 * fitResult.mean_x;
+
+			// Calculate Pearson correlation coefficient
+			// ρ = Sxy / √(Sxx × Syy)
+			// Range: -1 (perfect negative) to +1 (perfect positive)
+			// 0 indicates no linear relationship
+			fitResult.rho = fitResult.sxy / std::sqrt(fitResult.sxx * fitResult.syy);
+
+			return fitResult;
+		}
+
+		/// @brief Explicit SSE = Σ(yᵢ - β₀ - β₁xᵢ)² in one pass over x and y.
+		template <typename T, typename Acc, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		Acc residual_sum_of_squares(const FitResult<Acc>& fitResult, std::span<const T> x, std::span<const T> y,
+			const Policy& policy)
+		{
+			return Stats::detail::chunked_reduce(policy, x.size(), Acc{},
+				[&fitResult, px = x.data(), py = y.data()](std::size_t begin, std::size_t len) {
+					Acc acc{};
+					for (std::size_t i = begin; i < begin + len; ++i) {
+						// For each data point, calculate predicted value
+						const Acc yi_pred = fitResult.beta0 + fitResult.beta1 * static_cast<Acc>(px[i]);
+						// Calculate residual (error)
+						const Acc diff = static_cast<Acc>(py[i]) - yi_pred;
+						// Accumulate squared error
+						acc += diff * diff;
+					}
+					return acc;
+				}
+			);
+		}
+
+	} // namespace detail
+
 	/**
 	 * @brief Fits a linear regression model to data using least squares
 	 * @tparam T Numeric type (must be arithmetic, typically float or double)
+	 * @tparam Acc Accumulator type of all reductions and of the result (default: T)
 	 * @param x Independent variable values (features)
 	 * @param y Dependent variable values (targets)
-	 * @return FitResult<T> containing all regression statistics
+	 * @param policy Execution policy for the reductions (default: Stats::exec::automatic)
+	 * @return FitResult<Acc> containing all regression statistics
 	 *
 	 * This function implements the least squares method to find the best-fitting
 	 * linear relationship y = β₀ + β₁x between the variables.
@@ -63,6 +159,10 @@ namespace LinearRegression {
 	 * 5. Calculate correlation: ρ = Sxy / √(Sxx × Syy)
 	 * 6. Compute sum of squared errors (SSE) for model quality assessment
 	 *
+	 * Mixed precision: with T = float and Acc = double the data are read at
+	 * float bandwidth, while means, sums of squares and SSE are accumulated
+	 * in double (see Stats::simd). The centered copies are stored as T.
+	 *
 	 * @note Returns empty FitResult if:
 	 *       - x and y have different sizes
 	 *       - Fewer than 3 data points provided
@@ -74,78 +174,39 @@ namespace LinearRegression {
 	 * std::vector<double> y = {2.1, 3.9, 6.2, 7.8, 10.1};
 	 * auto result = LinearRegression::fit(x, y);
 	 * std::cout << "y = " << result.beta0 << " + " << result.beta1 << "x\n";
+	 *
+	 * // float storage, double accumulation
+	 * std::vector<float> xf = ..., yf = ...;
+	 * auto r = LinearRegression::fit<float, double>(xf, yf);   // FitResult<double>
 	 * @endcode
 	 */
-	template <typename T>
-		requires std::is_floating_point_v<T>
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
 	[[nodiscard]]  // Prevents accidentally discarding the result
-	FitResult<T> fit(std::span<const T> x, std::span<const T> y)
+	FitResult<Acc> fit(std::span<const T> x, std::span<const T> y, const Policy& policy = {})
 	{
+		// Two shifts (3 passes each), Sxx/Syy/Sxy, both means and the SSE:
+		// twelve passes over n elements in total
+		LINREG_STAGE_POLICY(fit, 12 * x.size() * sizeof(T), policy, x.size());
+
 		// Validate input: ensure same size and minimum data points
 		if (x.size() != y.size() || x.size() < 3) {
 			return {}; // Return default-constructed (empty) result
 		}
 
-		// Center both variables around their means for numerical stability
-		// This prevents potential overflow/underflow with very large values
-		auto x0 = Stats::shift(x);  // x0[i] = x[i] - mean(x)
-		auto y0 = Stats::shift(y);  // y0[i] = y[i] - mean(y)
-
-		// Initialize result structure
-		auto fitResult = FitResult<T>{};
-		fitResult.n = x.size();
-
-		// Calculate sum of squared deviations for x
-		// Sxx = Σ(xᵢ - x̄)² measures spread/variance of x
-		fitResult.sxx = Stats::inner_product(x0, x0);
-
-		// Check for degenerate case: all x values are identical
-		// If Sxx = 0, slope is undefined (division by zero)
-		if (fitResult.sxx == 0.0) {
+		// Centering, sums of squares, slope, intercept and correlation
+		auto fitResult = detail::centered_fit<T, Acc>(x, y, policy);
+		if (fitResult.n == 0) {
 			return {}; // Cannot fit a line when x doesn't vary
 		}
 
-		// Calculate sum of squared deviations for y
-		// Syy = Σ(yᵢ - ȳ)² measures spread/variance of y
-		fitResult.syy = Stats::inner_product(y0, y0);
-
-		// Calculate sum of products of deviations
-		// Sxy = Σ(xᵢ - x̄)(yᵢ - ȳ) measures covariance between x and y
-		fitResult.sxy = Stats::inner_product(x0, y0);
-
-		// Calculate slope coefficient using least squares formula
-		// β₁ = Sxy / Sxx
-		// This gives the change in y per unit change in x
-		fitResult.beta1 = fitResult.sxy / fitResult.sxx;
-
-		// Calculate intercept using the formula: β₀ = ȳ - β₁x̄
-		// The regression line always passes through the point (x̄, ȳ)
-		fitResult.beta0 = Stats::mean(y) - fitResult.beta1 * Stats::mean(x);
-
-		// Calculate Pearson correlation coefficient
-		// ρ = Sxy / √(Sxx × Syy)
-		// Range: -1 (perfect negative) to +1 (perfect positive)
-		// 0 indicates no linear relationship
-		fitResult.rho = fitResult.sxy / std::sqrt(fitResult.sxx * fitResult.syy);
-
 		// Calculate sum of squared errors (SSE)
 		// SSE = Σ(yᵢ - ŷᵢ)² where ŷᵢ = β₀ + β₁xᵢ
 		// This measures how well the model fits the data
 		// Lower SSE indicates better fit
-		fitResult.sse = std::transform_reduce(
-			x.begin(), x.end(),   // Range for x values
-			y.begin(),            // Range for y values (parallel iteration)
-			0.0,                  // Initial value for accumulation
-			std::plus<>(),        // Reduction operation (sum)
-			[&fitResult](const T& xi, const T& yi) {
-				// For each data point, calculate predicted value
-				const T yi_pred = fitResult.beta0 + fitResult.beta1 * xi;
-				// Calculate residual (error)
-				const T diff = yi - yi_pred;
-				// Return squared error
-				return diff * diff;
-			}
-		);
+		// Seeded with Acc{} like every other reduction, so the SSE is summed
+		// in the same precision as Sxx, Syy and Sxy
+		fitResult.sse = detail::residual_sum_of_squares(fitResult, x, y, policy);
 
 		return fitResult;
 	}
@@ -155,7 +216,7 @@ namespace LinearRegression {
 	 * @tparam C Container type that is SpanCompatible (vector, array, etc.)
 	 * @param x Container of independent variable values
 	 * @param y Container of dependent variable values
-	 * @return FitResult<double> containing all regression statistics
+	 * @return FitResult of the container's value type
 	 *
 	 * This overload allows passing any container that can be converted to
 	 * std::span, making the API more convenient for common use cases.
@@ -167,11 +228,299 @@ namespace LinearRegression {
 	 * auto result = LinearRegression::fit(x, y);  // Works with different container types
 	 * @endcode
 	 */
-	template <Helper::SpanCompatible C>
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
 	[[nodiscard]]
-	FitResult<double> fit(const C& x, const C& y)
+	FitResult<typename C::value_type> fit(const C& x, const C& y, const Policy& policy = {})
 	{
-		return fit(Helper::as_span(x), Helper::as_span(y));
+		return fit(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	namespace detail {
+
+		/// Fixed sizes up to this bound are unrolled completely by fold expressions.
+		inline constexpr std::size_t unroll_limit = 64;
+
+		/// Calls f(i) for i = 0, ..., N-1; unrolled for N <= unroll_limit.
+		template <std::size_t N, class F>
+		constexpr void static_for(F&& f)
+		{
+			if constexpr (N <= unroll_limit) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(f(I), ...);
+				}(std::make_index_sequence<N>{});
+			}
+			else {
+				for (std::size_t i = 0; i < N; ++i)
+					f(i);
+			}
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Fits a line to a fixed number of points, also at compile time
+	 * @tparam T Numeric type of the data
+	 * @tparam Acc Accumulator type of the sums and of the result (default: T)
+	 * @tparam N Number of points (static extent)
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @return FitResult<Acc> containing all regression statistics
+	 *
+	 * Same statistics as fit() for dynamic spans (two-pass centering, explicit
+	 * SSE), but without heap memory, thread dispatch or SIMD dispatch: the
+	 * loops over the N points are unrolled (N <= detail::unroll_limit) and the
+	 * whole fit is a constant expression for constexpr inputs, e.g. a
+	 * calibration table.
+	 *
+	 * @note Returns empty FitResult if N < 3 or all x values are nearly equal
+	 *       (Helper::nearly_equal with the x value of the first point), which
+	 *       also rejects an Sxx that consists of rounding noise only.
+	 *
+	 * Example:
+	 * @code
+	 * constexpr std::array<double, 8> x = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	 * constexpr std::array<double, 8> y = { 1, 3, 5, 7, 9, 11, 13, 15 };
+	 * constexpr auto r = LinearRegression::fit(x, y);
+	 * static_assert(r.beta1 == 2.0);
+	 * @endcode
+	 */
+	template <typename T, typename Acc = T, std::size_t N>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc> && (N != std::dynamic_extent)
+	[[nodiscard]]
+	constexpr FitResult<Acc> fit(std::span<const T, N> x, std::span<const T, N> y)
+	{
+		if constexpr (N < 3) {
+			return {};
+		}
+		else {
+			bool degenerate = true;
+			detail::static_for<N>([&](std::size_t i) {
+				degenerate = degenerate && Helper::nearly_equal(static_cast<Acc>(x[i]), static_cast<Acc>(x[0]));
+			});
+			if (degenerate) {
+				return {};
+			}
+
+			auto fitResult = FitResult<Acc>{};
+			fitResult.n = N;
+
+			Acc sx{}, sy{};
+			detail::static_for<N>([&](std::size_t i) {
+				sx += static_cast<Acc>(x[i]);
+				sy += static_cast<Acc>(y[i]);
+			});
+			fitResult.mean_x = sx / static_cast<Acc>(N);
+			fitResult.mean_y = sy / static_cast<Acc>(N);
+
+			detail::static_for<N>([&](std::size_t i) {
+				const Acc dx = static_cast<Acc>(x[i]) - fitResult.mean_x;
+				const Acc dy = static_cast<Acc>(y[i]) - fitResult.mean_y;
+				fitResult.sxx += dx * dx;
+				fitResult.syy += dy * dy;
+				fitResult.sxy += dx * dy;
+			});
+
+			fitResult.beta1 = fitResult.sxy / fitResult.sxx;
+			fitResult.beta0 = fitResult.mean_y - fitResult.beta1 * fitResult.mean_x;
+			fitResult.rho = fitResult.sxy / Helper::sqrt(fitResult.sxx * fitResult.syy);
+
+			detail::static_for<N>([&](std::size_t i) {
+				const Acc diff = static_cast<Acc>(y[i]) - (fitResult.beta0 + fitResult.beta1 * static_cast<Acc>(x[i]));
+				fitResult.sse += diff * diff;
+			});
+
+			return fitResult;
+		}
+	}
+
+	/**
+	 * @brief std::array overload of the fixed-size fit
+	 *
+	 * Preferred over the container overload for std::array, so fixed-size
+	 * tables take the unrolled, allocation-free path. Pass an execution policy
+	 * to use the dynamic fit() instead.
+	 */
+	template <typename T, typename Acc = T, std::size_t N>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	constexpr FitResult<Acc> fit(const std::array<T, N>& x, const std::array<T, N>& y)
+	{
+		return fit<T, Acc, N>(std::span<const T, N>(x), std::span<const T, N>(y));
+	}
+
+	/**
+	 * @brief Builds a FitResult from precomputed sufficient statistics
+	 * @tparam T Floating-point type
+	 * @param m Count, means and centered co-moments of the data
+	 * @return FitResult<T> derived from the moments
+	 *
+	 * All regression statistics follow in closed form from (n, x̄, ȳ, Sxx, Syy, Sxy).
+	 * In particular the SSE needs no extra pass over the data:
+	 * SSE = Syy - β₁ × Sxy = Syy - Sxy² / Sxx
+	 *
+	 * @note Returns empty FitResult under the same conditions as fit():
+	 *       fewer than 3 data points or Sxx = 0.
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	constexpr FitResult<T> fit_from_moments(const Stats::CoMoments<T>& m)
+	{
+		if (m.n < 3 || m.sxx == T{ 0 }) {
+			return {};
+		}
+
+		auto fitResult = FitResult<T>{};
+		fitResult.n = m.n;
+		fitResult.mean_x = m.mean_x;
+		fitResult.mean_y = m.mean_y;
+		fitResult.sxx = m.sxx;
+		fitResult.syy = m.syy;
+		fitResult.sxy = m.sxy;
+
+		fitResult.beta1 = m.sxy / m.sxx;
+		fitResult.beta0 = m.mean_y - fitResult.beta1 * m.mean_x;
+		fitResult.rho = m.sxy / Helper::sqrt(m.sxx * m.syy);
+
+		// Residual sum of squares from the normal equations; clamp the
+		// rounding noise of a (nearly) perfect fit to zero
+		fitResult.sse = std::max(m.syy - fitResult.beta1 * m.sxy, T{ 0 });
+
+		return fitResult;
+	}
+
+	/**
+	 * @brief Single-pass, allocation-free variant of fit()
+	 * @tparam T Numeric type (must be arithmetic, typically float or double)
+	 * @tparam Acc Accumulator type of the reduction and of the result (default: T)
+	 * @param x Independent variable values (features)
+	 * @param y Dependent variable values (targets)
+	 * @param policy Execution policy for the reduction (default: Stats::exec::automatic)
+	 * @return FitResult<Acc> containing all regression statistics
+	 *
+	 * Computes x̄, ȳ, Sxx, Syy and Sxy in one streaming pass with
+	 * Stats::co_moments() instead of building centered copies with
+	 * Stats::shift(). The data are still centered (blockwise, with merged
+	 * block results), so numerical stability matches fit().
+	 *
+	 * The SSE is derived from the sums (see fit_from_moments()). For a
+	 * near-perfect fit it carries an absolute error of about ε × Syy,
+	 * whereas fit() sums the residuals explicitly.
+	 *
+	 * @note Returns empty FitResult under the same conditions as fit().
+	 */
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	FitResult<Acc> fit_fused(std::span<const T> x, std::span<const T> y, const Policy& policy = {})
+	{
+		if (x.size() != y.size() || x.size() < 3) {
+			return {};
+		}
+		return fit_from_moments(Stats::co_moments<T, Acc>(x, y, policy));
+	}
+
+	/// @brief Container overload for fit_fused function
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	FitResult<typename C::value_type> fit_fused(const C& x, const C& y, const Policy& policy = {})
+	{
+		return fit_fused(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	/**
+	 * @brief Statistics a caller needs from fit(x, y, request); combine with |.
+	 *
+	 * β₀, β₁, n, the means and Sxx, Syy, Sxy come from one pass and are always
+	 * computed. Statistics that are not requested are NaN in the result.
+	 *
+	 * coefficients is the empty request, not a flag: has(r, coefficients) is
+	 * true for every r.
+	 */
+	enum class FitRequest : unsigned {
+		coefficients = 0,       ///< No extra fields: β₀ and β₁ (and the moments) only
+		rho = 1u << 0,          ///< Pearson correlation (one square root)
+		sse = 1u << 1,          ///< SSE in closed form, Syy - β₁Sxy (no extra pass)
+		exact_sse = 1u << 2,    ///< SSE summed explicitly over the residuals (one extra pass)
+		ci = 1u << 3,           ///< Everything ci_slope() and predict_bands() read (closed-form SSE)
+		all = rho | sse | ci
+	};
+
+	[[nodiscard]]
+	constexpr FitRequest operator|(FitRequest a, FitRequest b) noexcept
+	{
+		return static_cast<FitRequest>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+	}
+
+	/// @brief True if request contains every flag of flags.
+	[[nodiscard]]
+	constexpr bool has(FitRequest request, FitRequest flags) noexcept
+	{
+		return (static_cast<unsigned>(request) & static_cast<unsigned>(flags)) == static_cast<unsigned>(flags);
+	}
+
+	/**
+	 * @brief fit() that computes only the requested statistics
+	 * @tparam T Numeric type (must be arithmetic, typically float or double)
+	 * @tparam Acc Accumulator type of the reductions and of the result (default: T)
+	 * @param x Independent variable values (features)
+	 * @param y Dependent variable values (targets)
+	 * @param request Statistics needed beyond the coefficients
+	 * @param policy Execution policy for the reductions (default: Stats::exec::automatic)
+	 * @return FitResult<Acc>; fields that were not requested are NaN
+	 *
+	 * Runs Stats::co_moments() once (see fit_fused()) instead of the twelve
+	 * passes of fit(). The SSE is derived in closed form whenever it is
+	 * needed, unless FitRequest::exact_sse asks for the explicit sum, which
+	 * costs a second pass and matches fit() also for near-perfect fits.
+	 *
+	 * @note Returns empty FitResult under the same conditions as fit().
+	 *
+	 * Example:
+	 * @code
+	 * using LinearRegression::FitRequest;
+	 * auto line = LinearRegression::fit(x, y, FitRequest::coefficients);   // β₀, β₁
+	 * auto r = LinearRegression::fit(x, y, FitRequest::rho | FitRequest::ci);
+	 * auto [lo, hi] = LinearRegression::ci_slope(r, 0.05);
+	 * @endcode
+	 */
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	FitResult<Acc> fit(std::span<const T> x, std::span<const T> y, FitRequest request, const Policy& policy = {})
+	{
+		// co_moments() reads x and y once, the explicit SSE once more
+		LINREG_STAGE_POLICY(fit, (has(request, FitRequest::exact_sse) ? 4 : 2) * x.size() * sizeof(T), policy, x.size());
+
+		if (x.size() != y.size() || x.size() < 3) {
+			return {};
+		}
+
+		auto fitResult = fit_from_moments(Stats::co_moments<T, Acc>(x, y, policy));
+		if (fitResult.n == 0) {
+			return {};
+		}
+
+		constexpr Acc not_requested = std::numeric_limits<Acc>::quiet_NaN();
+		if (!has(request, FitRequest::rho)) {
+			fitResult.rho = not_requested;
+		}
+		if (has(request, FitRequest::exact_sse)) {
+			fitResult.sse = detail::residual_sum_of_squares(fitResult, x, y, policy);
+		}
+		else if (!has(request, FitRequest::sse) && !has(request, FitRequest::ci)) {
+			fitResult.sse = not_requested;
+		}
+
+		return fitResult;
+	}
+
+	/// @brief Container overload for fit with a FitRequest
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	FitResult<typename C::value_type> fit(const C& x, const C& y, FitRequest request, const Policy& policy = {})
+	{
+		return fit(Helper::as_span(x), Helper::as_span(y), request, policy);
 	}
 
 	/**
@@ -186,6 +535,9 @@ namespace LinearRegression {
 	 * The Student's t-distribution is used (instead of normal distribution)
 	 * because it accounts for estimation uncertainty when sample size is small.
 	 * As degrees of freedom increase, it approaches the normal distribution.
+	 *
+	 * @note Every call runs Boost's iterative inversion. ci_slope() uses
+	 *       t_quantile_cached() instead.
 	 */
 	template <typename T>
 		requires std::is_floating_point_v<T>
@@ -236,6 +588,8 @@ namespace LinearRegression {
 	[[nodiscard]]
 	std::pair<T, T> ci_slope(const FitResult<T>& fitResult, const T alpha)
 	{
+		LINREG_STAGE(ci_slope, sizeof(FitResult<T>));
+
 		// Degrees of freedom: n - 2
 		// We lose 2 degrees because we estimated β₀ and β₁
 		const auto dof = static_cast<T>(fitResult.n - 2);
@@ -253,8 +607,8 @@ namespace LinearRegression {
 		// Get the critical t-value for the desired confidence level
 		// For 95% CI with α=0.05, we need t at probability 0.975
 		// (two-tailed test, so we use 1 - α/2)
-		// Get the critical t-value using templated quantile function
-		const auto quantile = t_quantile(T{ 1 } - T{ 0.5 } * alpha, dof);
+		// Get the critical t-value from the quantile cache (see quantile_cache.h)
+		const auto quantile = t_quantile_cached(T{ 1 } - T{ 0.5 } * alpha, dof);
 
 		// Calculate margin of error: ME = t × SE(β₁)
 		const auto k = quantile * sb;
@@ -0,0 +1,370 @@
+/**
+ * @file mapped_file.h
+ * @brief Memory-mapped input for fitting data sets larger than RAM
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * - MappedFile: read-only mapping of a whole file (POSIX mmap / Win32 file mapping)
+ * - ColumnFile: binary columnar file whose columns are handed out as
+ *   std::span<const T> views into the mapping, without any copy
+ * - write_columns(): writes such a file
+ *
+ * Text input is handled by csv_parser.h, which parses from a MappedFile.
+ *
+ * Binary layout (all integers and values little-endian):
+ *
+ *   offset  size  field
+ *   0       8     magic "LRCOLS\0\0"
+ *   8       4     version (1)
+ *   12      4     dtype (1 = float32, 2 = float64)
+ *   16      8     number of columns
+ *   24      8     number of rows
+ *   32      32    reserved (zero)
+ *   64      ...   columns back to back, each padded to a multiple of 64 bytes
+ *
+ * Pages are loaded by the OS on demand, so combined with fit_fused() (which
+ * does not copy its input) a file is fitted with O(1) extra memory.
+ *
+ * Example:
+ * @code
+ * LinearRegression::ColumnFile file("measurements.lrc");
+ * auto r = LinearRegression::fit_fused(file.column<double>(0), file.column<double>(1));
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Read-only memory mapping of an entire file (move-only)
+	 * @throws std::runtime_error if the file cannot be opened or mapped
+	 *
+	 * An empty file yields an empty mapping.
+	 */
+	class MappedFile {
+	public:
+		MappedFile() noexcept = default;
+
+		explicit MappedFile(const std::filesystem::path& path)
+		{
+#ifdef _WIN32
+			file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE)
+				throw std::runtime_error("MappedFile: cannot open " + path.string());
+			LARGE_INTEGER size{};
+			if (!GetFileSizeEx(file_, &size)) {
+				close();
+				throw std::runtime_error("MappedFile: cannot stat " + path.string());
+			}
+			size_ = static_cast<std::size_t>(size.QuadPart);
+			if (size_ == 0)
+				return;
+			mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping_ == nullptr) {
+				close();
+				throw std::runtime_error("MappedFile: cannot map " + path.string());
+			}
+			data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			if (data_ == nullptr) {
+				close();
+				throw std::runtime_error("MappedFile: cannot map " + path.string());
+			}
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("MappedFile: cannot open " + path.string());
+			struct stat st {};
+			if (::fstat(fd, &st) != 0) {
+				::close(fd);
+				throw std::runtime_error("MappedFile: cannot stat " + path.string());
+			}
+			size_ = static_cast<std::size_t>(st.st_size);
+			if (size_ != 0) {
+				void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p == MAP_FAILED) {
+					::close(fd);
+					throw std::runtime_error("MappedFile: cannot map " + path.string());
+				}
+				// The reductions scan front to back: let the kernel read ahead aggressively
+				::madvise(p, size_, MADV_SEQUENTIAL);
+				data_ = static_cast<const std::byte*>(p);
+			}
+			::close(fd);  // the mapping keeps the file alive
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept { swap(other); }
+
+		MappedFile& operator=(MappedFile&& other) noexcept
+		{
+			if (this != &other) {
+				close();
+				swap(other);
+			}
+			return *this;
+		}
+
+		~MappedFile() { close(); }
+
+		/// @brief Mapped bytes of the file.
+		[[nodiscard]] std::span<const std::byte> bytes() const noexcept { return { data_, size_ }; }
+		[[nodiscard]] const std::byte* data() const noexcept { return data_; }
+		[[nodiscard]] std::size_t size() const noexcept { return size_; }
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+	private:
+		void swap(MappedFile& other) noexcept
+		{
+			std::swap(data_, other.data_);
+			std::swap(size_, other.size_);
+#ifdef _WIN32
+			std::swap(file_, other.file_);
+			std::swap(mapping_, other.mapping_);
+#endif
+		}
+
+		void close() noexcept
+		{
+#ifdef _WIN32
+			if (data_ != nullptr)
+				UnmapViewOfFile(data_);
+			if (mapping_ != nullptr)
+				CloseHandle(mapping_);
+			if (file_ != INVALID_HANDLE_VALUE)
+				CloseHandle(file_);
+			mapping_ = nullptr;
+			file_ = INVALID_HANDLE_VALUE;
+#else
+			if (data_ != nullptr)
+				::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		const std::byte* data_ = nullptr;
+		std::size_t size_ = 0;
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+	};
+
+	/// @brief Element type of a ColumnFile.
+	enum class ColumnType : std::uint32_t {
+		float32 = 1,
+		float64 = 2
+	};
+
+	namespace detail {
+
+		inline constexpr std::array<char, 8> column_magic = { 'L', 'R', 'C', 'O', 'L', 'S', '\0', '\0' };
+		inline constexpr std::uint32_t column_version = 1;
+		inline constexpr std::size_t column_header_size = 64;
+		inline constexpr std::size_t column_alignment = 64;
+
+		[[nodiscard]]
+		constexpr std::size_t align_up(std::size_t n, std::size_t a) noexcept
+		{
+			return (n + a - 1) / a * a;
+		}
+
+		template <typename T>
+		[[nodiscard]]
+		constexpr ColumnType column_type_of() noexcept
+		{
+			static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+				"ColumnFile stores float or double");
+			return std::is_same_v<T, float> ? ColumnType::float32 : ColumnType::float64;
+		}
+
+		[[nodiscard]]
+		constexpr std::size_t column_type_size(ColumnType t) noexcept
+		{
+			return t == ColumnType::float32 ? 4 : 8;
+		}
+
+		template <typename U>
+		[[nodiscard]]
+		U read_le(const std::byte* p) noexcept
+		{
+			U v;
+			std::memcpy(&v, p, sizeof(U));
+			return v;  // host is little-endian (checked by parse_column_header)
+		}
+
+		/// @brief Decoded ColumnFile header.
+		struct ColumnHeader {
+			ColumnType type{};
+			std::size_t columns = 0;
+			std::size_t rows = 0;
+			std::size_t stride = 0;  ///< Bytes per padded column
+
+			/// @brief File offset of column i.
+			[[nodiscard]] std::size_t offset(std::size_t i) const noexcept
+			{
+				return column_header_size + i * stride;
+			}
+		};
+
+		/**
+		 * @brief Validates and decodes the first column_header_size bytes of a ColumnFile
+		 * @param b Header bytes (at least column_header_size)
+		 * @param file_size Total file size, used for the truncation check
+		 * @throws std::runtime_error on any inconsistency
+		 */
+		[[nodiscard]]
+		inline ColumnHeader parse_column_header(std::span<const std::byte> b, std::size_t file_size,
+			const std::filesystem::path& path)
+		{
+			if constexpr (std::endian::native != std::endian::little)
+				throw std::runtime_error("ColumnFile: big-endian hosts are not supported");
+
+			if (b.size() < column_header_size
+				|| std::memcmp(b.data(), column_magic.data(), column_magic.size()) != 0)
+				throw std::runtime_error("ColumnFile: not a column file: " + path.string());
+			if (read_le<std::uint32_t>(b.data() + 8) != column_version)
+				throw std::runtime_error("ColumnFile: unsupported version: " + path.string());
+
+			const auto type = read_le<std::uint32_t>(b.data() + 12);
+			if (type != static_cast<std::uint32_t>(ColumnType::float32)
+				&& type != static_cast<std::uint32_t>(ColumnType::float64))
+				throw std::runtime_error("ColumnFile: unknown dtype: " + path.string());
+
+			ColumnHeader h;
+			h.type = static_cast<ColumnType>(type);
+			h.columns = static_cast<std::size_t>(read_le<std::uint64_t>(b.data() + 16));
+			h.rows = static_cast<std::size_t>(read_le<std::uint64_t>(b.data() + 24));
+			if (h.columns == 0)
+				throw std::runtime_error("ColumnFile: file has no columns: " + path.string());
+			// Bound rows by the payload before multiplying, so rows * type size cannot wrap
+			const auto payload = file_size - column_header_size;
+			if (h.rows > payload / h.columns / column_type_size(h.type))
+				throw std::runtime_error("ColumnFile: file is truncated: " + path.string());
+			h.stride = align_up(h.rows * column_type_size(h.type), column_alignment);
+			if (payload / h.columns < h.stride)
+				throw std::runtime_error("ColumnFile: file is truncated: " + path.string());
+			return h;
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Binary columnar file opened through a read-only mapping
+	 * @throws std::runtime_error if the file is missing, truncated or not a column file
+	 *
+	 * Columns are 64-byte aligned inside the file, so the views returned by
+	 * column() satisfy the alignment of the SIMD kernels in Stats::simd.
+	 */
+	class ColumnFile {
+	public:
+		explicit ColumnFile(const std::filesystem::path& path)
+			: file_(path), header_(detail::parse_column_header(file_.bytes(), file_.size(), path)) {}
+
+		[[nodiscard]] std::size_t columns() const noexcept { return header_.columns; }
+		[[nodiscard]] std::size_t rows() const noexcept { return header_.rows; }
+		[[nodiscard]] ColumnType type() const noexcept { return header_.type; }
+
+		/**
+		 * @brief Zero-copy view of column i
+		 * @tparam T float or double; must match type()
+		 * @throws std::out_of_range if i >= columns()
+		 * @throws std::invalid_argument if T does not match the stored type
+		 */
+		template <typename T>
+		[[nodiscard]]
+		std::span<const T> column(std::size_t i) const
+		{
+			if (i >= header_.columns)
+				throw std::out_of_range("ColumnFile: column index out of range");
+			if (detail::column_type_of<T>() != header_.type)
+				throw std::invalid_argument("ColumnFile: requested type does not match the stored type");
+			const auto* p = file_.data() + header_.offset(i);
+			return { reinterpret_cast<const T*>(p), header_.rows };
+		}
+
+	private:
+		MappedFile file_;
+		detail::ColumnHeader header_;
+	};
+
+	/**
+	 * @brief Writes equal-length columns in the ColumnFile format
+	 * @tparam T float or double
+	 * @param path Output file (overwritten)
+	 * @param columns Column views; at least one, all of the same size
+	 * @throws std::invalid_argument if there are no columns or they differ in length
+	 * @throws std::runtime_error if the file cannot be written
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	void write_columns(const std::filesystem::path& path, std::span<const std::span<const T>> columns)
+	{
+		if constexpr (std::endian::native != std::endian::little)
+			throw std::runtime_error("write_columns: big-endian hosts are not supported");
+
+		if (columns.empty())
+			throw std::invalid_argument("write_columns: no columns given");
+		const std::uint64_t rows = columns.front().size();
+		for (const auto& c : columns)
+			if (c.size() != rows)
+				throw std::invalid_argument("write_columns: columns must have same size");
+
+		std::array<char, detail::column_header_size> header{};
+		const std::uint32_t version = detail::column_version;
+		const auto type = static_cast<std::uint32_t>(detail::column_type_of<T>());
+		const std::uint64_t cols = columns.size();
+		std::memcpy(header.data(), detail::column_magic.data(), detail::column_magic.size());
+		std::memcpy(header.data() + 8, &version, 4);
+		std::memcpy(header.data() + 12, &type, 4);
+		std::memcpy(header.data() + 16, &cols, 8);
+		std::memcpy(header.data() + 24, &rows, 8);
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("write_columns: cannot open " + path.string());
+		out.write(header.data(), header.size());
+
+		const auto bytes = static_cast<std::size_t>(rows) * sizeof(T);
+		const std::array<char, detail::column_alignment> pad{};
+		for (const auto& c : columns) {
+			out.write(reinterpret_cast<const char*>(c.data()), static_cast<std::streamsize>(bytes));
+			out.write(pad.data(), static_cast<std::streamsize>(
+				detail::align_up(bytes, detail::column_alignment) - bytes));
+		}
+		if (!out)
+			throw std::runtime_error("write_columns: write failed: " + path.string());
+	}
+
+} // namespace LinearRegression
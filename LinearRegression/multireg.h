@@ -0,0 +1,542 @@
+/**
+ * @file multireg.h
+ * @brief Multiple linear regression (ordinary least squares with p predictors)
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Fits y = β₀ + β₁x₁ + ... + βₚxₚ + ε with the same conventions as linreg.h:
+ * - predictors and response are centered around their means before the
+ *   normal equations are formed (numerical stability)
+ * - the intercept follows from the means: β₀ = ȳ - Σ βⱼx̄ⱼ
+ * - confidence intervals use Student's t with n - p - 1 degrees of freedom
+ *
+ * Two solvers:
+ * - Solver::cholesky: accumulates the centered Gram matrix XᵀX in one pass
+ *   (after the mean pass) and solves by Cholesky factorization. Each block
+ *   of gram_block_rows rows is centered into a column-major scratch buffer
+ *   and added as BᵀB, tile by tile over gram_tile_cols columns, so a tile
+ *   is reused from L1 for every column it is paired with. Memory is O(p²),
+ *   independent of n.
+ * - Solver::qr: Householder QR of a centered, column-major copy of X. Costs
+ *   O(n·p) memory but does not square the condition number, unlike the
+ *   normal-equations path, so it stays accurate for ill-conditioned (nearly
+ *   collinear) predictors. The copy and the update of the trailing columns
+ *   by each reflector run under the caller's policy.
+ *
+ * The design matrix is row-major: row i holds the p predictor values of
+ * observation i, so each block of rows is contiguous in memory.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "arena.h"
+#include "execution.h"
+#include "quantile_cache.h"
+#include "simd_kernels.h"
+
+namespace LinearRegression {
+
+	/// @brief Linear solver used by fit_multi().
+	enum class Solver {
+		cholesky,  ///< Normal equations, O(p²) memory, fastest
+		qr         ///< Householder QR, robust for ill-conditioned data
+	};
+
+	/**
+	 * @brief Result of a multiple linear regression
+	 * @tparam T Floating-point type
+	 *
+	 * Coefficient index 0 is the intercept, 1..p are the slopes of the
+	 * predictor columns in order. An empty result (n == 0, beta empty) signals
+	 * that the model could not be fitted.
+	 */
+	template <class T>
+	struct MultiFitResult {
+		std::vector<T> beta;          ///< Coefficients β₀..βₚ
+		std::vector<T> cov_unscaled;  ///< (p+1)×(p+1) row-major (XᵀX)⁻¹ incl. intercept; multiply by σ² = sse/dof
+		std::vector<T> mean_x;        ///< Column means x̄₁..x̄ₚ
+		T mean_y{};                   ///< Mean of y (ȳ)
+		T syy{};                      ///< Total sum of squares Σ(yᵢ - ȳ)²
+		T sse{};                      ///< Sum of squared errors Σ(yᵢ - ŷᵢ)²
+		std::size_t n{};              ///< Number of observations
+		std::size_t p{};              ///< Number of predictors (without intercept)
+	};
+
+	namespace detail {
+
+		/// Rows per block in the Gram accumulation; a centered block stays in L1/L2.
+		inline constexpr std::size_t gram_block_rows = 64;
+
+		/// Columns per tile of the BᵀB update; two tiles of a block fit in L1.
+		inline constexpr std::size_t gram_tile_cols = 16;
+
+		/// @brief Column sums of a row-major block of rows plus Σy.
+		template <typename T>
+		struct ColumnSums {
+			std::vector<T> sx;
+			T sy{};
+
+			ColumnSums& operator+=(const ColumnSums& o)
+			{
+				if (sx.empty()) {
+					sx = o.sx;
+				}
+				else {
+					for (std::size_t j = 0; j < o.sx.size(); ++j)
+						sx[j] += o.sx[j];
+				}
+				sy += o.sy;
+				return *this;
+			}
+		};
+
+		/// @brief Centered normal equations (upper triangle of XᵀX, Xᵀy, yᵀy).
+		template <typename T>
+		struct Gram {
+			std::vector<T> xtx;  ///< p×p row-major, upper triangle filled
+			std::vector<T> xty;  ///< p
+			T yty{};
+
+			Gram& operator+=(const Gram& o)
+			{
+				if (xtx.empty()) {
+					xtx = o.xtx;
+					xty = o.xty;
+				}
+				else {
+					for (std::size_t k = 0; k < o.xtx.size(); ++k)
+						xtx[k] += o.xtx[k];
+					for (std::size_t j = 0; j < o.xty.size(); ++j)
+						xty[j] += o.xty[j];
+				}
+				yty += o.yty;
+				return *this;
+			}
+		};
+
+		/**
+		 * @brief In-place Cholesky factorization A = L Lᵀ of a p×p SPD matrix.
+		 * @return false if A is not (numerically) positive definite.
+		 *
+		 * Reads the upper triangle of A and writes L into the lower triangle.
+		 */
+		template <typename T>
+		[[nodiscard]]
+		bool cholesky(std::vector<T>& a, std::size_t p)
+		{
+			// A pivot that lost almost all of its diagonal to the previous columns
+			// means the column is a linear combination of them (up to rounding)
+			const T rel_tol = T{ 64 } * std::numeric_limits<T>::epsilon() * static_cast<T>(p);
+
+			for (std::size_t j = 0; j < p; ++j) {
+				T d = a[j * p + j];
+				for (std::size_t k = 0; k < j; ++k)
+					d -= a[j * p + k] * a[j * p + k];
+				if (!(d > rel_tol * a[j * p + j]))
+					return false;
+				const T ljj = std::sqrt(d);
+				a[j * p + j] = ljj;
+				for (std::size_t i = j + 1; i < p; ++i) {
+					T v = a[j * p + i];  // upper triangle holds A(j, i) = A(i, j)
+					for (std::size_t k = 0; k < j; ++k)
+						v -= a[i * p + k] * a[j * p + k];
+					a[i * p + j] = v / ljj;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Inverse of a lower-triangular p×p matrix L (row-major, lower part).
+		template <typename T>
+		[[nodiscard]]
+		std::vector<T> invert_lower(const std::vector<T>& l, std::size_t p)
+		{
+			std::vector<T> inv(p * p, T{});
+			for (std::size_t j = 0; j < p; ++j) {
+				inv[j * p + j] = T{ 1 } / l[j * p + j];
+				for (std::size_t i = j + 1; i < p; ++i) {
+					T s{};
+					for (std::size_t k = j; k < i; ++k)
+						s -= l[i * p + k] * inv[k * p + j];
+					inv[i * p + j] = s / l[i * p + i];
+				}
+			}
+			return inv;
+		}
+
+		/**
+		 * @brief Fills the full (p+1)×(p+1) unscaled covariance from A⁻¹ = (XcᵀXc)⁻¹.
+		 *
+		 * Var(β₀) ∝ 1/n + x̄ᵀA⁻¹x̄, Cov(β₀, βⱼ) ∝ -(A⁻¹x̄)ⱼ, Cov(βᵢ, βⱼ) ∝ A⁻¹ᵢⱼ.
+		 */
+		template <typename T>
+		void expand_covariance(MultiFitResult<T>& r, const std::vector<T>& ainv)
+		{
+			const auto p = r.p;
+			const auto q = p + 1;
+			r.cov_unscaled.assign(q * q, T{});
+
+			std::vector<T> ainv_mean(p, T{});
+			for (std::size_t i = 0; i < p; ++i)
+				for (std::size_t j = 0; j < p; ++j)
+					ainv_mean[i] += ainv[i * p + j] * r.mean_x[j];
+
+			T v0 = T{ 1 } / static_cast<T>(r.n);
+			for (std::size_t j = 0; j < p; ++j)
+				v0 += r.mean_x[j] * ainv_mean[j];
+			r.cov_unscaled[0] = v0;
+
+			for (std::size_t i = 0; i < p; ++i) {
+				r.cov_unscaled[(i + 1) * q] = -ainv_mean[i];
+				r.cov_unscaled[i + 1] = -ainv_mean[i];
+				for (std::size_t j = 0; j < p; ++j)
+					r.cov_unscaled[(i + 1) * q + (j + 1)] = ainv[i * p + j];
+			}
+		}
+
+		/// @brief Column means of X and the mean of y (one pass).
+		template <typename T, Stats::ExecutionPolicy Policy>
+		void multi_means(std::span<const T> X, std::span<const T> y, std::size_t p,
+			MultiFitResult<T>& r, const Policy& policy)
+		{
+			const auto n = y.size();
+			auto sums = Stats::detail::chunked_reduce(policy, n, ColumnSums<T>{},
+				[X, y, p](std::size_t begin, std::size_t len) {
+					ColumnSums<T> s{ std::vector<T>(p, T{}), T{} };
+					for (std::size_t i = begin; i < begin + len; ++i) {
+						const T* row = X.data() + i * p;
+						for (std::size_t j = 0; j < p; ++j)
+							s.sx[j] += row[j];
+						s.sy += y[i];
+					}
+					return s;
+				},
+				[](ColumnSums<T> a, const ColumnSums<T>& b) { return a += b; });
+
+			r.mean_x.resize(p);
+			for (std::size_t j = 0; j < p; ++j)
+				r.mean_x[j] = sums.sx[j] / static_cast<T>(n);
+			r.mean_y = sums.sy / static_cast<T>(n);
+		}
+
+		/**
+		 * @brief Adds BᵀB of a centered column-major block B (rows × p) to the upper triangle of xtx.
+		 *
+		 * Column j of B is the contiguous range blk[j·stride, j·stride + rows).
+		 * The triangle is walked in gram_tile_cols × gram_tile_cols tiles; each
+		 * entry is one dot product over the rows of the block.
+		 */
+		template <typename T>
+		void add_gram_block(const T* blk, std::size_t stride, std::size_t rows, std::size_t p, T* xtx) noexcept
+		{
+			for (std::size_t jt = 0; jt < p; jt += gram_tile_cols) {
+				const auto jend = std::min(jt + gram_tile_cols, p);
+				for (std::size_t kt = jt; kt < p; kt += gram_tile_cols) {
+					const auto kend = std::min(kt + gram_tile_cols, p);
+					for (std::size_t j = jt; j < jend; ++j) {
+						const T* cj = blk + j * stride;
+						for (std::size_t k = std::max(j, kt); k < kend; ++k)
+							xtx[j * p + k] += Stats::simd::dot(cj, blk + k * stride, rows);
+					}
+				}
+			}
+		}
+
+		/// @brief Centered Gram matrix, accumulated over row blocks.
+		template <typename T, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		Gram<T> centered_gram(std::span<const T> X, std::span<const T> y, std::size_t p,
+			const MultiFitResult<T>& r, const Policy& policy)
+		{
+			return Stats::detail::chunked_reduce(policy, y.size(), Gram<T>{},
+				[X, y, p, &r](std::size_t begin, std::size_t len) {
+					Gram<T> g{ std::vector<T>(p * p, T{}), std::vector<T>(p, T{}), T{} };
+					// Block buffers from the arena of the thread running this chunk
+					Stats::ScratchScope scratch;
+					std::pmr::vector<T> blk(gram_block_rows * p, scratch.resource());
+					std::pmr::vector<T> yb(gram_block_rows, scratch.resource());
+					for (std::size_t b = begin; b < begin + len; b += gram_block_rows) {
+						const auto rows = std::min(gram_block_rows, begin + len - b);
+						// Center one block of rows into a cache-resident, column-major buffer
+						for (std::size_t i = 0; i < rows; ++i) {
+							const T* row = X.data() + (b + i) * p;
+							for (std::size_t j = 0; j < p; ++j)
+								blk[j * gram_block_rows + i] = row[j] - r.mean_x[j];
+							yb[i] = y[b + i] - r.mean_y;
+						}
+						add_gram_block(blk.data(), gram_block_rows, rows, p, g.xtx.data());
+						for (std::size_t j = 0; j < p; ++j)
+							g.xty[j] += Stats::simd::dot(blk.data() + j * gram_block_rows, yb.data(), rows);
+						g.yty += Stats::simd::dot(yb.data(), yb.data(), rows);
+					}
+					return g;
+				},
+				[](Gram<T> a, const Gram<T>& b) { return a += b; });
+		}
+
+		/// @brief Normal equations + Cholesky. Returns false if XᵀX is singular.
+		template <typename T, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		bool solve_cholesky(std::span<const T> X, std::span<const T> y, MultiFitResult<T>& r,
+			const Policy& policy)
+		{
+			const auto p = r.p;
+			auto g = centered_gram(X, y, p, r, policy);
+			r.syy = g.yty;
+
+			auto l = g.xtx;
+			if (!cholesky(l, p))
+				return false;
+
+			// Forward substitution L z = Xᵀy, then back substitution Lᵀ β = z
+			std::vector<T> z(p);
+			for (std::size_t i = 0; i < p; ++i) {
+				T s = g.xty[i];
+				for (std::size_t k = 0; k < i; ++k)
+					s -= l[i * p + k] * z[k];
+				z[i] = s / l[i * p + i];
+			}
+			std::vector<T> b(p);
+			for (std::size_t i = p; i-- > 0;) {
+				T s = z[i];
+				for (std::size_t k = i + 1; k < p; ++k)
+					s -= l[k * p + i] * b[k];
+				b[i] = s / l[i * p + i];
+			}
+
+			// SSE = yᵀy - βᵀXᵀy = yᵀy - ‖z‖²
+			T zz{};
+			for (const auto v : z)
+				zz += v * v;
+			r.sse = std::max(g.yty - zz, T{ 0 });
+
+			// (XᵀX)⁻¹ = L⁻ᵀ L⁻¹
+			const auto linv = invert_lower(l, p);
+			std::vector<T> ainv(p * p, T{});
+			for (std::size_t i = 0; i < p; ++i)
+				for (std::size_t j = 0; j <= i; ++j) {
+					T s{};
+					for (std::size_t k = i; k < p; ++k)
+						s += linv[k * p + i] * linv[k * p + j];
+					ainv[i * p + j] = ainv[j * p + i] = s;
+				}
+
+			r.beta.assign(p + 1, T{});
+			for (std::size_t j = 0; j < p; ++j)
+				r.beta[j + 1] = b[j];
+			expand_covariance(r, ainv);
+			return true;
+		}
+
+		/**
+		 * @brief Householder QR of the centered data. Returns false if X is rank deficient.
+		 *
+		 * Builds an O(n·p) column-major copy. The copy and, for each
+		 * reflector, the update of the remaining columns are split by column
+		 * under policy; the columns are independent, so the result does not
+		 * depend on the policy.
+		 */
+		template <typename T, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		bool solve_qr(std::span<const T> X, std::span<const T> y, MultiFitResult<T>& r, const Policy& policy)
+		{
+			const auto n = r.n;
+			const auto p = r.p;
+
+			// Column-major centered copy: each reflector then works on contiguous columns
+			std::vector<T> a(n * p);
+			Stats::detail::bulk(policy, n * p, p, [&](std::size_t j) {
+				T* col = a.data() + j * n;
+				for (std::size_t i = 0; i < n; ++i)
+					col[i] = X[i * p + j] - r.mean_x[j];
+			});
+			std::vector<T> qty(n);
+			for (std::size_t i = 0; i < n; ++i)
+				qty[i] = y[i] - r.mean_y;
+
+			T syy{};
+			for (const auto v : qty)
+				syy += v * v;
+			r.syy = syy;
+
+			T max_r{};
+			for (std::size_t j = 0; j < p; ++j) {
+				T* col = a.data() + j * n;
+				T norm{};
+				for (std::size_t i = j; i < n; ++i)
+					norm += col[i] * col[i];
+				norm = std::sqrt(norm);
+				if (norm == T{ 0 })
+					return false;
+
+				// v = x + sign(x₀)‖x‖e₀ stored in place; R(j, j) = -sign(x₀)‖x‖
+				const T alpha = col[j] > T{ 0 } ? -norm : norm;
+				col[j] -= alpha;
+				T vtv{};
+				for (std::size_t i = j; i < n; ++i)
+					vtv += col[i] * col[i];
+
+				auto reflect = [&](T* dst) {
+					T s{};
+					for (std::size_t i = j; i < n; ++i)
+						s += col[i] * dst[i];
+					const T f = T{ 2 } * s / vtv;
+					for (std::size_t i = j; i < n; ++i)
+						dst[i] -= f * col[i];
+				};
+				Stats::detail::bulk(policy, (n - j) * (p - j - 1), p - j - 1,
+					[&](std::size_t k) { reflect(a.data() + (j + 1 + k) * n); });
+				reflect(qty.data());
+
+				col[j] = alpha;  // diagonal of R; the rest of v is no longer needed
+				max_r = std::max(max_r, std::fabs(alpha));
+			}
+
+			// Rank check relative to the largest diagonal entry of R
+			const T tol = max_r * std::numeric_limits<T>::epsilon() * static_cast<T>(std::max(n, p));
+			for (std::size_t j = 0; j < p; ++j)
+				if (std::fabs(a[j * n + j]) <= tol)
+					return false;
+
+			// Back substitution R β = (Qᵀy)[0..p)
+			std::vector<T> b(p);
+			for (std::size_t i = p; i-- > 0;) {
+				T s = qty[i];
+				for (std::size_t k = i + 1; k < p; ++k)
+					s -= a[k * n + i] * b[k];
+				b[i] = s / a[i * n + i];
+			}
+
+			// SSE = ‖(Qᵀy)[p..n)‖²
+			T sse{};
+			for (std::size_t i = p; i < n; ++i)
+				sse += qty[i] * qty[i];
+			r.sse = sse;
+
+			// (XᵀX)⁻¹ = R⁻¹R⁻ᵀ; Rᵀ is lower triangular, so reuse invert_lower
+			std::vector<T> rt(p * p, T{});
+			for (std::size_t i = 0; i < p; ++i)
+				for (std::size_t j = i; j < p; ++j)
+					rt[j * p + i] = a[j * n + i];
+			const auto rtinv = invert_lower(rt, p);  // = (R⁻¹)ᵀ
+			std::vector<T> ainv(p * p, T{});
+			for (std::size_t i = 0; i < p; ++i)
+				for (std::size_t j = 0; j <= i; ++j) {
+					T s{};
+					for (std::size_t k = i; k < p; ++k)
+						s += rtinv[k * p + i] * rtinv[k * p + j];
+					ainv[i * p + j] = ainv[j * p + i] = s;
+				}
+
+			r.beta.assign(p + 1, T{});
+			for (std::size_t j = 0; j < p; ++j)
+				r.beta[j + 1] = b[j];
+			expand_covariance(r, ainv);
+			return true;
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Fits a multiple linear regression model by least squares
+	 * @tparam T Floating-point type
+	 * @param X Row-major n×p design matrix without intercept column
+	 * @param y Response values (n)
+	 * @param p Number of predictor columns
+	 * @param solver Solver::cholesky (default) or Solver::qr
+	 * @param policy Execution policy for the data passes
+	 * @return MultiFitResult<T> with coefficients, SSE and covariance
+	 *
+	 * @note Returns an empty result if:
+	 *       - X.size() != y.size() × p or p == 0
+	 *       - fewer than p + 2 observations (no residual degree of freedom)
+	 *       - the centered predictors are (numerically) linearly dependent
+	 *
+	 * Example:
+	 * @code
+	 * // y ~ 1 + x1 + x2, rows {x1, x2}
+	 * std::vector<double> X = {1, 0.5,  2, 0.1,  3, 0.9,  4, 0.3,  5, 0.7};
+	 * std::vector<double> y = {2.9, 4.2, 7.6, 8.3, 11.1};
+	 * auto r = LinearRegression::fit_multi<double>(X, y, 2);
+	 * auto ci = LinearRegression::ci_coefficients(r, 0.05);
+	 * @endcode
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	MultiFitResult<T> fit_multi(std::span<const T> X, std::span<const T> y, std::size_t p,
+		Solver solver = Solver::cholesky, const Policy& policy = {})
+	{
+		const auto n = y.size();
+		if (p == 0 || X.size() != n * p || n < p + 2) {
+			return {};
+		}
+
+		MultiFitResult<T> r{};
+		r.n = n;
+		r.p = p;
+		detail::multi_means(X, y, p, r, policy);
+
+		const bool ok = solver == Solver::qr
+			? detail::solve_qr(X, y, r, policy)
+			: detail::solve_cholesky(X, y, r, policy);
+		if (!ok) {
+			return {};
+		}
+
+		// Intercept: the fitted hyperplane passes through (x̄, ȳ)
+		r.beta[0] = r.mean_y;
+		for (std::size_t j = 0; j < p; ++j)
+			r.beta[0] -= r.beta[j + 1] * r.mean_x[j];
+		return r;
+	}
+
+	/**
+	 * @brief Confidence intervals for all coefficients of a multiple regression
+	 * @param fitResult The result from a previous fit_multi() call
+	 * @param alpha Significance level (e.g., 0.05 for 95% confidence)
+	 * @return (lower, upper) for β₀..βₚ; empty if the result is empty
+	 *
+	 * CI = βⱼ ± t(1-α/2, n-p-1) × SE(βⱼ), SE(βⱼ) = √(σ² [(XᵀX)⁻¹]ⱼⱼ), σ² = SSE/(n-p-1).
+	 * For p = 1 the slope interval equals ci_slope().
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::vector<std::pair<T, T>> ci_coefficients(const MultiFitResult<T>& fitResult, const T alpha)
+	{
+		if (fitResult.beta.empty()) {
+			return {};
+		}
+		// Degrees of freedom: n - p - 1 (p slopes plus the intercept)
+		const auto dof = static_cast<T>(fitResult.n - fitResult.p - 1);
+		const auto sigma2 = fitResult.sse / dof;
+		const auto quantile = t_quantile_cached(T{ 1 } - T{ 0.5 } * alpha, dof);
+
+		const auto q = fitResult.p + 1;
+		std::vector<std::pair<T, T>> ci(q);
+		for (std::size_t j = 0; j < q; ++j) {
+			const auto k = quantile * std::sqrt(sigma2 * fitResult.cov_unscaled[j * q + j]);
+			ci[j] = { fitResult.beta[j] - k, fitResult.beta[j] + k };
+		}
+		return ci;
+	}
+
+	/// @brief Coefficient of determination R² = 1 - SSE/Syy of a multiple regression.
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	T coeff_of_determination(const MultiFitResult<T>& fitResult)
+	{
+		return T{ 1 } - fitResult.sse / fitResult.syy;
+	}
+
+} // namespace LinearRegression
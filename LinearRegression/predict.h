@@ -0,0 +1,143 @@
+/**
+ * @file predict.h
+ * @brief Batched prediction with confidence and prediction bands
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Evaluates a fitted line at many new points and writes into caller-owned
+ * buffers:
+ * - predict():       ŷ = β₀ + β₁x
+ * - predict_bands(): ŷ with the (1 - α) confidence band of the mean response
+ *                    and the (1 - α) prediction band of a new observation
+ *
+ * With s² = SSE / (n - 2) and t = t(1 - α/2, n - 2) the half-widths are
+ *   CI: t × s × √(1/n + (x - x̄)² / Sxx)
+ *   PI: t × s × √(1 + 1/n + (x - x̄)² / Sxx)
+ * so both bands are narrowest at x̄ and widen away from it.
+ *
+ * The new points are processed in chunks of Stats::detail::par_chunk on the
+ * parallel backend, each chunk with the vectorized kernels of simd_kernels.h.
+ *
+ * Example:
+ * @code
+ * auto r = LinearRegression::fit(x, y);
+ * std::vector<double> yhat(grid.size()), lo(grid.size()), hi(grid.size()), plo(grid.size()), phi(grid.size());
+ * LinearRegression::predict_bands(r, std::span<const double>(grid), 0.05, { yhat, lo, hi, plo, phi });
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "execution.h"
+#include "linreg.h"
+#include "quantile_cache.h"
+#include "simd_kernels.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Output buffers of predict_bands(), each with one entry per new point
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	struct PredictionBands {
+		std::span<T> fit;       ///< ŷ
+		std::span<T> ci_lower;  ///< Lower bound of the confidence band
+		std::span<T> ci_upper;  ///< Upper bound of the confidence band
+		std::span<T> pi_lower;  ///< Lower bound of the prediction band
+		std::span<T> pi_upper;  ///< Upper bound of the prediction band
+	};
+
+	namespace detail {
+
+		/// Runs f(begin, len) over [0, n) in chunks of par_chunk.
+		template <Stats::ExecutionPolicy Policy, class F>
+		void for_chunks(const Policy& policy, std::size_t n, F f)
+		{
+			using Stats::detail::par_chunk;
+			Stats::detail::bulk(policy, n, (n + par_chunk - 1) / par_chunk, [n, &f](std::size_t c) {
+				const auto begin = c * par_chunk;
+				f(begin, std::min(par_chunk, n - begin));
+			});
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Evaluates the fitted line at new points
+	 * @tparam T Floating-point type
+	 * @param fitResult Result of fit() (or of any other fit returning FitResult)
+	 * @param x_new Points to evaluate
+	 * @param out Receives β₀ + β₁ × x_new[i]; may alias x_new
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @throws std::invalid_argument if out and x_new differ in size
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	void predict(const FitResult<T>& fitResult, std::span<const T> x_new, std::span<T> out,
+		const Policy& policy = {})
+	{
+		if (x_new.size() != out.size())
+			throw std::invalid_argument("predict: output must have the size of x_new");
+
+		detail::for_chunks(policy, x_new.size(), [&](std::size_t begin, std::size_t len) {
+			Stats::simd::affine(x_new.data() + begin, len, fitResult.beta0, fitResult.beta1, out.data() + begin);
+		});
+	}
+
+	namespace detail {
+
+		/// predict_bands() with the 1/n term of the band widths supplied by the caller.
+		template <typename T, Stats::ExecutionPolicy Policy>
+		void predict_bands(const FitResult<T>& fitResult, std::span<const T> x_new, const T alpha,
+			const PredictionBands<T>& out, const T inv_n, const Policy& policy)
+		{
+			const auto n = x_new.size();
+			if (out.fit.size() != n || out.ci_lower.size() != n || out.ci_upper.size() != n
+				|| out.pi_lower.size() != n || out.pi_upper.size() != n)
+				throw std::invalid_argument("predict_bands: every output must have the size of x_new");
+			if (fitResult.n < 3 || !(fitResult.sxx > T{ 0 }))
+				throw std::invalid_argument("predict_bands: fit result is empty");
+
+			// Residual standard error s = √(SSE / (n - 2)) and the critical t-value
+			const auto dof = static_cast<T>(fitResult.n - 2);
+			const auto s = std::sqrt(fitResult.sse / dof);
+			const auto t = t_quantile_cached(T{ 1 } - T{ 0.5 } * alpha, dof);
+
+			const Stats::simd::BandCoefficients<T> c{
+				fitResult.beta0, fitResult.beta1, fitResult.mean_x, inv_n, T{ 1 } / fitResult.sxx, t * s };
+			const Stats::simd::BandRows<T> rows{
+				out.fit.data(), out.ci_lower.data(), out.ci_upper.data(), out.pi_lower.data(), out.pi_upper.data() };
+
+			for_chunks(policy, n, [&](std::size_t begin, std::size_t len) {
+				Stats::simd::bands(x_new.data() + begin, len, c, rows.at(begin));
+			});
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Evaluates the fitted line with confidence and prediction bands
+	 * @tparam T Floating-point type
+	 * @param fitResult Result of fit(); n, x̄, Sxx and SSE are used
+	 * @param x_new Points to evaluate
+	 * @param alpha Significance level (e.g., 0.05 for 95% bands)
+	 * @param out Output buffers, each of the size of x_new
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @throws std::invalid_argument if a buffer differs in size from x_new or
+	 *         the fit is empty (fewer than 3 points, Sxx = 0)
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	void predict_bands(const FitResult<T>& fitResult, std::span<const T> x_new, const T alpha,
+		const PredictionBands<T>& out, const Policy& policy = {})
+	{
+		detail::predict_bands(fitResult, x_new, alpha, out, T{ 1 } / static_cast<T>(fitResult.n), policy);
+	}
+
+} // namespace LinearRegression
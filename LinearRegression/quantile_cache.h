@@ -0,0 +1,213 @@
+/**
+ * @file quantile_cache.h
+ * @brief Cached Student-t quantiles for confidence intervals
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * boost::math::quantile() on a Student-t distribution runs an iterative
+ * inversion on every call. For many fits with the same confidence level
+ * this dominates the cost of ci_slope(), so quantiles are cached:
+ *
+ * - Common levels (α = 0.2, 0.1, 0.05, 0.02, 0.01, 0.001) with integer
+ *   degrees of freedom up to max_table_dof live in a lock-free table that is
+ *   filled lazily on first use.
+ * - Above max_table_dof the quantile follows from the normal quantile with
+ *   the Cornish-Fisher expansion (Abramowitz & Stegun 26.7.5, terms up to
+ *   ν⁻⁴). Against Boost it is accurate to about 2e-14 relative at the
+ *   tabulated levels just above max_table_dof and improves with ν; far
+ *   tails lose accuracy (about 2e-13 at p = 1 - 1e-5).
+ * - Other (p, dof) pairs are memoized in a bounded map behind a shared mutex.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <boost/math/distributions/normal.hpp>
+#include <boost/math/distributions/students_t.hpp>
+#include "instrumentation.h"
+
+namespace LinearRegression {
+
+	/// Largest integer degrees of freedom stored in the quantile table.
+	inline constexpr std::size_t max_table_dof = 1024;
+
+	namespace detail {
+
+		/// Upper-tail probabilities 1 - α/2 of the tabulated confidence levels.
+		inline constexpr std::array<double, 6> table_probabilities = {
+			0.9, 0.95, 0.975, 0.99, 0.995, 0.9995
+		};
+
+		/// @brief Student-t quantile from the normal quantile z (Cornish-Fisher).
+		[[nodiscard]]
+		inline double cornish_fisher_t(double z, double dof) noexcept
+		{
+			const double z2 = z * z;
+			const double z3 = z2 * z;
+			const double z5 = z3 * z2;
+			const double z7 = z5 * z2;
+			const double z9 = z7 * z2;
+			const double g1 = (z3 + z) / 4.0;
+			const double g2 = (5.0 * z5 + 16.0 * z3 + 3.0 * z) / 96.0;
+			const double g3 = (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / 384.0;
+			const double g4 = (79.0 * z9 + 776.0 * z7 + 1482.0 * z5 - 1920.0 * z3 - 945.0 * z) / 92160.0;
+			const double v = 1.0 / dof;
+			return z + v * (g1 + v * (g2 + v * (g3 + v * g4)));
+		}
+
+		[[nodiscard]]
+		inline double normal_quantile(double p)
+		{
+			return boost::math::quantile(boost::math::normal_distribution<double>{}, p);
+		}
+
+		[[nodiscard]]
+		inline double exact_t_quantile(double p, double dof)
+		{
+			return boost::math::quantile(boost::math::students_t_distribution<double>(dof), p);
+		}
+
+		/// @brief Lazily filled table; 0 marks an entry that is not computed yet.
+		struct QuantileTable {
+			std::array<std::array<std::atomic<double>, max_table_dof + 1>, table_probabilities.size()> t{};
+			std::array<std::atomic<double>, table_probabilities.size()> z{};
+		};
+
+		[[nodiscard]]
+		inline QuantileTable& quantile_table()
+		{
+			static QuantileTable table;
+			return table;
+		}
+
+		/// @brief Index of p in table_probabilities, or -1.
+		[[nodiscard]]
+		inline int table_index(double p) noexcept
+		{
+			for (std::size_t i = 0; i < table_probabilities.size(); ++i) {
+				// 1 - α/2 is not always bit-exact in binary, so allow rounding
+				if (std::fabs(p - table_probabilities[i]) <= 1e-12)
+					return static_cast<int>(i);
+			}
+			return -1;
+		}
+
+		/// @brief Memo for probabilities outside the table (bounded size).
+		struct QuantileMemo {
+			static constexpr std::size_t max_entries = 4096;
+			std::shared_mutex mutex;
+			std::map<std::pair<double, double>, double> values;
+		};
+
+		[[nodiscard]]
+		inline QuantileMemo& quantile_memo()
+		{
+			static QuantileMemo memo;
+			return memo;
+		}
+
+		/// @brief Cached upper quantile for p > 0.5.
+		[[nodiscard]]
+		inline double cached_upper_t_quantile(double p, double dof)
+		{
+			const double dof_int = std::floor(dof);
+			const bool integral = dof_int == dof;
+			const int row = table_index(p);
+
+			if (row >= 0 && integral && dof >= 1.0 && dof <= static_cast<double>(max_table_dof)) {
+				auto& slot = quantile_table().t[row][static_cast<std::size_t>(dof)];
+				double v = slot.load(std::memory_order_relaxed);
+				if (v == 0.0) {
+					// Concurrent first uses may both compute; they store the same value
+					v = exact_t_quantile(table_probabilities[row], dof);
+					slot.store(v, std::memory_order_relaxed);
+				}
+				return v;
+			}
+
+			if (dof > static_cast<double>(max_table_dof)) {
+				double z;
+				if (row >= 0) {
+					auto& slot = quantile_table().z[row];
+					z = slot.load(std::memory_order_relaxed);
+					if (z == 0.0) {
+						z = normal_quantile(table_probabilities[row]);
+						slot.store(z, std::memory_order_relaxed);
+					}
+				}
+				else {
+					z = normal_quantile(p);
+				}
+				return cornish_fisher_t(z, dof);
+			}
+
+			auto& memo = quantile_memo();
+			const auto key = std::make_pair(p, dof);
+			{
+				std::shared_lock lock(memo.mutex);
+				if (auto it = memo.values.find(key); it != memo.values.end())
+					return it->second;
+			}
+			const double v = exact_t_quantile(p, dof);
+			std::unique_lock lock(memo.mutex);
+			if (memo.values.size() >= QuantileMemo::max_entries)
+				memo.values.clear();
+			if (memo.values.emplace(key, v).second)
+				LINREG_COUNT_ALLOCATION();
+			return v;
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Student-t quantile with caching (drop-in for t_quantile())
+	 * @param p Probability level (e.g., 0.975 for upper 2.5% tail)
+	 * @param m Degrees of freedom
+	 * @return The t-value at the specified probability level
+	 * @throws As boost::math::quantile() under its error policy (by default
+	 *         std::domain_error if p is NaN or outside [0, 1] or m <= 0, and
+	 *         std::overflow_error for p = 0 or 1)
+	 *
+	 * Thread-safe. Values are computed in double precision; long double
+	 * arguments bypass the cache and use Boost directly.
+	 *
+	 * Example:
+	 * @code
+	 * auto t = LinearRegression::t_quantile_cached(0.975, 28.0);   // 2.0484...
+	 * @endcode
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	T t_quantile_cached(T p, T m)
+	{
+		LINREG_STAGE(t_quantile, 0);
+
+		if constexpr (sizeof(T) > sizeof(double)) {
+			boost::math::students_t_distribution<T> dist(m);
+			return boost::math::quantile(dist, p);
+		}
+		else {
+			const auto pd = static_cast<double>(p);
+			const auto md = static_cast<double>(m);
+			// Invalid arguments (including NaN) go to Boost, which raises under its policy
+			if (!(pd > 0.0 && pd < 1.0) || !(md > 0.0))
+				return static_cast<T>(detail::exact_t_quantile(pd, md));
+			// The t-distribution is symmetric: t(p) = -t(1 - p)
+			if (pd > 0.5)
+				return static_cast<T>(detail::cached_upper_t_quantile(pd, md));
+			if (pd < 0.5)
+				return static_cast<T>(-detail::cached_upper_t_quantile(1.0 - pd, md));
+			return T{ 0 };
+		}
+	}
+
+} // namespace LinearRegression
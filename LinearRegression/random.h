@@ -0,0 +1,76 @@
+/**
+ * @file random.h
+ * @brief Counter-based random streams for reproducible parallel sampling
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Value k of stream s is a pure function of (seed, s, k), so parallel tasks
+ * draw from their own streams without shared generator state and results
+ * do not depend on the number of threads or the order in which tasks run.
+ *
+ * Example:
+ * @code
+ * const Stats::CounterRng rng(seed, task);   // one stream per task
+ * for (std::size_t k = 0; k < n; ++k)
+ *     idx[k] = Stats::detail::uniform_index(rng(k), n);
+ * @endcode
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace Stats {
+
+	namespace detail {
+
+		/// SplitMix64 finalizer: the z-th value of a counter-based random stream.
+		[[nodiscard]]
+		constexpr std::uint64_t splitmix64(std::uint64_t z) noexcept
+		{
+			z += 0x9E3779B97F4A7C15ULL;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		/// Uniform double in [0, 1) from 64 random bits.
+		[[nodiscard]]
+		constexpr double uniform01(std::uint64_t r) noexcept
+		{
+			return static_cast<double>(r >> 11) * 0x1.0p-53;
+		}
+
+		/// Uniform index in [0, n) from 64 random bits.
+		[[nodiscard]]
+		inline std::size_t uniform_index(std::uint64_t r, std::size_t n) noexcept
+		{
+			return std::min(static_cast<std::size_t>(uniform01(r) * static_cast<double>(n)), n - 1);
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Stateless random stream: operator()(k) is the k-th 64-bit value.
+	 *
+	 * Stream s of a seed is the SplitMix64 sequence started at a key derived
+	 * from (seed, s); distinct streams start at unrelated points of the
+	 * 2⁶⁴-periodic sequence.
+	 */
+	class CounterRng {
+	public:
+		constexpr CounterRng(std::uint64_t seed, std::uint64_t stream) noexcept
+			: key_(detail::splitmix64(seed ^ detail::splitmix64(stream)))
+		{
+		}
+
+		[[nodiscard]] constexpr std::uint64_t operator()(std::uint64_t k) const noexcept
+		{
+			return detail::splitmix64(key_ + k * 0x9E3779B97F4A7C15ULL);
+		}
+
+	private:
+		std::uint64_t key_;
+	};
+
+} // namespace Stats
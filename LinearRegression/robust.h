@@ -0,0 +1,604 @@
+/**
+ * @file robust.h
+ * @brief Outlier-resistant line fits: Theil–Sen and RANSAC
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Both estimators return the FitResult<T> of fit(), so they can replace it
+ * in existing code:
+ * - theil_sen(): slope = median of all pairwise slopes (yⱼ - yᵢ)/(xⱼ - xᵢ),
+ *   intercept = median of yᵢ - β₁xᵢ. Breakdown point ≈ 29%.
+ * - ransac(): best line through random point pairs by inlier count, then an
+ *   ordinary least-squares fit() of the inliers. Tolerates any outlier share
+ *   as long as the inliers form the largest consistent set.
+ *
+ * Theil–Sen without the O(n²) pair list: the number of pairs with slope < t
+ * equals the number of inversions of yᵢ - t·xᵢ in x order, which a merge sort
+ * counts in O(n log n). The median is bracketed with the quantiles of a random
+ * sample of pairs, the bracket is narrowed (interpolation, bisection as a
+ * fallback) until it holds O(n) slopes, and only those are enumerated.
+ * Memory stays O(n). Optionally, the median of a random sample of m pairs is
+ * returned instead; its rank (as a fraction of all pairs) is within
+ * ±√(ln(2/δ) / 2m) of ½ with probability 1 - δ.
+ *
+ * All random choices use a counter-based generator, so results depend on the
+ * seed only, not on the number of threads.
+ *
+ * Fields of the result: beta0/beta1 are the robust estimates, sse is the sum
+ * of squared residuals about that line; n, means, sums of squares and rho
+ * describe the data. For ransac() they describe the inliers only.
+ *
+ * @note ci_slope() assumes a least-squares fit; it does not apply to theil_sen().
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "arena.h"
+#include "execution.h"
+#include "linreg.h"
+#include "random.h"
+#include "stats.h"
+
+namespace LinearRegression {
+
+	/// @brief Options of theil_sen().
+	struct TheilSenOptions {
+		std::size_t samples = 0;                    ///< 0: exact median; otherwise median of this many random pairs
+		std::uint64_t seed = 0x2545F4914F6CDD1DULL;  ///< Seed of the pair sampling
+	};
+
+	/// @brief Options of ransac().
+	struct RansacOptions {
+		std::size_t max_iterations = 1000;          ///< Upper bound of candidate lines
+		double confidence = 0.99;                   ///< Stop once a better set is this unlikely to be missed
+		std::uint64_t seed = 0x2545F4914F6CDD1DULL;  ///< Seed of the candidate sampling
+	};
+
+	namespace detail {
+
+		using Stats::detail::splitmix64;
+		using Stats::detail::uniform_index;
+
+		template <typename T>
+		struct Keyed {
+			T key;
+			std::size_t index;
+		};
+
+		/**
+		 * Merges the sorted runs [lo, mid) and [mid, hi) of a by key. Whenever an
+		 * element r of the right run has a strictly smaller key than the remaining
+		 * left elements [l, mid), visit(r, a + l, a + mid) is called; the sum of
+		 * its results is returned.
+		 */
+		template <typename T, class Visit>
+		std::uint64_t merge_runs(Keyed<T>* a, Keyed<T>* buf, std::size_t lo, std::size_t mid, std::size_t hi,
+			Visit& visit)
+		{
+			std::uint64_t count = 0;
+			std::size_t i = lo, j = mid, k = lo;
+			while (i < mid && j < hi) {
+				if (a[j].key < a[i].key) {
+					count += visit(a[j], a + i, a + mid);
+					buf[k++] = a[j++];
+				}
+				else {
+					buf[k++] = a[i++];
+				}
+			}
+			std::copy(a + i, a + mid, buf + k);
+			std::copy(a + j, a + hi, buf + k + (mid - i));
+			std::copy(buf + lo, buf + hi, a + lo);
+			return count;
+		}
+
+		template <typename T, class Visit>
+		std::uint64_t merge_sort_runs(Keyed<T>* a, Keyed<T>* buf, std::size_t lo, std::size_t hi, Visit& visit)
+		{
+			if (hi - lo < 2)
+				return 0;
+			const auto mid = lo + (hi - lo) / 2;
+			return merge_sort_runs(a, buf, lo, mid, visit) + merge_sort_runs(a, buf, mid, hi, visit)
+				+ merge_runs(a, buf, lo, mid, hi, visit);
+		}
+
+		/// Leaf size of inversion_sort(): leaves are sorted independently.
+		inline constexpr std::size_t inversion_leaf = std::size_t{ 1 } << 13;
+
+		/**
+		 * Stable merge sort of a by key, calling visit for every inversion range
+		 * (see merge_runs()). Leaves and the merges of each level run as parallel
+		 * tasks; visit is copied into every task.
+		 */
+		template <typename T, Stats::ExecutionPolicy Policy, class Visit>
+		std::uint64_t inversion_sort(std::span<Keyed<T>> a, std::span<Keyed<T>> buf, const Policy& policy, Visit visit)
+		{
+			const auto n = a.size();
+			const auto leaves = (n + inversion_leaf - 1) / inversion_leaf;
+			std::vector<std::uint64_t> partial(leaves);
+			Stats::detail::bulk(policy, n, leaves, [&](std::size_t b) {
+				auto v = visit;
+				partial[b] = merge_sort_runs(a.data(), buf.data(), b * inversion_leaf,
+					std::min((b + 1) * inversion_leaf, n), v);
+			});
+			std::uint64_t count = std::accumulate(partial.begin(), partial.end(), std::uint64_t{ 0 });
+
+			for (std::size_t width = inversion_leaf; width < n; width *= 2) {
+				const auto pairs = (n + 2 * width - 1) / (2 * width);
+				partial.assign(pairs, 0);
+				Stats::detail::bulk(policy, n, pairs, [&](std::size_t p) {
+					auto v = visit;
+					const auto lo = p * 2 * width;
+					const auto mid = std::min(lo + width, n);
+					const auto hi = std::min(lo + 2 * width, n);
+					if (mid < hi)
+						partial[p] = merge_runs(a.data(), buf.data(), lo, mid, hi, v);
+				});
+				count = std::accumulate(partial.begin(), partial.end(), count);
+			}
+			return count;
+		}
+
+		/**
+		 * Pairwise slopes of points sorted by (x, y). Pairs with equal x have no
+		 * slope and are never counted.
+		 */
+		template <typename T, Stats::ExecutionPolicy Policy>
+		class SlopeSelector {
+		public:
+			SlopeSelector(std::span<const T> x, std::span<const T> y, const Policy& policy)
+				: x_(x.size()), y_(x.size()), keys_(x.size()), buf_(x.size()), policy_(policy)
+			{
+				std::vector<std::pair<T, T>> p(x.size());
+				for (std::size_t i = 0; i < x.size(); ++i)
+					p[i] = { x[i], y[i] };
+				std::sort(p.begin(), p.end());
+				std::uint64_t ties = 0;
+				for (std::size_t i = 0, run = 0; i < p.size(); ++i) {
+					x_[i] = p[i].first;
+					y_[i] = p[i].second;
+					run = (i > 0 && p[i].first == p[i - 1].first) ? run + 1 : 0;
+					ties += run;
+				}
+				const auto n = static_cast<std::uint64_t>(x.size());
+				pairs_ = n * (n - 1) / 2 - ties;
+			}
+
+			/// Number of pairs with distinct x.
+			[[nodiscard]] std::uint64_t pairs() const noexcept { return pairs_; }
+
+			/// Number of pairs with slope < t.
+			[[nodiscard]] std::uint64_t count_below(T t)
+			{
+				if (t == -std::numeric_limits<T>::infinity())
+					return 0;
+				if (t == std::numeric_limits<T>::infinity())
+					return pairs_;
+				const auto n = x_.size();
+				Stats::detail::bulk(policy_, n, (n + Stats::detail::par_chunk - 1) / Stats::detail::par_chunk,
+					[&](std::size_t c) {
+						const auto end = std::min((c + 1) * Stats::detail::par_chunk, n);
+						for (auto i = c * Stats::detail::par_chunk; i < end; ++i)
+							keys_[i] = { y_[i] - t * x_[i], i };
+					});
+				return inversion_sort(std::span<Keyed<T>>(keys_), std::span<Keyed<T>>(buf_), policy_,
+					[](const Keyed<T>&, const Keyed<T>* b, const Keyed<T>* e) {
+						return static_cast<std::uint64_t>(e - b);
+					});
+			}
+
+			/// Slopes in [lo, hi), in no particular order.
+			[[nodiscard]] std::vector<T> slopes_between(T lo, T hi)
+			{
+				// Order by yᵢ - lo·xᵢ (ties: by x); the pairs whose order flips at hi
+				// are exactly those with lo ≤ slope < hi
+				const auto n = x_.size();
+				for (std::size_t i = 0; i < n; ++i)
+					keys_[i] = { std::isinf(lo) ? T{ 0 } : y_[i] - lo * x_[i], i };
+				std::stable_sort(keys_.begin(), keys_.end(),
+					[](const Keyed<T>& a, const Keyed<T>& b) { return a.key < b.key; });
+				for (auto& k : keys_)
+					k.key = std::isinf(hi) ? -x_[k.index] : y_[k.index] - hi * x_[k.index];
+
+				std::vector<T> slopes;
+				inversion_sort(std::span<Keyed<T>>(keys_), std::span<Keyed<T>>(buf_), Stats::exec::seq,
+					[&](const Keyed<T>& r, const Keyed<T>* b, const Keyed<T>* e) {
+						for (; b != e; ++b) {
+							const T dx = x_[r.index] - x_[b->index];
+							if (dx > T{ 0 })
+								slopes.push_back((y_[r.index] - y_[b->index]) / dx);
+						}
+						return std::uint64_t{ 0 };
+					});
+				return slopes;
+			}
+
+			/// Slopes of m random pairs with distinct x, sorted.
+			[[nodiscard]] std::vector<T> sample(std::size_t m, std::uint64_t seed) const
+			{
+				constexpr std::size_t attempts = 64;
+				const auto n = x_.size();
+				std::vector<T> s(m, std::numeric_limits<T>::quiet_NaN());
+				Stats::detail::bulk(policy_, m, (m + 4095) / 4096, [&](std::size_t c) {
+					const auto end = std::min((c + 1) * 4096, m);
+					for (auto k = c * 4096; k < end; ++k) {
+						for (std::size_t a = 0; a < attempts; ++a) {
+							const auto ctr = seed + 2 * (k * attempts + a);
+							const auto i = uniform_index(splitmix64(ctr), n);
+							const auto j = uniform_index(splitmix64(ctr + 1), n);
+							if (x_[i] != x_[j]) {
+								s[k] = (y_[j] - y_[i]) / (x_[j] - x_[i]);
+								break;
+							}
+						}
+					}
+				});
+				s.erase(std::remove_if(s.begin(), s.end(), [](T v) { return std::isnan(v); }), s.end());
+				std::sort(s.begin(), s.end());
+				return s;
+			}
+
+			/// All slopes (small inputs only).
+			[[nodiscard]] std::vector<T> all() const
+			{
+				std::vector<T> s;
+				s.reserve(static_cast<std::size_t>(pairs_));
+				for (std::size_t i = 0; i < x_.size(); ++i)
+					for (std::size_t j = i + 1; j < x_.size(); ++j)
+						if (x_[j] != x_[i])
+							s.push_back((y_[j] - y_[i]) / (x_[j] - x_[i]));
+				return s;
+			}
+
+			/**
+			 * The k_lo-th and k_hi-th smallest slopes (0-based, k_lo <= k_hi <= k_lo + 1),
+			 * given sorted sample slopes. Candidates are enumerated once the bracket
+			 * holds at most cap pairs.
+			 */
+			[[nodiscard]] std::pair<T, T> select(std::uint64_t k_lo, std::uint64_t k_hi,
+				const std::vector<T>& sample_slopes, std::uint64_t cap)
+			{
+				constexpr T inf = std::numeric_limits<T>::infinity();
+				const auto m = static_cast<double>(sample_slopes.size());
+				const auto r = (static_cast<double>(k_lo) + 0.5) / static_cast<double>(pairs_) * m;
+				const auto delta = 3.0 * std::sqrt(m) + 2.0;
+				const auto ilo = std::floor(r - delta), ihi = std::ceil(r + delta);
+				T lo = ilo < 0.0 ? -inf : sample_slopes[static_cast<std::size_t>(ilo)];
+				T hi = ihi >= m ? inf : sample_slopes[static_cast<std::size_t>(ihi)];
+
+				// Make sure count_below(lo) <= k_lo and k_hi < count_below(hi); the sample misses rarely
+				auto below_lo = count_below(lo);
+				if (below_lo > k_lo) {
+					hi = lo;
+					lo = -inf;
+					below_lo = 0;
+				}
+				auto below_hi = count_below(hi);
+				if (below_hi <= k_hi) {
+					lo = hi;
+					below_lo = below_hi;
+					hi = inf;
+					below_hi = pairs_;
+				}
+				return narrow(k_lo, k_hi, lo, hi, below_lo, below_hi, cap);
+			}
+
+		private:
+			/**
+			 * Shrinks [lo, hi) around the requested ranks, then selects among the
+			 * enumerated candidates. Each round probes the interpolated positions of
+			 * ranks k_lo - cap/4 and k_hi + cap/4 (the counts grow roughly linearly
+			 * inside a narrow bracket) and falls back to bisection if that did not
+			 * halve the bracket.
+			 */
+			[[nodiscard]] std::pair<T, T> narrow(std::uint64_t k_lo, std::uint64_t k_hi, T lo, T hi,
+				std::uint64_t below_lo, std::uint64_t below_hi, std::uint64_t cap)
+			{
+				// Returns the count at t if t was probed and lies between the ranks
+				std::uint64_t split_count = 0;
+				T split_at{};
+				const auto probe = [&](T t) {
+					if (!(t > lo && t < hi))
+						return false;
+					const auto c = count_below(t);
+					if (c <= k_lo) {
+						lo = t;
+						below_lo = c;
+					}
+					else if (c > k_hi) {
+						hi = t;
+						below_hi = c;
+					}
+					else {
+						split_count = c;
+						split_at = t;
+					}
+					return true;
+				};
+				const auto interpolate = [&](double rank) {
+					const auto f = (rank - static_cast<double>(below_lo)) / static_cast<double>(below_hi - below_lo);
+					return lo + (hi - lo) * static_cast<T>(std::clamp(f, 0.0, 1.0));
+				};
+
+				const auto margin = static_cast<double>(cap) / 4.0;
+				for (int iter = 0; below_hi - below_lo > cap && iter < 256 && split_count == 0; ++iter) {
+					const auto before = below_hi - below_lo;
+					if (!std::isinf(lo) && !std::isinf(hi)) {
+						probe(interpolate(static_cast<double>(k_lo) - margin));
+						if (split_count == 0 && below_hi - below_lo > cap)
+							probe(interpolate(static_cast<double>(k_hi) + margin));
+					}
+					if (split_count == 0 && below_hi - below_lo > before / 2 && !probe(split(lo, hi)))
+						return { lo, lo };  // adjacent values: every candidate rounds to lo
+				}
+
+				if (split_count != 0) {
+					// k_lo-th slope < split_at <= k_hi-th slope: select each on its side
+					return { narrow(k_lo, k_lo, lo, split_at, below_lo, split_count, cap).first,
+						narrow(k_hi, k_hi, split_at, hi, split_count, below_hi, cap).first };
+				}
+
+				auto s = slopes_between(lo, hi);
+				if (s.empty())
+					return { lo, lo };
+				const auto j_lo = std::min(static_cast<std::size_t>(k_lo - below_lo), s.size() - 1);
+				const auto j_hi = std::min(static_cast<std::size_t>(k_hi - below_lo), s.size() - 1);
+				std::nth_element(s.begin(), s.begin() + static_cast<std::ptrdiff_t>(j_lo), s.end());
+				const T v_lo = s[j_lo];
+				const T v_hi = j_hi == j_lo ? v_lo
+					: *std::min_element(s.begin() + static_cast<std::ptrdiff_t>(j_lo) + 1, s.end());
+				return { v_lo, v_hi };
+			}
+
+			/// Bisection point of [lo, hi]; steps outward from a finite end if the other is infinite.
+			[[nodiscard]] static T split(T lo, T hi) noexcept
+			{
+				if (std::isinf(lo) && std::isinf(hi))
+					return T{ 0 };
+				if (std::isinf(lo))
+					return hi - std::max(std::abs(hi), T{ 1 });
+				if (std::isinf(hi))
+					return lo + std::max(std::abs(lo), T{ 1 });
+				return std::midpoint(lo, hi);
+			}
+
+			std::vector<T> x_, y_;
+			std::vector<Keyed<T>> keys_, buf_;
+			std::uint64_t pairs_ = 0;
+			const Policy& policy_;
+		};
+
+		/// Median of v (reorders v).
+		template <typename T>
+		[[nodiscard]]
+		T median_inplace(std::span<T> v)
+		{
+			const auto mid = v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2);
+			std::nth_element(v.begin(), mid, v.end());
+			if (v.size() % 2 == 1)
+				return *mid;
+			return std::midpoint(*std::max_element(v.begin(), mid), *mid);
+		}
+
+		/// FitResult of the line (beta0, beta1) on the data (x, y).
+		template <typename T, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		FitResult<T> line_result(std::span<const T> x, std::span<const T> y, T beta0, T beta1, const Policy& policy)
+		{
+			const auto m = Stats::co_moments(x, y, policy);
+			auto fitResult = FitResult<T>{};
+			fitResult.n = m.n;
+			fitResult.mean_x = m.mean_x;
+			fitResult.mean_y = m.mean_y;
+			fitResult.sxx = m.sxx;
+			fitResult.syy = m.syy;
+			fitResult.sxy = m.sxy;
+			fitResult.beta0 = beta0;
+			fitResult.beta1 = beta1;
+			fitResult.rho = m.sxy / std::sqrt(m.sxx * m.syy);
+			fitResult.sse = Stats::detail::chunked_reduce(policy, x.size(), T{},
+				[beta0, beta1, px = x.data(), py = y.data()](std::size_t begin, std::size_t len) {
+					T acc{};
+					for (std::size_t i = begin; i < begin + len; ++i) {
+						const T r = py[i] - (beta0 + beta1 * px[i]);
+						acc += r * r;
+					}
+					return acc;
+				});
+			return fitResult;
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Theil–Sen estimator: median of all pairwise slopes
+	 * @tparam T Floating-point type
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @param options Exact (default) or sampled median, and the sampling seed
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @return FitResult<T> of the robust line (see file comment)
+	 *
+	 * Exact mode runs in O(n log n) expected time and O(n) memory; for an even
+	 * number of pairs the slope is the mean of the two middle slopes. Pairs
+	 * with equal x are ignored.
+	 *
+	 * @note Returns empty FitResult under the same conditions as fit(): fewer
+	 *       than 3 data points, sizes differ, or all x are equal.
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	FitResult<T> theil_sen(std::span<const T> x, std::span<const T> y, const TheilSenOptions& options = {},
+		const Policy& policy = {})
+	{
+		if (x.size() != y.size() || x.size() < 3)
+			return {};
+
+		detail::SlopeSelector<T, Policy> slopes(x, y, policy);
+		const auto pairs = slopes.pairs();
+		if (pairs == 0)
+			return {};
+
+		const auto lo_rank = (pairs - 1) / 2, hi_rank = pairs / 2;
+		const auto cap = std::max<std::uint64_t>(4 * x.size(), std::uint64_t{ 1 } << 16);
+		T beta1{};
+		if (options.samples > 0) {
+			auto s = slopes.sample(options.samples, options.seed);
+			if (s.empty())
+				return {};
+			beta1 = detail::median_inplace(std::span<T>(s));
+		}
+		else if (pairs <= cap) {
+			// Small input: the pair list is short enough to select directly
+			auto s = slopes.all();
+			beta1 = detail::median_inplace(std::span<T>(s));
+		}
+		else {
+			const auto m = static_cast<std::size_t>(std::clamp<std::uint64_t>(
+				x.size(), std::uint64_t{ 1 } << 12, std::uint64_t{ 1 } << 20));
+			const auto sample = slopes.sample(m, options.seed);
+			const auto [below, above] = slopes.select(lo_rank, hi_rank, sample, cap);
+			beta1 = std::midpoint(below, above);
+		}
+
+		// Intercept: median of the residuals about the robust slope
+		Stats::ScratchScope scratch;
+		std::pmr::vector<T> r(x.size(), scratch.resource());
+		for (std::size_t i = 0; i < x.size(); ++i)
+			r[i] = y[i] - beta1 * x[i];
+		const auto beta0 = detail::median_inplace(std::span<T>(r));
+
+		return detail::line_result(x, y, beta0, beta1, policy);
+	}
+
+	/// @brief Container overload for theil_sen function
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	FitResult<typename C::value_type> theil_sen(const C& x, const C& y, const TheilSenOptions& options = {},
+		const Policy& policy = {})
+	{
+		return theil_sen(Helper::as_span(x), Helper::as_span(y), options, policy);
+	}
+
+	/**
+	 * @brief RANSAC line fit with a least-squares refit of the inliers
+	 * @tparam T Floating-point type
+	 * @param x Independent variable values
+	 * @param y Dependent variable values
+	 * @param threshold A point is an inlier if |y - (β₀ + β₁x)| <= threshold
+	 * @param options Iteration bound, confidence and seed
+	 * @param policy Execution policy (default: Stats::exec::automatic)
+	 * @return fit() of the final inlier set (n = number of inliers)
+	 *
+	 * Candidate lines through two random points are scored in parallel batches;
+	 * after each batch the number of iterations still needed for the requested
+	 * confidence is updated from the best inlier ratio w, as log(1 - p) / log(1 - w²).
+	 * The inliers of the best candidate are refitted with fit(), and the
+	 * inlier set is recomputed from the refitted line until it stops changing.
+	 *
+	 * @note Returns empty FitResult if the sizes differ, there are fewer than
+	 *       3 points or inliers, or threshold is not positive.
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	FitResult<T> ransac(std::span<const T> x, std::span<const T> y, const T threshold,
+		const RansacOptions& options = {}, const Policy& policy = {})
+	{
+		const auto n = x.size();
+		if (y.size() != n || n < 3 || !(threshold > T{ 0 }) || options.max_iterations == 0)
+			return {};
+
+		const auto inliers_of = [&](T b0, T b1) {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i)
+				count += std::abs(y[i] - (b0 + b1 * x[i])) <= threshold;
+			return count;
+		};
+
+		// Score candidates batch by batch; every candidate depends only on its index
+		constexpr std::size_t batch = 64;
+		std::vector<std::size_t> scores(batch);
+		std::vector<std::pair<T, T>> lines(batch);
+		std::size_t best = 0, needed = options.max_iterations;
+		std::pair<T, T> best_line{};
+		for (std::size_t done = 0; done < std::min(needed, options.max_iterations); done += batch) {
+			const auto count = std::min(batch, options.max_iterations - done);
+			Stats::detail::bulk(policy, n * count, count, [&](std::size_t c) {
+				const auto ctr = options.seed + 2 * (done + c);
+				const auto i = detail::uniform_index(detail::splitmix64(ctr), n);
+				const auto j = detail::uniform_index(detail::splitmix64(ctr + 1), n);
+				scores[c] = 0;
+				if (x[i] == x[j])
+					return;
+				const T b1 = (y[j] - y[i]) / (x[j] - x[i]);
+				const T b0 = y[i] - b1 * x[i];
+				lines[c] = { b0, b1 };
+				scores[c] = inliers_of(b0, b1);
+			});
+			for (std::size_t c = 0; c < count; ++c)
+				if (scores[c] > best) {
+					best = scores[c];
+					best_line = lines[c];
+				}
+
+			const double w = static_cast<double>(best) / static_cast<double>(n);
+			if (w >= 1.0)
+				break;
+			if (w > 0.0) {
+				const double k = std::log(1.0 - options.confidence) / std::log(1.0 - w * w);
+				needed = k < static_cast<double>(options.max_iterations)
+					? static_cast<std::size_t>(std::ceil(k)) : options.max_iterations;
+			}
+		}
+		if (best < 3)
+			return {};
+
+		// Least-squares refits of the inlier set, until it stops changing
+		Stats::ScratchScope scratch;
+		std::pmr::vector<T> xi(scratch.resource()), yi(scratch.resource());
+		xi.reserve(best + best / 8);
+		yi.reserve(best + best / 8);
+		auto [b0, b1] = best_line;
+		FitResult<T> result{};
+		for (int round = 0; round < 8; ++round) {
+			xi.clear();
+			yi.clear();
+			for (std::size_t i = 0; i < n; ++i)
+				if (std::abs(y[i] - (b0 + b1 * x[i])) <= threshold) {
+					xi.push_back(x[i]);
+					yi.push_back(y[i]);
+				}
+			if (xi.size() < 3 || (round > 0 && xi.size() == result.n))
+				break;
+			const auto refit = fit(std::span<const T>(xi), std::span<const T>(yi), policy);
+			if (refit.n == 0)
+				break;
+			result = refit;
+			b0 = result.beta0;
+			b1 = result.beta1;
+		}
+		return result;
+	}
+
+	/// @brief Container overload for ransac function
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	FitResult<typename C::value_type> ransac(const C& x, const C& y, const typename C::value_type threshold,
+		const RansacOptions& options = {}, const Policy& policy = {})
+	{
+		return ransac(Helper::as_span(x), Helper::as_span(y), threshold, options, policy);
+	}
+
+} // namespace LinearRegression
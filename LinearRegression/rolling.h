@@ -0,0 +1,222 @@
+/**
+ * @file rolling.h
+ * @brief Sliding-window linear regression for time series
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * Two rolling engines built on Stats::CoMoments:
+ * - RollingFit: the last N points (count-based window)
+ * - TimeWindowFit: all points whose time stamp lies within a fixed duration
+ *
+ * Every new sample updates slope, intercept and correlation in O(1): the
+ * departing point's contribution is removed with an inverse Welford update
+ * instead of refitting the whole window. To keep the rounding drift of
+ * repeated add/remove pairs bounded, the moments are recomputed from the
+ * window contents after every window-length of evictions, which keeps the
+ * amortized cost per sample O(1).
+ */
+
+#pragma once
+
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "stats.h"
+#include "linreg.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Least-squares fit over the last N points
+	 * @tparam T Floating-point type
+	 *
+	 * The window is a fixed-capacity ring buffer allocated once on construction.
+	 *
+	 * Example:
+	 * @code
+	 * LinearRegression::RollingFit<double> trend(60);   // last 60 samples
+	 * for (auto [t, v] : samples) {
+	 *     trend.push(t, v);
+	 *     if (trend.full() && trend.result().beta1 > limit) alert();
+	 * }
+	 * @endcode
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	class RollingFit {
+	public:
+		/**
+		 * @param window Number of points in the window
+		 * @throws std::invalid_argument if window is 0
+		 */
+		explicit RollingFit(std::size_t window)
+			: x_(window), y_(window)
+		{
+			if (window == 0)
+				throw std::invalid_argument("RollingFit: window must not be empty");
+		}
+
+		/// @brief Adds a point and evicts the oldest one once the window is full (amortized O(1)).
+		void push(T x, T y)
+		{
+			if (count_ == capacity()) {
+				moments_.pop(x_[head_], y_[head_]);
+				x_[head_] = x;
+				y_[head_] = y;
+				moments_.push(x, y);
+				head_ = (head_ + 1) % capacity();
+				if (++evictions_ >= capacity())
+					rebuild();
+				return;
+			}
+			const auto pos = (head_ + count_) % capacity();
+			x_[pos] = x;
+			y_[pos] = y;
+			moments_.push(x, y);
+			++count_;
+		}
+
+		/// @brief Regression statistics of the current window (see fit_from_moments()).
+		[[nodiscard]]
+		FitResult<T> result() const
+		{
+			return fit_from_moments(moments_);
+		}
+
+		/// @brief Sufficient statistics of the current window.
+		[[nodiscard]]
+		const Stats::CoMoments<T>& moments() const noexcept { return moments_; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return count_; }
+		[[nodiscard]] std::size_t capacity() const noexcept { return x_.size(); }
+		[[nodiscard]] bool full() const noexcept { return count_ == capacity(); }
+
+		/// @brief Empties the window, keeping its capacity.
+		void clear() noexcept
+		{
+			moments_ = {};
+			head_ = count_ = evictions_ = 0;
+		}
+
+		/// @brief Recomputes the moments exactly from the window contents.
+		void rebuild()
+		{
+			// The ring holds at most two contiguous segments
+			const auto first = std::min(count_, capacity() - head_);
+			const auto xs = std::span<const T>(x_);
+			const auto ys = std::span<const T>(y_);
+			moments_ = Stats::co_moments(xs.subspan(head_, first), ys.subspan(head_, first));
+			moments_.merge(Stats::co_moments(xs.first(count_ - first), ys.first(count_ - first)));
+			evictions_ = 0;
+		}
+
+	private:
+		std::vector<T> x_;
+		std::vector<T> y_;
+		std::size_t head_{};       ///< Index of the oldest point
+		std::size_t count_{};      ///< Number of points in the window
+		std::size_t evictions_{};  ///< Removals since the last rebuild
+		Stats::CoMoments<T> moments_{};
+	};
+
+	/**
+	 * @brief Least-squares fit over all points within a time span
+	 * @tparam T Floating-point type
+	 *
+	 * Points are (t, y) pairs with the time stamp as regressor. A point is kept
+	 * while t > t_latest - duration. Time stamps must be non-decreasing.
+	 * Large absolute time stamps (e.g. Unix time) are fine because all
+	 * statistics are kept centered.
+	 *
+	 * Example:
+	 * @code
+	 * LinearRegression::TimeWindowFit<double> trend(300.0);   // last 5 minutes
+	 * trend.push(now, value);
+	 * auto slope = trend.result().beta1;
+	 * @endcode
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	class TimeWindowFit {
+	public:
+		/**
+		 * @param duration Length of the time window (same unit as the time stamps)
+		 * @throws std::invalid_argument if duration is not positive
+		 */
+		explicit TimeWindowFit(T duration)
+			: duration_(duration)
+		{
+			if (!(duration > T{ 0 }))
+				throw std::invalid_argument("TimeWindowFit: duration must be positive");
+		}
+
+		/**
+		 * @brief Adds a sample and expires all samples that left the window (amortized O(1)).
+		 * @throws std::invalid_argument if t is older than the latest sample.
+		 */
+		void push(T t, T y)
+		{
+			if (!points_.empty() && t < points_.back().t)
+				throw std::invalid_argument("TimeWindowFit::push: time stamps must be non-decreasing");
+			points_.push_back({ t, y });
+			moments_.push(t, y);
+			advance(t);
+		}
+
+		/// @brief Expires samples older than now - duration without adding a new one.
+		void advance(T now)
+		{
+			while (!points_.empty() && points_.front().t <= now - duration_) {
+				moments_.pop(points_.front().t, points_.front().y);
+				points_.pop_front();
+				++evictions_;
+			}
+			if (evictions_ >= points_.size() && evictions_ > 0)
+				rebuild();
+		}
+
+		/// @brief Regression statistics of the current window (see fit_from_moments()).
+		[[nodiscard]]
+		FitResult<T> result() const
+		{
+			return fit_from_moments(moments_);
+		}
+
+		/// @brief Sufficient statistics of the current window.
+		[[nodiscard]]
+		const Stats::CoMoments<T>& moments() const noexcept { return moments_; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return points_.size(); }
+		[[nodiscard]] T duration() const noexcept { return duration_; }
+
+		/// @brief Empties the window.
+		void clear() noexcept
+		{
+			points_.clear();
+			moments_ = {};
+			evictions_ = 0;
+		}
+
+		/// @brief Recomputes the moments exactly from the window contents.
+		void rebuild() noexcept
+		{
+			moments_ = {};
+			for (const auto& p : points_)
+				moments_.push(p.t, p.y);
+			evictions_ = 0;
+		}
+
+	private:
+		struct Point {
+			T t;
+			T y;
+		};
+
+		T duration_;
+		std::deque<Point> points_;
+		std::size_t evictions_{};  ///< Removals since the last rebuild
+		Stats::CoMoments<T> moments_{};
+	};
+
+} // namespace LinearRegression
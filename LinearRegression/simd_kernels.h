@@ -0,0 +1,2264 @@
+/**
+ * @file simd_kernels.h
+ * @brief Hand-vectorized reduction kernels with runtime ISA dispatch.
+ *
+ * Kernels:
+ * - sum(x)                    Σxᵢ
+ * - sum2(x, y)                Σxᵢ and Σyᵢ in one pass
+ * - dot(x, y)                 Σxᵢyᵢ
+ * - centered_sums(x, y, a, b) Σdx, Σdy, Σdx², Σdy², Σdx·dy with dx = x - a, dy = y - b
+ * - weighted_sums(w, x, y)    Σwᵢ, Σwᵢxᵢ and Σwᵢyᵢ in one pass
+ * - weighted_centered_sums(w, x, y, a, b)  centered_sums() with every term weighted by wᵢ
+ *
+ * Elementwise kernels (prediction, see predict.h):
+ * - affine(x, a, b, out)      outᵢ = a + b·xᵢ
+ * - bands(x, c, out)          fitted value with confidence and prediction band
+ * - diagnostics(x, y, c, out)  residual, leverage, standardized residual and
+ *                              Cook's distance, reducing SSE, Durbin-Watson sum
+ *                              and max |residual| on the way (see diagnostics.h)
+ *
+ * Paths: AVX-512F and AVX2+FMA on x86-64 (selected at runtime from CPUID),
+ * NEON on AArch64 (always available), and a portable scalar fallback.
+ * Every path keeps several independent accumulators so the loop is limited
+ * by load bandwidth rather than by the latency of the add/FMA chain.
+ *
+ * Every reduction kernel takes a storage type T and an accumulator type Acc (default:
+ * T). Elements are widened to Acc on load, so float data can be summed in
+ * double at float memory bandwidth (mixed precision).
+ *
+ * Notes:
+ * - float and double are vectorized, as is float storage with double
+ *   accumulation; other combinations use the scalar path.
+ * - The summation order differs from a plain loop, so results may differ
+ *   in the last bits from std::reduce.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LINREG_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define LINREG_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang need a per-function target to emit AVX code without global -mavx2;
+// MSVC accepts the intrinsics in any function.
+#if defined(LINREG_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LINREG_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define LINREG_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#else
+#define LINREG_TARGET_AVX2
+#define LINREG_TARGET_AVX512
+#endif
+
+namespace Stats::simd {
+
+	/// @brief Instruction set used by the kernels.
+	enum class Isa {
+		scalar,
+		avx2,    ///< AVX2 + FMA, 256-bit
+		avx512,  ///< AVX-512F, 512-bit
+		neon     ///< AArch64 Advanced SIMD, 128-bit
+	};
+
+	/// @brief Printable name of an instruction set.
+	[[nodiscard]]
+	constexpr const char* isa_name(Isa isa) noexcept
+	{
+		switch (isa) {
+		case Isa::avx2:   return "avx2";
+		case Isa::avx512: return "avx512";
+		case Isa::neon:   return "neon";
+		default:          return "scalar";
+		}
+	}
+
+	/// @brief Result of centered_sums().
+	template <std::floating_point T>
+	struct CenteredSums {
+		T dx{};   ///< Σ(xᵢ - a)
+		T dy{};   ///< Σ(yᵢ - b)
+		T dxx{};  ///< Σ(xᵢ - a)²
+		T dyy{};  ///< Σ(yᵢ - b)²
+		T dxy{};  ///< Σ(xᵢ - a)(yᵢ - b)
+	};
+
+	/**
+	 * @brief Coefficients of bands().
+	 *
+	 * With d = x - mean_x and q = inv_n + d²·inv_sxx, the half-widths are
+	 * ts·√q (confidence band of the mean) and ts·√(1 + q) (prediction band).
+	 */
+	template <std::floating_point T>
+	struct BandCoefficients {
+		T beta0{};    ///< Intercept
+		T beta1{};    ///< Slope
+		T mean_x{};   ///< x̄ of the fitted data
+		T inv_n{};    ///< 1 / n
+		T inv_sxx{};  ///< 1 / Sxx
+		T ts{};       ///< t quantile × residual standard error
+	};
+
+	/// @brief Output rows of bands(), each holding n elements.
+	template <std::floating_point T>
+	struct BandRows {
+		T* fit;
+		T* ci_lower;
+		T* ci_upper;
+		T* pi_lower;
+		T* pi_upper;
+
+		/// @brief The same rows, starting at element i.
+		[[nodiscard]] BandRows at(std::size_t i) const noexcept
+		{
+			return { fit + i, ci_lower + i, ci_upper + i, pi_lower + i, pi_upper + i };
+		}
+	};
+
+	/**
+	 * @brief Coefficients of diagnostics().
+	 *
+	 * With eᵢ = yᵢ - β₀ - β₁xᵢ and d = xᵢ - mean_x, the leverage is
+	 * hᵢ = inv_n + d²·inv_sxx, the standardized residual rᵢ = eᵢ·inv_s / √(1 - hᵢ)
+	 * and Cook's distance Dᵢ = rᵢ²·hᵢ / (2(1 - hᵢ)).
+	 */
+	template <std::floating_point T>
+	struct DiagnosticCoefficients {
+		T beta0{};    ///< Intercept
+		T beta1{};    ///< Slope
+		T mean_x{};   ///< x̄ of the fitted data
+		T inv_n{};    ///< 1 / n
+		T inv_sxx{};  ///< 1 / Sxx
+		T inv_s{};    ///< 1 / residual standard error
+	};
+
+	/// @brief Output rows of diagnostics(), each holding n elements; null rows are not written.
+	template <std::floating_point T>
+	struct DiagnosticRows {
+		T* residual;
+		T* leverage;
+		T* standardized;
+		T* cooks_distance;
+
+		/// @brief The same rows, starting at element i.
+		[[nodiscard]] DiagnosticRows at(std::size_t i) const noexcept
+		{
+			const auto shift = [i](T* row) { return row ? row + i : nullptr; };
+			return { shift(residual), shift(leverage), shift(standardized), shift(cooks_distance) };
+		}
+	};
+
+	/// @brief Result of diagnostics().
+	template <std::floating_point T>
+	struct DiagnosticSums {
+		T sse{};      ///< Σeᵢ²
+		T dw{};       ///< Σ(eᵢ - eᵢ₋₁)² over the consecutive pairs
+		T max_abs{};  ///< max |eᵢ|
+
+		constexpr DiagnosticSums operator+(const DiagnosticSums& o) const noexcept
+		{
+			return { sse + o.sse, dw + o.dw, max_abs > o.max_abs ? max_abs : o.max_abs };
+		}
+	};
+
+	namespace detail {
+
+		/// @brief Best instruction set supported by CPU and operating system.
+		[[nodiscard]]
+		inline Isa detect_isa() noexcept
+		{
+#if defined(LINREG_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+			int info[4]{};
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			const bool fma = (info[2] & (1 << 12)) != 0;
+			if (!(osxsave && avx && fma))
+				return Isa::scalar;
+			const auto xcr0 = _xgetbv(0);
+			if ((xcr0 & 0x6) != 0x6)
+				return Isa::scalar;
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6)
+				return Isa::avx512;
+			if ((info[1] & (1 << 5)) != 0)
+				return Isa::avx2;
+			return Isa::scalar;
+#elif defined(LINREG_SIMD_X86)
+			// __builtin_cpu_supports also checks that the OS saves the register state
+			if (__builtin_cpu_supports("avx512f"))
+				return Isa::avx512;
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return Isa::avx2;
+			return Isa::scalar;
+#elif defined(LINREG_SIMD_NEON)
+			return Isa::neon;
+#else
+			return Isa::scalar;
+#endif
+		}
+
+		[[nodiscard]]
+		inline std::atomic<Isa>& isa_state() noexcept
+		{
+			static std::atomic<Isa> isa{ detect_isa() };
+			return isa;
+		}
+
+		// ---------------------------------------------------------------
+		// Scalar fallback: four independent accumulators
+		// Storage type T, accumulation in Acc (each element is widened on load)
+		// ---------------------------------------------------------------
+
+		template <std::floating_point T, std::floating_point Acc = T>
+		[[nodiscard]]
+		Acc sum_scalar(const T* x, std::size_t n) noexcept
+		{
+			Acc a0{}, a1{}, a2{}, a3{};
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				a0 += static_cast<Acc>(x[i]);
+				a1 += static_cast<Acc>(x[i + 1]);
+				a2 += static_cast<Acc>(x[i + 2]);
+				a3 += static_cast<Acc>(x[i + 3]);
+			}
+			for (; i < n; ++i)
+				a0 += static_cast<Acc>(x[i]);
+			return (a0 + a1) + (a2 + a3);
+		}
+
+		template <std::floating_point T, std::floating_point Acc>
+		void sum2_scalar(const T* x, const T* y, std::size_t n, Acc& sx, Acc& sy) noexcept
+		{
+			Acc x0{}, x1{}, y0{}, y1{};
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				x0 += static_cast<Acc>(x[i]);
+				y0 += static_cast<Acc>(y[i]);
+				x1 += static_cast<Acc>(x[i + 1]);
+				y1 += static_cast<Acc>(y[i + 1]);
+			}
+			for (; i < n; ++i) {
+				x0 += static_cast<Acc>(x[i]);
+				y0 += static_cast<Acc>(y[i]);
+			}
+			sx = x0 + x1;
+			sy = y0 + y1;
+		}
+
+		template <std::floating_point T, std::floating_point Acc = T>
+		[[nodiscard]]
+		Acc dot_scalar(const T* x, const T* y, std::size_t n) noexcept
+		{
+			Acc a0{}, a1{}, a2{}, a3{};
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				a0 += static_cast<Acc>(x[i]) * static_cast<Acc>(y[i]);
+				a1 += static_cast<Acc>(x[i + 1]) * static_cast<Acc>(y[i + 1]);
+				a2 += static_cast<Acc>(x[i + 2]) * static_cast<Acc>(y[i + 2]);
+				a3 += static_cast<Acc>(x[i + 3]) * static_cast<Acc>(y[i + 3]);
+			}
+			for (; i < n; ++i)
+				a0 += static_cast<Acc>(x[i]) * static_cast<Acc>(y[i]);
+			return (a0 + a1) + (a2 + a3);
+		}
+
+		template <std::floating_point T, std::floating_point Acc>
+		[[nodiscard]]
+		CenteredSums<Acc> centered_sums_scalar(const T* x, const T* y, std::size_t n, Acc a, Acc b) noexcept
+		{
+			CenteredSums<Acc> s0{}, s1{};
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				const Acc dx0 = static_cast<Acc>(x[i]) - a, dy0 = static_cast<Acc>(y[i]) - b;
+				const Acc dx1 = static_cast<Acc>(x[i + 1]) - a, dy1 = static_cast<Acc>(y[i + 1]) - b;
+				s0.dx += dx0;  s1.dx += dx1;
+				s0.dy += dy0;  s1.dy += dy1;
+				s0.dxx += dx0 * dx0;  s1.dxx += dx1 * dx1;
+				s0.dyy += dy0 * dy0;  s1.dyy += dy1 * dy1;
+				s0.dxy += dx0 * dy0;  s1.dxy += dx1 * dy1;
+			}
+			for (; i < n; ++i) {
+				const Acc dx = static_cast<Acc>(x[i]) - a, dy = static_cast<Acc>(y[i]) - b;
+				s0.dx += dx;
+				s0.dy += dy;
+				s0.dxx += dx * dx;
+				s0.dyy += dy * dy;
+				s0.dxy += dx * dy;
+			}
+			return { s0.dx + s1.dx, s0.dy + s1.dy, s0.dxx + s1.dxx, s0.dyy + s1.dyy, s0.dxy + s1.dxy };
+		}
+
+		// The weighted kernels mask out points with wᵢ = 0 instead of computing
+		// 0·xᵢ, so a NaN or ±inf in a dropped point does not reach the sums
+		// (as WeightedCoMoments::push() skips it).
+
+		/// wᵢ·vᵢ, or 0 for a point with wᵢ = 0.
+		template <std::floating_point T, std::floating_point Acc>
+		[[nodiscard]]
+		constexpr Acc weighted_term(Acc w, T v) noexcept
+		{
+			return w > Acc{ 0 } ? w * static_cast<Acc>(v) : Acc{ 0 };
+		}
+
+		template <std::floating_point T, std::floating_point Acc>
+		void weighted_sums_scalar(const T* w, const T* x, const T* y, std::size_t n,
+			Acc& sw, Acc& swx, Acc& swy) noexcept
+		{
+			Acc w0{}, w1{}, x0{}, x1{}, y0{}, y1{};
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				const Acc wa = static_cast<Acc>(w[i]), wb = static_cast<Acc>(w[i + 1]);
+				w0 += wa;  w1 += wb;
+				x0 += weighted_term(wa, x[i]);  x1 += weighted_term(wb, x[i + 1]);
+				y0 += weighted_term(wa, y[i]);  y1 += weighted_term(wb, y[i + 1]);
+			}
+			for (; i < n; ++i) {
+				const Acc wa = static_cast<Acc>(w[i]);
+				w0 += wa;
+				x0 += weighted_term(wa, x[i]);
+				y0 += weighted_term(wa, y[i]);
+			}
+			sw = w0 + w1;
+			swx = x0 + x1;
+			swy = y0 + y1;
+		}
+
+		template <std::floating_point T, std::floating_point Acc>
+		[[nodiscard]]
+		CenteredSums<Acc> weighted_centered_sums_scalar(const T* w, const T* x, const T* y, std::size_t n,
+			Acc a, Acc b) noexcept
+		{
+			CenteredSums<Acc> s{};
+			for (std::size_t i = 0; i < n; ++i) {
+				const Acc wi = static_cast<Acc>(w[i]);
+				if (!(wi > Acc{ 0 }))
+					continue;
+				const Acc dx = static_cast<Acc>(x[i]) - a, dy = static_cast<Acc>(y[i]) - b;
+				const Acc wdx = wi * dx, wdy = wi * dy;
+				s.dx += wdx;
+				s.dy += wdy;
+				s.dxx += wdx * dx;
+				s.dyy += wdy * dy;
+				s.dxy += wdx * dy;
+			}
+			return s;
+		}
+
+		template <std::floating_point T>
+		void affine_scalar(const T* x, std::size_t n, T a, T b, T* out) noexcept
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				out[i] = a + b * x[i];
+		}
+
+		template <std::floating_point T>
+		void bands_scalar(const T* x, std::size_t n, const BandCoefficients<T>& c, const BandRows<T>& o) noexcept
+		{
+			for (std::size_t i = 0; i < n; ++i) {
+				const T yhat = c.beta0 + c.beta1 * x[i];
+				const T d = x[i] - c.mean_x;
+				const T q = c.inv_n + d * d * c.inv_sxx;
+				const T hc = c.ts * std::sqrt(q);
+				const T hp = c.ts * std::sqrt(T{ 1 } + q);
+				o.fit[i] = yhat;
+				o.ci_lower[i] = yhat - hc;
+				o.ci_upper[i] = yhat + hc;
+				o.pi_lower[i] = yhat - hp;
+				o.pi_upper[i] = yhat + hp;
+			}
+		}
+
+		template <std::floating_point T, std::floating_point Acc>
+		[[nodiscard]]
+		Acc residual_scalar(const T* x, const T* y, std::ptrdiff_t i, const DiagnosticCoefficients<Acc>& c) noexcept
+		{
+			return static_cast<Acc>(y[i]) - (c.beta0 + c.beta1 * static_cast<Acc>(x[i]));
+		}
+
+		// with_previous: x[-1] and y[-1] belong to the data, so (e₀ - e₋₁)² enters the Durbin-Watson sum
+		template <std::floating_point T, std::floating_point Acc>
+		[[nodiscard]]
+		DiagnosticSums<Acc> diagnostics_scalar(const T* x, const T* y, std::size_t n, const DiagnosticCoefficients<Acc>& c,
+			const DiagnosticRows<Acc>& o, bool with_previous) noexcept
+		{
+			DiagnosticSums<Acc> s{};
+			Acc prev = with_previous ? residual_scalar(x, y, -1, c) : Acc{};
+			for (std::size_t i = 0; i < n; ++i) {
+				const Acc e = residual_scalar(x, y, static_cast<std::ptrdiff_t>(i), c);
+				const Acc d = static_cast<Acc>(x[i]) - c.mean_x;
+				const Acc h = c.inv_n + d * d * c.inv_sxx;
+				const Acc q = Acc{ 1 } - h;
+				const Acc r = e * c.inv_s / std::sqrt(q);
+				s.sse += e * e;
+				if (i > 0 || with_previous)
+					s.dw += (e - prev) * (e - prev);
+				s.max_abs = std::max(s.max_abs, std::abs(e));
+				prev = e;
+				if (o.residual) o.residual[i] = e;
+				if (o.leverage) o.leverage[i] = h;
+				if (o.standardized) o.standardized[i] = r;
+				if (o.cooks_distance) o.cooks_distance[i] = r * r * h * Acc{ 0.5 } / q;
+			}
+			return s;
+		}
+
+#if defined(LINREG_SIMD_X86)
+		// ---------------------------------------------------------------
+		// AVX2 + FMA
+		// ---------------------------------------------------------------
+
+		LINREG_TARGET_AVX2 inline double hsum_avx2(__m256d v) noexcept
+		{
+			__m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+		}
+
+		LINREG_TARGET_AVX2 inline float hsum_avx2(__m256 v) noexcept
+		{
+			__m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+			lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+			return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+		}
+
+		LINREG_TARGET_AVX2 inline double sum_avx2(const double* x, std::size_t n) noexcept
+		{
+			__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+				a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+				a2 = _mm256_add_pd(a2, _mm256_loadu_pd(x + i + 8));
+				a3 = _mm256_add_pd(a3, _mm256_loadu_pd(x + i + 12));
+			}
+			for (; i + 4 <= n; i += 4)
+				a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+			double s = hsum_avx2(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline float sum_avx2(const float* x, std::size_t n) noexcept
+		{
+			__m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+				a1 = _mm256_add_ps(a1, _mm256_loadu_ps(x + i + 8));
+				a2 = _mm256_add_ps(a2, _mm256_loadu_ps(x + i + 16));
+				a3 = _mm256_add_ps(a3, _mm256_loadu_ps(x + i + 24));
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+			float s = hsum_avx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline void sum2_avx2(const double* x, const double* y, std::size_t n,
+			double& sx, double& sy) noexcept
+		{
+			__m256d x0 = _mm256_setzero_pd(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				x0 = _mm256_add_pd(x0, _mm256_loadu_pd(x + i));
+				y0 = _mm256_add_pd(y0, _mm256_loadu_pd(y + i));
+				x1 = _mm256_add_pd(x1, _mm256_loadu_pd(x + i + 4));
+				y1 = _mm256_add_pd(y1, _mm256_loadu_pd(y + i + 4));
+			}
+			for (; i + 4 <= n; i += 4) {
+				x0 = _mm256_add_pd(x0, _mm256_loadu_pd(x + i));
+				y0 = _mm256_add_pd(y0, _mm256_loadu_pd(y + i));
+			}
+			sx = hsum_avx2(_mm256_add_pd(x0, x1));
+			sy = hsum_avx2(_mm256_add_pd(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX2 inline void sum2_avx2(const float* x, const float* y, std::size_t n,
+			float& sx, float& sy) noexcept
+		{
+			__m256 x0 = _mm256_setzero_ps(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				x0 = _mm256_add_ps(x0, _mm256_loadu_ps(x + i));
+				y0 = _mm256_add_ps(y0, _mm256_loadu_ps(y + i));
+				x1 = _mm256_add_ps(x1, _mm256_loadu_ps(x + i + 8));
+				y1 = _mm256_add_ps(y1, _mm256_loadu_ps(y + i + 8));
+			}
+			for (; i + 8 <= n; i += 8) {
+				x0 = _mm256_add_ps(x0, _mm256_loadu_ps(x + i));
+				y0 = _mm256_add_ps(y0, _mm256_loadu_ps(y + i));
+			}
+			sx = hsum_avx2(_mm256_add_ps(x0, x1));
+			sy = hsum_avx2(_mm256_add_ps(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX2 inline double dot_avx2(const double* x, const double* y, std::size_t n) noexcept
+		{
+			__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), a0);
+				a1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), a1);
+				a2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), a2);
+				a3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), a3);
+			}
+			for (; i + 4 <= n; i += 4)
+				a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), a0);
+			double s = hsum_avx2(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline float dot_avx2(const float* x, const float* y, std::size_t n) noexcept
+		{
+			__m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), a0);
+				a1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), a1);
+				a2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), a2);
+				a3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), a3);
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), a0);
+			float s = hsum_avx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline CenteredSums<double> centered_sums_avx2(
+			const double* x, const double* y, std::size_t n, double a, double b) noexcept
+		{
+			const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+			__m256d cx0 = _mm256_setzero_pd(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m256d cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m256d dx0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), va);
+				const __m256d dy0 = _mm256_sub_pd(_mm256_loadu_pd(y + i), vb);
+				const __m256d dx1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), va);
+				const __m256d dy1 = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4), vb);
+				cx0 = _mm256_add_pd(cx0, dx0);  cx1 = _mm256_add_pd(cx1, dx1);
+				cy0 = _mm256_add_pd(cy0, dy0);  cy1 = _mm256_add_pd(cy1, dy1);
+				xx0 = _mm256_fmadd_pd(dx0, dx0, xx0);  xx1 = _mm256_fmadd_pd(dx1, dx1, xx1);
+				yy0 = _mm256_fmadd_pd(dy0, dy0, yy0);  yy1 = _mm256_fmadd_pd(dy1, dy1, yy1);
+				xy0 = _mm256_fmadd_pd(dx0, dy0, xy0);  xy1 = _mm256_fmadd_pd(dx1, dy1, xy1);
+			}
+			CenteredSums<double> s{
+				hsum_avx2(_mm256_add_pd(cx0, cx1)), hsum_avx2(_mm256_add_pd(cy0, cy1)),
+				hsum_avx2(_mm256_add_pd(xx0, xx1)), hsum_avx2(_mm256_add_pd(yy0, yy1)),
+				hsum_avx2(_mm256_add_pd(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		LINREG_TARGET_AVX2 inline CenteredSums<float> centered_sums_avx2(
+			const float* x, const float* y, std::size_t n, float a, float b) noexcept
+		{
+			const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+			__m256 cx0 = _mm256_setzero_ps(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m256 cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m256 dx0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), va);
+				const __m256 dy0 = _mm256_sub_ps(_mm256_loadu_ps(y + i), vb);
+				const __m256 dx1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), va);
+				const __m256 dy1 = _mm256_sub_ps(_mm256_loadu_ps(y + i + 8), vb);
+				cx0 = _mm256_add_ps(cx0, dx0);  cx1 = _mm256_add_ps(cx1, dx1);
+				cy0 = _mm256_add_ps(cy0, dy0);  cy1 = _mm256_add_ps(cy1, dy1);
+				xx0 = _mm256_fmadd_ps(dx0, dx0, xx0);  xx1 = _mm256_fmadd_ps(dx1, dx1, xx1);
+				yy0 = _mm256_fmadd_ps(dy0, dy0, yy0);  yy1 = _mm256_fmadd_ps(dy1, dy1, yy1);
+				xy0 = _mm256_fmadd_ps(dx0, dy0, xy0);  xy1 = _mm256_fmadd_ps(dx1, dy1, xy1);
+			}
+			CenteredSums<float> s{
+				hsum_avx2(_mm256_add_ps(cx0, cx1)), hsum_avx2(_mm256_add_ps(cy0, cy1)),
+				hsum_avx2(_mm256_add_ps(xx0, xx1)), hsum_avx2(_mm256_add_ps(yy0, yy1)),
+				hsum_avx2(_mm256_add_ps(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// float storage, double accumulation: loads 4 floats and widens them
+		// to one __m256d (vcvtps2pd), so the sums carry double precision at
+		// float memory bandwidth
+
+		LINREG_TARGET_AVX2 inline __m256d load_widen_avx2(const float* p) noexcept
+		{
+			return _mm256_cvtps_pd(_mm_loadu_ps(p));
+		}
+
+		LINREG_TARGET_AVX2 inline double sum_widen_avx2(const float* x, std::size_t n) noexcept
+		{
+			__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = _mm256_add_pd(a0, load_widen_avx2(x + i));
+				a1 = _mm256_add_pd(a1, load_widen_avx2(x + i + 4));
+				a2 = _mm256_add_pd(a2, load_widen_avx2(x + i + 8));
+				a3 = _mm256_add_pd(a3, load_widen_avx2(x + i + 12));
+			}
+			for (; i + 4 <= n; i += 4)
+				a0 = _mm256_add_pd(a0, load_widen_avx2(x + i));
+			double s = hsum_avx2(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline void sum2_widen_avx2(const float* x, const float* y, std::size_t n,
+			double& sx, double& sy) noexcept
+		{
+			__m256d x0 = _mm256_setzero_pd(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				x0 = _mm256_add_pd(x0, load_widen_avx2(x + i));
+				y0 = _mm256_add_pd(y0, load_widen_avx2(y + i));
+				x1 = _mm256_add_pd(x1, load_widen_avx2(x + i + 4));
+				y1 = _mm256_add_pd(y1, load_widen_avx2(y + i + 4));
+			}
+			for (; i + 4 <= n; i += 4) {
+				x0 = _mm256_add_pd(x0, load_widen_avx2(x + i));
+				y0 = _mm256_add_pd(y0, load_widen_avx2(y + i));
+			}
+			sx = hsum_avx2(_mm256_add_pd(x0, x1));
+			sy = hsum_avx2(_mm256_add_pd(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX2 inline double dot_widen_avx2(const float* x, const float* y, std::size_t n) noexcept
+		{
+			__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = _mm256_fmadd_pd(load_widen_avx2(x + i), load_widen_avx2(y + i), a0);
+				a1 = _mm256_fmadd_pd(load_widen_avx2(x + i + 4), load_widen_avx2(y + i + 4), a1);
+				a2 = _mm256_fmadd_pd(load_widen_avx2(x + i + 8), load_widen_avx2(y + i + 8), a2);
+				a3 = _mm256_fmadd_pd(load_widen_avx2(x + i + 12), load_widen_avx2(y + i + 12), a3);
+			}
+			for (; i + 4 <= n; i += 4)
+				a0 = _mm256_fmadd_pd(load_widen_avx2(x + i), load_widen_avx2(y + i), a0);
+			double s = hsum_avx2(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+			return s;
+		}
+
+		LINREG_TARGET_AVX2 inline CenteredSums<double> centered_sums_widen_avx2(
+			const float* x, const float* y, std::size_t n, double a, double b) noexcept
+		{
+			const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+			__m256d cx0 = _mm256_setzero_pd(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m256d cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m256d dx0 = _mm256_sub_pd(load_widen_avx2(x + i), va);
+				const __m256d dy0 = _mm256_sub_pd(load_widen_avx2(y + i), vb);
+				const __m256d dx1 = _mm256_sub_pd(load_widen_avx2(x + i + 4), va);
+				const __m256d dy1 = _mm256_sub_pd(load_widen_avx2(y + i + 4), vb);
+				cx0 = _mm256_add_pd(cx0, dx0);  cx1 = _mm256_add_pd(cx1, dx1);
+				cy0 = _mm256_add_pd(cy0, dy0);  cy1 = _mm256_add_pd(cy1, dy1);
+				xx0 = _mm256_fmadd_pd(dx0, dx0, xx0);  xx1 = _mm256_fmadd_pd(dx1, dx1, xx1);
+				yy0 = _mm256_fmadd_pd(dy0, dy0, yy0);  yy1 = _mm256_fmadd_pd(dy1, dy1, yy1);
+				xy0 = _mm256_fmadd_pd(dx0, dy0, xy0);  xy1 = _mm256_fmadd_pd(dx1, dy1, xy1);
+			}
+			CenteredSums<double> s{
+				hsum_avx2(_mm256_add_pd(cx0, cx1)), hsum_avx2(_mm256_add_pd(cy0, cy1)),
+				hsum_avx2(_mm256_add_pd(xx0, xx1)), hsum_avx2(_mm256_add_pd(yy0, yy1)),
+				hsum_avx2(_mm256_add_pd(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// ---------------------------------------------------------------
+		// AVX-512F
+		// ---------------------------------------------------------------
+
+		// Spill-and-add instead of _mm512_reduce_add_*, which trips a false
+		// -Wuninitialized in GCC 12 and costs about the same
+		LINREG_TARGET_AVX512 inline double hsum_avx512(__m512d v) noexcept
+		{
+			alignas(64) double t[8];
+			_mm512_store_pd(t, v);
+			return ((t[0] + t[4]) + (t[1] + t[5])) + ((t[2] + t[6]) + (t[3] + t[7]));
+		}
+
+		LINREG_TARGET_AVX512 inline float hsum_avx512(__m512 v) noexcept
+		{
+			alignas(64) float t[16];
+			_mm512_store_ps(t, v);
+			float s = 0.0f;
+			for (int k = 0; k < 8; ++k)
+				s += t[k] + t[k + 8];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline double sum_avx512(const double* x, std::size_t n) noexcept
+		{
+			__m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+				a1 = _mm512_add_pd(a1, _mm512_loadu_pd(x + i + 8));
+				a2 = _mm512_add_pd(a2, _mm512_loadu_pd(x + i + 16));
+				a3 = _mm512_add_pd(a3, _mm512_loadu_pd(x + i + 24));
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+			double s = hsum_avx512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline float sum_avx512(const float* x, std::size_t n) noexcept
+		{
+			__m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 64 <= n; i += 64) {
+				a0 = _mm512_add_ps(a0, _mm512_loadu_ps(x + i));
+				a1 = _mm512_add_ps(a1, _mm512_loadu_ps(x + i + 16));
+				a2 = _mm512_add_ps(a2, _mm512_loadu_ps(x + i + 32));
+				a3 = _mm512_add_ps(a3, _mm512_loadu_ps(x + i + 48));
+			}
+			for (; i + 16 <= n; i += 16)
+				a0 = _mm512_add_ps(a0, _mm512_loadu_ps(x + i));
+			float s = hsum_avx512(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline void sum2_avx512(const double* x, const double* y, std::size_t n,
+			double& sx, double& sy) noexcept
+		{
+			__m512d x0 = _mm512_setzero_pd(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				x0 = _mm512_add_pd(x0, _mm512_loadu_pd(x + i));
+				y0 = _mm512_add_pd(y0, _mm512_loadu_pd(y + i));
+				x1 = _mm512_add_pd(x1, _mm512_loadu_pd(x + i + 8));
+				y1 = _mm512_add_pd(y1, _mm512_loadu_pd(y + i + 8));
+			}
+			for (; i + 8 <= n; i += 8) {
+				x0 = _mm512_add_pd(x0, _mm512_loadu_pd(x + i));
+				y0 = _mm512_add_pd(y0, _mm512_loadu_pd(y + i));
+			}
+			sx = hsum_avx512(_mm512_add_pd(x0, x1));
+			sy = hsum_avx512(_mm512_add_pd(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX512 inline void sum2_avx512(const float* x, const float* y, std::size_t n,
+			float& sx, float& sy) noexcept
+		{
+			__m512 x0 = _mm512_setzero_ps(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				x0 = _mm512_add_ps(x0, _mm512_loadu_ps(x + i));
+				y0 = _mm512_add_ps(y0, _mm512_loadu_ps(y + i));
+				x1 = _mm512_add_ps(x1, _mm512_loadu_ps(x + i + 16));
+				y1 = _mm512_add_ps(y1, _mm512_loadu_ps(y + i + 16));
+			}
+			for (; i + 16 <= n; i += 16) {
+				x0 = _mm512_add_ps(x0, _mm512_loadu_ps(x + i));
+				y0 = _mm512_add_ps(y0, _mm512_loadu_ps(y + i));
+			}
+			sx = hsum_avx512(_mm512_add_ps(x0, x1));
+			sy = hsum_avx512(_mm512_add_ps(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX512 inline double dot_avx512(const double* x, const double* y, std::size_t n) noexcept
+		{
+			__m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), a0);
+				a1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), a1);
+				a2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), a2);
+				a3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), a3);
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), a0);
+			double s = hsum_avx512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline float dot_avx512(const float* x, const float* y, std::size_t n) noexcept
+		{
+			__m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 64 <= n; i += 64) {
+				a0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), a0);
+				a1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), a1);
+				a2 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y + i + 32), a2);
+				a3 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y + i + 48), a3);
+			}
+			for (; i + 16 <= n; i += 16)
+				a0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), a0);
+			float s = hsum_avx512(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline CenteredSums<double> centered_sums_avx512(
+			const double* x, const double* y, std::size_t n, double a, double b) noexcept
+		{
+			const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+			__m512d cx0 = _mm512_setzero_pd(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m512d cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m512d dx0 = _mm512_sub_pd(_mm512_loadu_pd(x + i), va);
+				const __m512d dy0 = _mm512_sub_pd(_mm512_loadu_pd(y + i), vb);
+				const __m512d dx1 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8), va);
+				const __m512d dy1 = _mm512_sub_pd(_mm512_loadu_pd(y + i + 8), vb);
+				cx0 = _mm512_add_pd(cx0, dx0);  cx1 = _mm512_add_pd(cx1, dx1);
+				cy0 = _mm512_add_pd(cy0, dy0);  cy1 = _mm512_add_pd(cy1, dy1);
+				xx0 = _mm512_fmadd_pd(dx0, dx0, xx0);  xx1 = _mm512_fmadd_pd(dx1, dx1, xx1);
+				yy0 = _mm512_fmadd_pd(dy0, dy0, yy0);  yy1 = _mm512_fmadd_pd(dy1, dy1, yy1);
+				xy0 = _mm512_fmadd_pd(dx0, dy0, xy0);  xy1 = _mm512_fmadd_pd(dx1, dy1, xy1);
+			}
+			CenteredSums<double> s{
+				hsum_avx512(_mm512_add_pd(cx0, cx1)), hsum_avx512(_mm512_add_pd(cy0, cy1)),
+				hsum_avx512(_mm512_add_pd(xx0, xx1)), hsum_avx512(_mm512_add_pd(yy0, yy1)),
+				hsum_avx512(_mm512_add_pd(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		LINREG_TARGET_AVX512 inline CenteredSums<float> centered_sums_avx512(
+			const float* x, const float* y, std::size_t n, float a, float b) noexcept
+		{
+			const __m512 va = _mm512_set1_ps(a), vb = _mm512_set1_ps(b);
+			__m512 cx0 = _mm512_setzero_ps(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m512 cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				const __m512 dx0 = _mm512_sub_ps(_mm512_loadu_ps(x + i), va);
+				const __m512 dy0 = _mm512_sub_ps(_mm512_loadu_ps(y + i), vb);
+				const __m512 dx1 = _mm512_sub_ps(_mm512_loadu_ps(x + i + 16), va);
+				const __m512 dy1 = _mm512_sub_ps(_mm512_loadu_ps(y + i + 16), vb);
+				cx0 = _mm512_add_ps(cx0, dx0);  cx1 = _mm512_add_ps(cx1, dx1);
+				cy0 = _mm512_add_ps(cy0, dy0);  cy1 = _mm512_add_ps(cy1, dy1);
+				xx0 = _mm512_fmadd_ps(dx0, dx0, xx0);  xx1 = _mm512_fmadd_ps(dx1, dx1, xx1);
+				yy0 = _mm512_fmadd_ps(dy0, dy0, yy0);  yy1 = _mm512_fmadd_ps(dy1, dy1, yy1);
+				xy0 = _mm512_fmadd_ps(dx0, dy0, xy0);  xy1 = _mm512_fmadd_ps(dx1, dy1, xy1);
+			}
+			CenteredSums<float> s{
+				hsum_avx512(_mm512_add_ps(cx0, cx1)), hsum_avx512(_mm512_add_ps(cy0, cy1)),
+				hsum_avx512(_mm512_add_ps(xx0, xx1)), hsum_avx512(_mm512_add_ps(yy0, yy1)),
+				hsum_avx512(_mm512_add_ps(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// float storage, double accumulation: 8 floats widened to one __m512d
+
+		// The masked form with a zero source avoids the _mm512_undefined_pd()
+		// inside _mm512_cvtps_pd, which GCC 12 reports as uninitialized
+		LINREG_TARGET_AVX512 inline __m512d load_widen_avx512(const float* p) noexcept
+		{
+			return _mm512_mask_cvtps_pd(_mm512_setzero_pd(), 0xFF, _mm256_loadu_ps(p));
+		}
+
+		LINREG_TARGET_AVX512 inline double sum_widen_avx512(const float* x, std::size_t n) noexcept
+		{
+			__m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm512_add_pd(a0, load_widen_avx512(x + i));
+				a1 = _mm512_add_pd(a1, load_widen_avx512(x + i + 8));
+				a2 = _mm512_add_pd(a2, load_widen_avx512(x + i + 16));
+				a3 = _mm512_add_pd(a3, load_widen_avx512(x + i + 24));
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm512_add_pd(a0, load_widen_avx512(x + i));
+			double s = hsum_avx512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline void sum2_widen_avx512(const float* x, const float* y, std::size_t n,
+			double& sx, double& sy) noexcept
+		{
+			__m512d x0 = _mm512_setzero_pd(), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				x0 = _mm512_add_pd(x0, load_widen_avx512(x + i));
+				y0 = _mm512_add_pd(y0, load_widen_avx512(y + i));
+				x1 = _mm512_add_pd(x1, load_widen_avx512(x + i + 8));
+				y1 = _mm512_add_pd(y1, load_widen_avx512(y + i + 8));
+			}
+			for (; i + 8 <= n; i += 8) {
+				x0 = _mm512_add_pd(x0, load_widen_avx512(x + i));
+				y0 = _mm512_add_pd(y0, load_widen_avx512(y + i));
+			}
+			sx = hsum_avx512(_mm512_add_pd(x0, x1));
+			sy = hsum_avx512(_mm512_add_pd(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		LINREG_TARGET_AVX512 inline double dot_widen_avx512(const float* x, const float* y, std::size_t n) noexcept
+		{
+			__m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				a0 = _mm512_fmadd_pd(load_widen_avx512(x + i), load_widen_avx512(y + i), a0);
+				a1 = _mm512_fmadd_pd(load_widen_avx512(x + i + 8), load_widen_avx512(y + i + 8), a1);
+				a2 = _mm512_fmadd_pd(load_widen_avx512(x + i + 16), load_widen_avx512(y + i + 16), a2);
+				a3 = _mm512_fmadd_pd(load_widen_avx512(x + i + 24), load_widen_avx512(y + i + 24), a3);
+			}
+			for (; i + 8 <= n; i += 8)
+				a0 = _mm512_fmadd_pd(load_widen_avx512(x + i), load_widen_avx512(y + i), a0);
+			double s = hsum_avx512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+			for (; i < n; ++i)
+				s += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+			return s;
+		}
+
+		LINREG_TARGET_AVX512 inline CenteredSums<double> centered_sums_widen_avx512(
+			const float* x, const float* y, std::size_t n, double a, double b) noexcept
+		{
+			const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+			__m512d cx0 = _mm512_setzero_pd(), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			__m512d cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m512d dx0 = _mm512_sub_pd(load_widen_avx512(x + i), va);
+				const __m512d dy0 = _mm512_sub_pd(load_widen_avx512(y + i), vb);
+				const __m512d dx1 = _mm512_sub_pd(load_widen_avx512(x + i + 8), va);
+				const __m512d dy1 = _mm512_sub_pd(load_widen_avx512(y + i + 8), vb);
+				cx0 = _mm512_add_pd(cx0, dx0);  cx1 = _mm512_add_pd(cx1, dx1);
+				cy0 = _mm512_add_pd(cy0, dy0);  cy1 = _mm512_add_pd(cy1, dy1);
+				xx0 = _mm512_fmadd_pd(dx0, dx0, xx0);  xx1 = _mm512_fmadd_pd(dx1, dx1, xx1);
+				yy0 = _mm512_fmadd_pd(dy0, dy0, yy0);  yy1 = _mm512_fmadd_pd(dy1, dy1, yy1);
+				xy0 = _mm512_fmadd_pd(dx0, dy0, xy0);  xy1 = _mm512_fmadd_pd(dx1, dy1, xy1);
+			}
+			CenteredSums<double> s{
+				hsum_avx512(_mm512_add_pd(cx0, cx1)), hsum_avx512(_mm512_add_pd(cy0, cy1)),
+				hsum_avx512(_mm512_add_pd(xx0, xx1)), hsum_avx512(_mm512_add_pd(yy0, yy1)),
+				hsum_avx512(_mm512_add_pd(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// ---------------------------------------------------------------
+		// Weighted kernels (AVX2 + FMA, AVX-512F)
+		// ---------------------------------------------------------------
+
+		// v with the lanes of zero weight cleared
+		LINREG_TARGET_AVX2 inline __m256d where_weighted_avx2(__m256d w, __m256d v) noexcept
+		{
+			return _mm256_and_pd(_mm256_cmp_pd(w, _mm256_setzero_pd(), _CMP_GT_OQ), v);
+		}
+
+		LINREG_TARGET_AVX2 inline __m256 where_weighted_avx2(__m256 w, __m256 v) noexcept
+		{
+			return _mm256_and_ps(_mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ), v);
+		}
+
+		LINREG_TARGET_AVX2 inline void weighted_sums_avx2(const double* w, const double* x, const double* y, std::size_t n,
+			double& sw, double& swx, double& swy) noexcept
+		{
+			__m256d w0 = _mm256_setzero_pd(), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m256d wa = _mm256_loadu_pd(w + i), wb = _mm256_loadu_pd(w + i + 4);
+				w0 = _mm256_add_pd(w0, wa);  w1 = _mm256_add_pd(w1, wb);
+				x0 = _mm256_fmadd_pd(wa, where_weighted_avx2(wa, _mm256_loadu_pd(x + i)), x0);
+				x1 = _mm256_fmadd_pd(wb, where_weighted_avx2(wb, _mm256_loadu_pd(x + i + 4)), x1);
+				y0 = _mm256_fmadd_pd(wa, where_weighted_avx2(wa, _mm256_loadu_pd(y + i)), y0);
+				y1 = _mm256_fmadd_pd(wb, where_weighted_avx2(wb, _mm256_loadu_pd(y + i + 4)), y1);
+			}
+			double tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = hsum_avx2(_mm256_add_pd(w0, w1)) + tw;
+			swx = hsum_avx2(_mm256_add_pd(x0, x1)) + tx;
+			swy = hsum_avx2(_mm256_add_pd(y0, y1)) + ty;
+		}
+
+		LINREG_TARGET_AVX2 inline CenteredSums<double> weighted_centered_sums_avx2(const double* w, const double* x, const double* y,
+			std::size_t n, double a, double b) noexcept
+		{
+			const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+			__m256d cx = _mm256_setzero_pd(), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const __m256d vw = _mm256_loadu_pd(w + i);
+				const __m256d dx = where_weighted_avx2(vw, _mm256_sub_pd(_mm256_loadu_pd(x + i), va));
+				const __m256d dy = where_weighted_avx2(vw, _mm256_sub_pd(_mm256_loadu_pd(y + i), vb));
+				const __m256d wdx = _mm256_mul_pd(vw, dx), wdy = _mm256_mul_pd(vw, dy);
+				cx = _mm256_add_pd(cx, wdx);
+				cy = _mm256_add_pd(cy, wdy);
+				xx = _mm256_fmadd_pd(wdx, dx, xx);
+				yy = _mm256_fmadd_pd(wdy, dy, yy);
+				xy = _mm256_fmadd_pd(wdx, dy, xy);
+			}
+			const CenteredSums<double> s{ hsum_avx2(cx), hsum_avx2(cy), hsum_avx2(xx), hsum_avx2(yy), hsum_avx2(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		LINREG_TARGET_AVX2 inline void weighted_sums_avx2(const float* w, const float* x, const float* y, std::size_t n,
+			float& sw, float& swx, float& swy) noexcept
+		{
+			__m256 w0 = _mm256_setzero_ps(), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m256 wa = _mm256_loadu_ps(w + i), wb = _mm256_loadu_ps(w + i + 8);
+				w0 = _mm256_add_ps(w0, wa);  w1 = _mm256_add_ps(w1, wb);
+				x0 = _mm256_fmadd_ps(wa, where_weighted_avx2(wa, _mm256_loadu_ps(x + i)), x0);
+				x1 = _mm256_fmadd_ps(wb, where_weighted_avx2(wb, _mm256_loadu_ps(x + i + 8)), x1);
+				y0 = _mm256_fmadd_ps(wa, where_weighted_avx2(wa, _mm256_loadu_ps(y + i)), y0);
+				y1 = _mm256_fmadd_ps(wb, where_weighted_avx2(wb, _mm256_loadu_ps(y + i + 8)), y1);
+			}
+			float tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = hsum_avx2(_mm256_add_ps(w0, w1)) + tw;
+			swx = hsum_avx2(_mm256_add_ps(x0, x1)) + tx;
+			swy = hsum_avx2(_mm256_add_ps(y0, y1)) + ty;
+		}
+
+		LINREG_TARGET_AVX2 inline CenteredSums<float> weighted_centered_sums_avx2(const float* w, const float* x, const float* y,
+			std::size_t n, float a, float b) noexcept
+		{
+			const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+			__m256 cx = _mm256_setzero_ps(), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m256 vw = _mm256_loadu_ps(w + i);
+				const __m256 dx = where_weighted_avx2(vw, _mm256_sub_ps(_mm256_loadu_ps(x + i), va));
+				const __m256 dy = where_weighted_avx2(vw, _mm256_sub_ps(_mm256_loadu_ps(y + i), vb));
+				const __m256 wdx = _mm256_mul_ps(vw, dx), wdy = _mm256_mul_ps(vw, dy);
+				cx = _mm256_add_ps(cx, wdx);
+				cy = _mm256_add_ps(cy, wdy);
+				xx = _mm256_fmadd_ps(wdx, dx, xx);
+				yy = _mm256_fmadd_ps(wdy, dy, yy);
+				xy = _mm256_fmadd_ps(wdx, dy, xy);
+			}
+			const CenteredSums<float> s{ hsum_avx2(cx), hsum_avx2(cy), hsum_avx2(xx), hsum_avx2(yy), hsum_avx2(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		LINREG_TARGET_AVX512 inline void weighted_sums_avx512(const double* w, const double* x, const double* y, std::size_t n,
+			double& sw, double& swx, double& swy) noexcept
+		{
+			__m512d w0 = _mm512_setzero_pd(), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m512d wa = _mm512_loadu_pd(w + i), wb = _mm512_loadu_pd(w + i + 8);
+				const __mmask8 ma = _mm512_cmp_pd_mask(wa, _mm512_setzero_pd(), _CMP_GT_OQ);
+				const __mmask8 mb = _mm512_cmp_pd_mask(wb, _mm512_setzero_pd(), _CMP_GT_OQ);
+				w0 = _mm512_add_pd(w0, wa);  w1 = _mm512_add_pd(w1, wb);
+				x0 = _mm512_fmadd_pd(wa, _mm512_maskz_loadu_pd(ma, x + i), x0);  x1 = _mm512_fmadd_pd(wb, _mm512_maskz_loadu_pd(mb, x + i + 8), x1);
+				y0 = _mm512_fmadd_pd(wa, _mm512_maskz_loadu_pd(ma, y + i), y0);  y1 = _mm512_fmadd_pd(wb, _mm512_maskz_loadu_pd(mb, y + i + 8), y1);
+			}
+			double tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = hsum_avx512(_mm512_add_pd(w0, w1)) + tw;
+			swx = hsum_avx512(_mm512_add_pd(x0, x1)) + tx;
+			swy = hsum_avx512(_mm512_add_pd(y0, y1)) + ty;
+		}
+
+		LINREG_TARGET_AVX512 inline CenteredSums<double> weighted_centered_sums_avx512(const double* w, const double* x, const double* y,
+			std::size_t n, double a, double b) noexcept
+		{
+			const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+			__m512d cx = _mm512_setzero_pd(), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m512d vw = _mm512_loadu_pd(w + i);
+				const __mmask8 m = _mm512_cmp_pd_mask(vw, _mm512_setzero_pd(), _CMP_GT_OQ);
+				const __m512d dx = _mm512_maskz_sub_pd(m, _mm512_loadu_pd(x + i), va);
+				const __m512d dy = _mm512_maskz_sub_pd(m, _mm512_loadu_pd(y + i), vb);
+				const __m512d wdx = _mm512_mul_pd(vw, dx), wdy = _mm512_mul_pd(vw, dy);
+				cx = _mm512_add_pd(cx, wdx);
+				cy = _mm512_add_pd(cy, wdy);
+				xx = _mm512_fmadd_pd(wdx, dx, xx);
+				yy = _mm512_fmadd_pd(wdy, dy, yy);
+				xy = _mm512_fmadd_pd(wdx, dy, xy);
+			}
+			const CenteredSums<double> s{ hsum_avx512(cx), hsum_avx512(cy), hsum_avx512(xx), hsum_avx512(yy), hsum_avx512(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		LINREG_TARGET_AVX512 inline void weighted_sums_avx512(const float* w, const float* x, const float* y, std::size_t n,
+			float& sw, float& swx, float& swy) noexcept
+		{
+			__m512 w0 = _mm512_setzero_ps(), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				const __m512 wa = _mm512_loadu_ps(w + i), wb = _mm512_loadu_ps(w + i + 16);
+				const __mmask16 ma = _mm512_cmp_ps_mask(wa, _mm512_setzero_ps(), _CMP_GT_OQ);
+				const __mmask16 mb = _mm512_cmp_ps_mask(wb, _mm512_setzero_ps(), _CMP_GT_OQ);
+				w0 = _mm512_add_ps(w0, wa);  w1 = _mm512_add_ps(w1, wb);
+				x0 = _mm512_fmadd_ps(wa, _mm512_maskz_loadu_ps(ma, x + i), x0);  x1 = _mm512_fmadd_ps(wb, _mm512_maskz_loadu_ps(mb, x + i + 16), x1);
+				y0 = _mm512_fmadd_ps(wa, _mm512_maskz_loadu_ps(ma, y + i), y0);  y1 = _mm512_fmadd_ps(wb, _mm512_maskz_loadu_ps(mb, y + i + 16), y1);
+			}
+			float tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = hsum_avx512(_mm512_add_ps(w0, w1)) + tw;
+			swx = hsum_avx512(_mm512_add_ps(x0, x1)) + tx;
+			swy = hsum_avx512(_mm512_add_ps(y0, y1)) + ty;
+		}
+
+		LINREG_TARGET_AVX512 inline CenteredSums<float> weighted_centered_sums_avx512(const float* w, const float* x, const float* y,
+			std::size_t n, float a, float b) noexcept
+		{
+			const __m512 va = _mm512_set1_ps(a), vb = _mm512_set1_ps(b);
+			__m512 cx = _mm512_setzero_ps(), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m512 vw = _mm512_loadu_ps(w + i);
+				const __mmask16 m = _mm512_cmp_ps_mask(vw, _mm512_setzero_ps(), _CMP_GT_OQ);
+				const __m512 dx = _mm512_maskz_sub_ps(m, _mm512_loadu_ps(x + i), va);
+				const __m512 dy = _mm512_maskz_sub_ps(m, _mm512_loadu_ps(y + i), vb);
+				const __m512 wdx = _mm512_mul_ps(vw, dx), wdy = _mm512_mul_ps(vw, dy);
+				cx = _mm512_add_ps(cx, wdx);
+				cy = _mm512_add_ps(cy, wdy);
+				xx = _mm512_fmadd_ps(wdx, dx, xx);
+				yy = _mm512_fmadd_ps(wdy, dy, yy);
+				xy = _mm512_fmadd_ps(wdx, dy, xy);
+			}
+			const CenteredSums<float> s{ hsum_avx512(cx), hsum_avx512(cy), hsum_avx512(xx), hsum_avx512(yy), hsum_avx512(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// ---------------------------------------------------------------
+		// Elementwise kernels (AVX2 + FMA, AVX-512F)
+		// ---------------------------------------------------------------
+
+		LINREG_TARGET_AVX2 inline void affine_avx2(const double* x, std::size_t n, double a, double b, double* out) noexcept
+		{
+			const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(x + i), vb, va));
+				_mm256_storeu_pd(out + i + 4, _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), vb, va));
+			}
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(x + i), vb, va));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		LINREG_TARGET_AVX2 inline void bands_avx2(const double* x, std::size_t n, const BandCoefficients<double>& c,
+			const BandRows<double>& o) noexcept
+		{
+			const __m256d b0 = _mm256_set1_pd(c.beta0), b1 = _mm256_set1_pd(c.beta1), mx = _mm256_set1_pd(c.mean_x);
+			const __m256d inv_n = _mm256_set1_pd(c.inv_n), inv_sxx = _mm256_set1_pd(c.inv_sxx);
+			const __m256d ts = _mm256_set1_pd(c.ts), one = _mm256_set1_pd(1.0);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const __m256d vx = _mm256_loadu_pd(x + i);
+				const __m256d yhat = _mm256_fmadd_pd(vx, b1, b0);
+				const __m256d d = _mm256_sub_pd(vx, mx);
+				const __m256d q = _mm256_fmadd_pd(_mm256_mul_pd(d, d), inv_sxx, inv_n);
+				const __m256d hc = _mm256_mul_pd(ts, _mm256_sqrt_pd(q));
+				const __m256d hp = _mm256_mul_pd(ts, _mm256_sqrt_pd(_mm256_add_pd(q, one)));
+				_mm256_storeu_pd(o.fit + i, yhat);
+				_mm256_storeu_pd(o.ci_lower + i, _mm256_sub_pd(yhat, hc));
+				_mm256_storeu_pd(o.ci_upper + i, _mm256_add_pd(yhat, hc));
+				_mm256_storeu_pd(o.pi_lower + i, _mm256_sub_pd(yhat, hp));
+				_mm256_storeu_pd(o.pi_upper + i, _mm256_add_pd(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		LINREG_TARGET_AVX2 inline void affine_avx2(const float* x, std::size_t n, float a, float b, float* out) noexcept
+		{
+			const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				_mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_loadu_ps(x + i), vb, va));
+				_mm256_storeu_ps(out + i + 8, _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), vb, va));
+			}
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_loadu_ps(x + i), vb, va));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		LINREG_TARGET_AVX2 inline void bands_avx2(const float* x, std::size_t n, const BandCoefficients<float>& c,
+			const BandRows<float>& o) noexcept
+		{
+			const __m256 b0 = _mm256_set1_ps(c.beta0), b1 = _mm256_set1_ps(c.beta1), mx = _mm256_set1_ps(c.mean_x);
+			const __m256 inv_n = _mm256_set1_ps(c.inv_n), inv_sxx = _mm256_set1_ps(c.inv_sxx);
+			const __m256 ts = _mm256_set1_ps(c.ts), one = _mm256_set1_ps(1.0f);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m256 vx = _mm256_loadu_ps(x + i);
+				const __m256 yhat = _mm256_fmadd_ps(vx, b1, b0);
+				const __m256 d = _mm256_sub_ps(vx, mx);
+				const __m256 q = _mm256_fmadd_ps(_mm256_mul_ps(d, d), inv_sxx, inv_n);
+				const __m256 hc = _mm256_mul_ps(ts, _mm256_sqrt_ps(q));
+				const __m256 hp = _mm256_mul_ps(ts, _mm256_sqrt_ps(_mm256_add_ps(q, one)));
+				_mm256_storeu_ps(o.fit + i, yhat);
+				_mm256_storeu_ps(o.ci_lower + i, _mm256_sub_ps(yhat, hc));
+				_mm256_storeu_ps(o.ci_upper + i, _mm256_add_ps(yhat, hc));
+				_mm256_storeu_ps(o.pi_lower + i, _mm256_sub_ps(yhat, hp));
+				_mm256_storeu_ps(o.pi_upper + i, _mm256_add_ps(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		// Masked square roots and maxima with a zero source, as in load_widen_avx512()
+		LINREG_TARGET_AVX512 inline __m512d sqrt_avx512(__m512d v) noexcept
+		{
+			return _mm512_mask_sqrt_pd(_mm512_setzero_pd(), 0xFF, v);
+		}
+
+		LINREG_TARGET_AVX512 inline __m512 sqrt_avx512(__m512 v) noexcept
+		{
+			return _mm512_mask_sqrt_ps(_mm512_setzero_ps(), 0xFFFF, v);
+		}
+
+		LINREG_TARGET_AVX512 inline __m512d max_avx512(__m512d a, __m512d b) noexcept
+		{
+			return _mm512_mask_max_pd(_mm512_setzero_pd(), 0xFF, a, b);
+		}
+
+		LINREG_TARGET_AVX512 inline __m512 max_avx512(__m512 a, __m512 b) noexcept
+		{
+			return _mm512_mask_max_ps(_mm512_setzero_ps(), 0xFFFF, a, b);
+		}
+
+		LINREG_TARGET_AVX512 inline void affine_avx512(const double* x, std::size_t n, double a, double b, double* out) noexcept
+		{
+			const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				_mm512_storeu_pd(out + i, _mm512_fmadd_pd(_mm512_loadu_pd(x + i), vb, va));
+				_mm512_storeu_pd(out + i + 8, _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), vb, va));
+			}
+			for (; i + 8 <= n; i += 8)
+				_mm512_storeu_pd(out + i, _mm512_fmadd_pd(_mm512_loadu_pd(x + i), vb, va));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		LINREG_TARGET_AVX512 inline void bands_avx512(const double* x, std::size_t n, const BandCoefficients<double>& c,
+			const BandRows<double>& o) noexcept
+		{
+			const __m512d b0 = _mm512_set1_pd(c.beta0), b1 = _mm512_set1_pd(c.beta1), mx = _mm512_set1_pd(c.mean_x);
+			const __m512d inv_n = _mm512_set1_pd(c.inv_n), inv_sxx = _mm512_set1_pd(c.inv_sxx);
+			const __m512d ts = _mm512_set1_pd(c.ts), one = _mm512_set1_pd(1.0);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const __m512d vx = _mm512_loadu_pd(x + i);
+				const __m512d yhat = _mm512_fmadd_pd(vx, b1, b0);
+				const __m512d d = _mm512_sub_pd(vx, mx);
+				const __m512d q = _mm512_fmadd_pd(_mm512_mul_pd(d, d), inv_sxx, inv_n);
+				const __m512d hc = _mm512_mul_pd(ts, sqrt_avx512(q));
+				const __m512d hp = _mm512_mul_pd(ts, sqrt_avx512(_mm512_add_pd(q, one)));
+				_mm512_storeu_pd(o.fit + i, yhat);
+				_mm512_storeu_pd(o.ci_lower + i, _mm512_sub_pd(yhat, hc));
+				_mm512_storeu_pd(o.ci_upper + i, _mm512_add_pd(yhat, hc));
+				_mm512_storeu_pd(o.pi_lower + i, _mm512_sub_pd(yhat, hp));
+				_mm512_storeu_pd(o.pi_upper + i, _mm512_add_pd(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		LINREG_TARGET_AVX512 inline void affine_avx512(const float* x, std::size_t n, float a, float b, float* out) noexcept
+		{
+			const __m512 va = _mm512_set1_ps(a), vb = _mm512_set1_ps(b);
+			std::size_t i = 0;
+			for (; i + 32 <= n; i += 32) {
+				_mm512_storeu_ps(out + i, _mm512_fmadd_ps(_mm512_loadu_ps(x + i), vb, va));
+				_mm512_storeu_ps(out + i + 16, _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), vb, va));
+			}
+			for (; i + 16 <= n; i += 16)
+				_mm512_storeu_ps(out + i, _mm512_fmadd_ps(_mm512_loadu_ps(x + i), vb, va));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		LINREG_TARGET_AVX512 inline void bands_avx512(const float* x, std::size_t n, const BandCoefficients<float>& c,
+			const BandRows<float>& o) noexcept
+		{
+			const __m512 b0 = _mm512_set1_ps(c.beta0), b1 = _mm512_set1_ps(c.beta1), mx = _mm512_set1_ps(c.mean_x);
+			const __m512 inv_n = _mm512_set1_ps(c.inv_n), inv_sxx = _mm512_set1_ps(c.inv_sxx);
+			const __m512 ts = _mm512_set1_ps(c.ts), one = _mm512_set1_ps(1.0f);
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				const __m512 vx = _mm512_loadu_ps(x + i);
+				const __m512 yhat = _mm512_fmadd_ps(vx, b1, b0);
+				const __m512 d = _mm512_sub_ps(vx, mx);
+				const __m512 q = _mm512_fmadd_ps(_mm512_mul_ps(d, d), inv_sxx, inv_n);
+				const __m512 hc = _mm512_mul_ps(ts, sqrt_avx512(q));
+				const __m512 hp = _mm512_mul_ps(ts, sqrt_avx512(_mm512_add_ps(q, one)));
+				_mm512_storeu_ps(o.fit + i, yhat);
+				_mm512_storeu_ps(o.ci_lower + i, _mm512_sub_ps(yhat, hc));
+				_mm512_storeu_ps(o.ci_upper + i, _mm512_add_ps(yhat, hc));
+				_mm512_storeu_ps(o.pi_lower + i, _mm512_sub_ps(yhat, hp));
+				_mm512_storeu_ps(o.pi_upper + i, _mm512_add_ps(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		LINREG_TARGET_AVX2 inline double hmax_avx2(__m256d v) noexcept
+		{
+			__m128d m = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+			return _mm_cvtsd_f64(_mm_max_sd(m, _mm_unpackhi_pd(m, m)));
+		}
+
+		LINREG_TARGET_AVX2 inline float hmax_avx2(__m256 v) noexcept
+		{
+			__m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+			m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+			return _mm_cvtss_f32(_mm_max_ss(m, _mm_shuffle_ps(m, m, 1)));
+		}
+
+		LINREG_TARGET_AVX2 inline DiagnosticSums<double> diagnostics_avx2(const double* x, const double* y, std::size_t n,
+			const DiagnosticCoefficients<double>& c, const DiagnosticRows<double>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			// Element 0 pairs with x[-1] only if the caller owns it; every later
+			// vector reloads its predecessors from x + i - 1
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const __m256d b0 = _mm256_set1_pd(c.beta0), b1 = _mm256_set1_pd(c.beta1), mx = _mm256_set1_pd(c.mean_x);
+			const __m256d inv_n = _mm256_set1_pd(c.inv_n), inv_sxx = _mm256_set1_pd(c.inv_sxx), inv_s = _mm256_set1_pd(c.inv_s);
+			const __m256d one = _mm256_set1_pd(1.0), half = _mm256_set1_pd(0.5);
+			const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+			__m256d sse = _mm256_setzero_pd(), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 4 <= n; i += 4) {
+				const __m256d vx = _mm256_loadu_pd(x + i);
+				const __m256d e = _mm256_sub_pd(_mm256_loadu_pd(y + i), _mm256_fmadd_pd(vx, b1, b0));
+				const __m256d ep = _mm256_sub_pd(_mm256_loadu_pd(y + i - 1), _mm256_fmadd_pd(_mm256_loadu_pd(x + i - 1), b1, b0));
+				const __m256d d = _mm256_sub_pd(vx, mx);
+				const __m256d h = _mm256_fmadd_pd(_mm256_mul_pd(d, d), inv_sxx, inv_n);
+				const __m256d q = _mm256_sub_pd(one, h);
+				const __m256d r = _mm256_div_pd(_mm256_mul_pd(e, inv_s), _mm256_sqrt_pd(q));
+				const __m256d de = _mm256_sub_pd(e, ep);
+				sse = _mm256_fmadd_pd(e, e, sse);
+				dw = _mm256_fmadd_pd(de, de, dw);
+				emax = _mm256_max_pd(emax, _mm256_and_pd(e, abs_mask));
+				if (o.residual) _mm256_storeu_pd(o.residual + i, e);
+				if (o.leverage) _mm256_storeu_pd(o.leverage + i, h);
+				if (o.standardized) _mm256_storeu_pd(o.standardized + i, r);
+				if (o.cooks_distance)
+					_mm256_storeu_pd(o.cooks_distance + i, _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(r, r), _mm256_mul_pd(h, half)), q));
+			}
+			s = s + DiagnosticSums<double>{ hsum_avx2(sse), hsum_avx2(dw), hmax_avx2(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+
+		LINREG_TARGET_AVX2 inline DiagnosticSums<float> diagnostics_avx2(const float* x, const float* y, std::size_t n,
+			const DiagnosticCoefficients<float>& c, const DiagnosticRows<float>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			// Element 0 pairs with x[-1] only if the caller owns it; every later
+			// vector reloads its predecessors from x + i - 1
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const __m256 b0 = _mm256_set1_ps(c.beta0), b1 = _mm256_set1_ps(c.beta1), mx = _mm256_set1_ps(c.mean_x);
+			const __m256 inv_n = _mm256_set1_ps(c.inv_n), inv_sxx = _mm256_set1_ps(c.inv_sxx), inv_s = _mm256_set1_ps(c.inv_s);
+			const __m256 one = _mm256_set1_ps(1.0f), half = _mm256_set1_ps(0.5f);
+			const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+			__m256 sse = _mm256_setzero_ps(), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 8 <= n; i += 8) {
+				const __m256 vx = _mm256_loadu_ps(x + i);
+				const __m256 e = _mm256_sub_ps(_mm256_loadu_ps(y + i), _mm256_fmadd_ps(vx, b1, b0));
+				const __m256 ep = _mm256_sub_ps(_mm256_loadu_ps(y + i - 1), _mm256_fmadd_ps(_mm256_loadu_ps(x + i - 1), b1, b0));
+				const __m256 d = _mm256_sub_ps(vx, mx);
+				const __m256 h = _mm256_fmadd_ps(_mm256_mul_ps(d, d), inv_sxx, inv_n);
+				const __m256 q = _mm256_sub_ps(one, h);
+				const __m256 r = _mm256_div_ps(_mm256_mul_ps(e, inv_s), _mm256_sqrt_ps(q));
+				const __m256 de = _mm256_sub_ps(e, ep);
+				sse = _mm256_fmadd_ps(e, e, sse);
+				dw = _mm256_fmadd_ps(de, de, dw);
+				emax = _mm256_max_ps(emax, _mm256_and_ps(e, abs_mask));
+				if (o.residual) _mm256_storeu_ps(o.residual + i, e);
+				if (o.leverage) _mm256_storeu_ps(o.leverage + i, h);
+				if (o.standardized) _mm256_storeu_ps(o.standardized + i, r);
+				if (o.cooks_distance)
+					_mm256_storeu_ps(o.cooks_distance + i, _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(r, r), _mm256_mul_ps(h, half)), q));
+			}
+			s = s + DiagnosticSums<float>{ hsum_avx2(sse), hsum_avx2(dw), hmax_avx2(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+
+		LINREG_TARGET_AVX512 inline double hmax_avx512(__m512d v) noexcept
+		{
+			alignas(64) double t[8];
+			_mm512_store_pd(t, v);
+			double m = t[0];
+			for (int k = 1; k < 8; ++k)
+				m = std::max(m, t[k]);
+			return m;
+		}
+
+		LINREG_TARGET_AVX512 inline float hmax_avx512(__m512 v) noexcept
+		{
+			alignas(64) float t[16];
+			_mm512_store_ps(t, v);
+			float m = t[0];
+			for (int k = 1; k < 16; ++k)
+				m = std::max(m, t[k]);
+			return m;
+		}
+
+		LINREG_TARGET_AVX512 inline DiagnosticSums<double> diagnostics_avx512(const double* x, const double* y, std::size_t n,
+			const DiagnosticCoefficients<double>& c, const DiagnosticRows<double>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			// Element 0 pairs with x[-1] only if the caller owns it; every later
+			// vector reloads its predecessors from x + i - 1
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const __m512d b0 = _mm512_set1_pd(c.beta0), b1 = _mm512_set1_pd(c.beta1), mx = _mm512_set1_pd(c.mean_x);
+			const __m512d inv_n = _mm512_set1_pd(c.inv_n), inv_sxx = _mm512_set1_pd(c.inv_sxx), inv_s = _mm512_set1_pd(c.inv_s);
+			const __m512d one = _mm512_set1_pd(1.0), half = _mm512_set1_pd(0.5);
+			// AVX-512F has no floating-point and; clear the sign bit in the integer domain
+			const __m512i abs_mask = _mm512_set1_epi64(0x7FFFFFFFFFFFFFFF);
+			__m512d sse = _mm512_setzero_pd(), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 8 <= n; i += 8) {
+				const __m512d vx = _mm512_loadu_pd(x + i);
+				const __m512d e = _mm512_sub_pd(_mm512_loadu_pd(y + i), _mm512_fmadd_pd(vx, b1, b0));
+				const __m512d ep = _mm512_sub_pd(_mm512_loadu_pd(y + i - 1), _mm512_fmadd_pd(_mm512_loadu_pd(x + i - 1), b1, b0));
+				const __m512d d = _mm512_sub_pd(vx, mx);
+				const __m512d h = _mm512_fmadd_pd(_mm512_mul_pd(d, d), inv_sxx, inv_n);
+				const __m512d q = _mm512_sub_pd(one, h);
+				const __m512d r = _mm512_div_pd(_mm512_mul_pd(e, inv_s), sqrt_avx512(q));
+				const __m512d de = _mm512_sub_pd(e, ep);
+				sse = _mm512_fmadd_pd(e, e, sse);
+				dw = _mm512_fmadd_pd(de, de, dw);
+				emax = max_avx512(emax, _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(e), abs_mask)));
+				if (o.residual) _mm512_storeu_pd(o.residual + i, e);
+				if (o.leverage) _mm512_storeu_pd(o.leverage + i, h);
+				if (o.standardized) _mm512_storeu_pd(o.standardized + i, r);
+				if (o.cooks_distance)
+					_mm512_storeu_pd(o.cooks_distance + i, _mm512_div_pd(_mm512_mul_pd(_mm512_mul_pd(r, r), _mm512_mul_pd(h, half)), q));
+			}
+			s = s + DiagnosticSums<double>{ hsum_avx512(sse), hsum_avx512(dw), hmax_avx512(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+
+		LINREG_TARGET_AVX512 inline DiagnosticSums<float> diagnostics_avx512(const float* x, const float* y, std::size_t n,
+			const DiagnosticCoefficients<float>& c, const DiagnosticRows<float>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			// Element 0 pairs with x[-1] only if the caller owns it; every later
+			// vector reloads its predecessors from x + i - 1
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const __m512 b0 = _mm512_set1_ps(c.beta0), b1 = _mm512_set1_ps(c.beta1), mx = _mm512_set1_ps(c.mean_x);
+			const __m512 inv_n = _mm512_set1_ps(c.inv_n), inv_sxx = _mm512_set1_ps(c.inv_sxx), inv_s = _mm512_set1_ps(c.inv_s);
+			const __m512 one = _mm512_set1_ps(1.0f), half = _mm512_set1_ps(0.5f);
+			const __m512i abs_mask = _mm512_set1_epi32(0x7FFFFFFF);
+			__m512 sse = _mm512_setzero_ps(), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 16 <= n; i += 16) {
+				const __m512 vx = _mm512_loadu_ps(x + i);
+				const __m512 e = _mm512_sub_ps(_mm512_loadu_ps(y + i), _mm512_fmadd_ps(vx, b1, b0));
+				const __m512 ep = _mm512_sub_ps(_mm512_loadu_ps(y + i - 1), _mm512_fmadd_ps(_mm512_loadu_ps(x + i - 1), b1, b0));
+				const __m512 d = _mm512_sub_ps(vx, mx);
+				const __m512 h = _mm512_fmadd_ps(_mm512_mul_ps(d, d), inv_sxx, inv_n);
+				const __m512 q = _mm512_sub_ps(one, h);
+				const __m512 r = _mm512_div_ps(_mm512_mul_ps(e, inv_s), sqrt_avx512(q));
+				const __m512 de = _mm512_sub_ps(e, ep);
+				sse = _mm512_fmadd_ps(e, e, sse);
+				dw = _mm512_fmadd_ps(de, de, dw);
+				emax = max_avx512(emax, _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(e), abs_mask)));
+				if (o.residual) _mm512_storeu_ps(o.residual + i, e);
+				if (o.leverage) _mm512_storeu_ps(o.leverage + i, h);
+				if (o.standardized) _mm512_storeu_ps(o.standardized + i, r);
+				if (o.cooks_distance)
+					_mm512_storeu_ps(o.cooks_distance + i, _mm512_div_ps(_mm512_mul_ps(_mm512_mul_ps(r, r), _mm512_mul_ps(h, half)), q));
+			}
+			s = s + DiagnosticSums<float>{ hsum_avx512(sse), hsum_avx512(dw), hmax_avx512(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+#endif // LINREG_SIMD_X86
+
+#if defined(LINREG_SIMD_NEON)
+		// ---------------------------------------------------------------
+		// NEON (AArch64)
+		// ---------------------------------------------------------------
+
+		inline double sum_neon(const double* x, std::size_t n) noexcept
+		{
+			float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				a0 = vaddq_f64(a0, vld1q_f64(x + i));
+				a1 = vaddq_f64(a1, vld1q_f64(x + i + 2));
+				a2 = vaddq_f64(a2, vld1q_f64(x + i + 4));
+				a3 = vaddq_f64(a3, vld1q_f64(x + i + 6));
+			}
+			double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		inline float sum_neon(const float* x, std::size_t n) noexcept
+		{
+			float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = vaddq_f32(a0, vld1q_f32(x + i));
+				a1 = vaddq_f32(a1, vld1q_f32(x + i + 4));
+				a2 = vaddq_f32(a2, vld1q_f32(x + i + 8));
+				a3 = vaddq_f32(a3, vld1q_f32(x + i + 12));
+			}
+			float s = vaddvq_f32(vaddq_f32(vaddq_f32(a0, a1), vaddq_f32(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		inline void sum2_neon(const double* x, const double* y, std::size_t n, double& sx, double& sy) noexcept
+		{
+			float64x2_t x0 = vdupq_n_f64(0.0), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				x0 = vaddq_f64(x0, vld1q_f64(x + i));
+				y0 = vaddq_f64(y0, vld1q_f64(y + i));
+				x1 = vaddq_f64(x1, vld1q_f64(x + i + 2));
+				y1 = vaddq_f64(y1, vld1q_f64(y + i + 2));
+			}
+			sx = vaddvq_f64(vaddq_f64(x0, x1));
+			sy = vaddvq_f64(vaddq_f64(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		inline void sum2_neon(const float* x, const float* y, std::size_t n, float& sx, float& sy) noexcept
+		{
+			float32x4_t x0 = vdupq_n_f32(0.0f), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				x0 = vaddq_f32(x0, vld1q_f32(x + i));
+				y0 = vaddq_f32(y0, vld1q_f32(y + i));
+				x1 = vaddq_f32(x1, vld1q_f32(x + i + 4));
+				y1 = vaddq_f32(y1, vld1q_f32(y + i + 4));
+			}
+			sx = vaddvq_f32(vaddq_f32(x0, x1));
+			sy = vaddvq_f32(vaddq_f32(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		inline double dot_neon(const double* x, const double* y, std::size_t n) noexcept
+		{
+			float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				a0 = vfmaq_f64(a0, vld1q_f64(x + i), vld1q_f64(y + i));
+				a1 = vfmaq_f64(a1, vld1q_f64(x + i + 2), vld1q_f64(y + i + 2));
+				a2 = vfmaq_f64(a2, vld1q_f64(x + i + 4), vld1q_f64(y + i + 4));
+				a3 = vfmaq_f64(a3, vld1q_f64(x + i + 6), vld1q_f64(y + i + 6));
+			}
+			double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		inline float dot_neon(const float* x, const float* y, std::size_t n) noexcept
+		{
+			float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				a0 = vfmaq_f32(a0, vld1q_f32(x + i), vld1q_f32(y + i));
+				a1 = vfmaq_f32(a1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+				a2 = vfmaq_f32(a2, vld1q_f32(x + i + 8), vld1q_f32(y + i + 8));
+				a3 = vfmaq_f32(a3, vld1q_f32(x + i + 12), vld1q_f32(y + i + 12));
+			}
+			float s = vaddvq_f32(vaddq_f32(vaddq_f32(a0, a1), vaddq_f32(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i] * y[i];
+			return s;
+		}
+
+		inline CenteredSums<double> centered_sums_neon(
+			const double* x, const double* y, std::size_t n, double a, double b) noexcept
+		{
+			const float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+			float64x2_t cx0 = vdupq_n_f64(0.0), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			float64x2_t cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float64x2_t dx0 = vsubq_f64(vld1q_f64(x + i), va);
+				const float64x2_t dy0 = vsubq_f64(vld1q_f64(y + i), vb);
+				const float64x2_t dx1 = vsubq_f64(vld1q_f64(x + i + 2), va);
+				const float64x2_t dy1 = vsubq_f64(vld1q_f64(y + i + 2), vb);
+				cx0 = vaddq_f64(cx0, dx0);  cx1 = vaddq_f64(cx1, dx1);
+				cy0 = vaddq_f64(cy0, dy0);  cy1 = vaddq_f64(cy1, dy1);
+				xx0 = vfmaq_f64(xx0, dx0, dx0);  xx1 = vfmaq_f64(xx1, dx1, dx1);
+				yy0 = vfmaq_f64(yy0, dy0, dy0);  yy1 = vfmaq_f64(yy1, dy1, dy1);
+				xy0 = vfmaq_f64(xy0, dx0, dy0);  xy1 = vfmaq_f64(xy1, dx1, dy1);
+			}
+			CenteredSums<double> s{
+				vaddvq_f64(vaddq_f64(cx0, cx1)), vaddvq_f64(vaddq_f64(cy0, cy1)),
+				vaddvq_f64(vaddq_f64(xx0, xx1)), vaddvq_f64(vaddq_f64(yy0, yy1)),
+				vaddvq_f64(vaddq_f64(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		inline CenteredSums<float> centered_sums_neon(
+			const float* x, const float* y, std::size_t n, float a, float b) noexcept
+		{
+			const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+			float32x4_t cx0 = vdupq_n_f32(0.0f), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			float32x4_t cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const float32x4_t dx0 = vsubq_f32(vld1q_f32(x + i), va);
+				const float32x4_t dy0 = vsubq_f32(vld1q_f32(y + i), vb);
+				const float32x4_t dx1 = vsubq_f32(vld1q_f32(x + i + 4), va);
+				const float32x4_t dy1 = vsubq_f32(vld1q_f32(y + i + 4), vb);
+				cx0 = vaddq_f32(cx0, dx0);  cx1 = vaddq_f32(cx1, dx1);
+				cy0 = vaddq_f32(cy0, dy0);  cy1 = vaddq_f32(cy1, dy1);
+				xx0 = vfmaq_f32(xx0, dx0, dx0);  xx1 = vfmaq_f32(xx1, dx1, dx1);
+				yy0 = vfmaq_f32(yy0, dy0, dy0);  yy1 = vfmaq_f32(yy1, dy1, dy1);
+				xy0 = vfmaq_f32(xy0, dx0, dy0);  xy1 = vfmaq_f32(xy1, dx1, dy1);
+			}
+			CenteredSums<float> s{
+				vaddvq_f32(vaddq_f32(cx0, cx1)), vaddvq_f32(vaddq_f32(cy0, cy1)),
+				vaddvq_f32(vaddq_f32(xx0, xx1)), vaddvq_f32(vaddq_f32(yy0, yy1)),
+				vaddvq_f32(vaddq_f32(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// float storage, double accumulation: 4 floats widened to two float64x2_t
+
+		inline double sum_widen_neon(const float* x, std::size_t n) noexcept
+		{
+			float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const float32x4_t v0 = vld1q_f32(x + i), v1 = vld1q_f32(x + i + 4);
+				a0 = vaddq_f64(a0, vcvt_f64_f32(vget_low_f32(v0)));
+				a1 = vaddq_f64(a1, vcvt_high_f64_f32(v0));
+				a2 = vaddq_f64(a2, vcvt_f64_f32(vget_low_f32(v1)));
+				a3 = vaddq_f64(a3, vcvt_high_f64_f32(v1));
+			}
+			double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+			for (; i < n; ++i)
+				s += x[i];
+			return s;
+		}
+
+		inline void sum2_widen_neon(const float* x, const float* y, std::size_t n, double& sx, double& sy) noexcept
+		{
+			float64x2_t x0 = vdupq_n_f64(0.0), x1 = x0, y0 = x0, y1 = x0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vx = vld1q_f32(x + i), vy = vld1q_f32(y + i);
+				x0 = vaddq_f64(x0, vcvt_f64_f32(vget_low_f32(vx)));
+				x1 = vaddq_f64(x1, vcvt_high_f64_f32(vx));
+				y0 = vaddq_f64(y0, vcvt_f64_f32(vget_low_f32(vy)));
+				y1 = vaddq_f64(y1, vcvt_high_f64_f32(vy));
+			}
+			sx = vaddvq_f64(vaddq_f64(x0, x1));
+			sy = vaddvq_f64(vaddq_f64(y0, y1));
+			for (; i < n; ++i) {
+				sx += x[i];
+				sy += y[i];
+			}
+		}
+
+		inline double dot_widen_neon(const float* x, const float* y, std::size_t n) noexcept
+		{
+			float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vx = vld1q_f32(x + i), vy = vld1q_f32(y + i);
+				a0 = vfmaq_f64(a0, vcvt_f64_f32(vget_low_f32(vx)), vcvt_f64_f32(vget_low_f32(vy)));
+				a1 = vfmaq_f64(a1, vcvt_high_f64_f32(vx), vcvt_high_f64_f32(vy));
+			}
+			double s = vaddvq_f64(vaddq_f64(a0, a1));
+			for (; i < n; ++i)
+				s += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+			return s;
+		}
+
+		inline CenteredSums<double> centered_sums_widen_neon(
+			const float* x, const float* y, std::size_t n, double a, double b) noexcept
+		{
+			const float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+			float64x2_t cx0 = vdupq_n_f64(0.0), cy0 = cx0, xx0 = cx0, yy0 = cx0, xy0 = cx0;
+			float64x2_t cx1 = cx0, cy1 = cx0, xx1 = cx0, yy1 = cx0, xy1 = cx0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vx = vld1q_f32(x + i), vy = vld1q_f32(y + i);
+				const float64x2_t dx0 = vsubq_f64(vcvt_f64_f32(vget_low_f32(vx)), va);
+				const float64x2_t dy0 = vsubq_f64(vcvt_f64_f32(vget_low_f32(vy)), vb);
+				const float64x2_t dx1 = vsubq_f64(vcvt_high_f64_f32(vx), va);
+				const float64x2_t dy1 = vsubq_f64(vcvt_high_f64_f32(vy), vb);
+				cx0 = vaddq_f64(cx0, dx0);  cx1 = vaddq_f64(cx1, dx1);
+				cy0 = vaddq_f64(cy0, dy0);  cy1 = vaddq_f64(cy1, dy1);
+				xx0 = vfmaq_f64(xx0, dx0, dx0);  xx1 = vfmaq_f64(xx1, dx1, dx1);
+				yy0 = vfmaq_f64(yy0, dy0, dy0);  yy1 = vfmaq_f64(yy1, dy1, dy1);
+				xy0 = vfmaq_f64(xy0, dx0, dy0);  xy1 = vfmaq_f64(xy1, dx1, dy1);
+			}
+			CenteredSums<double> s{
+				vaddvq_f64(vaddq_f64(cx0, cx1)), vaddvq_f64(vaddq_f64(cy0, cy1)),
+				vaddvq_f64(vaddq_f64(xx0, xx1)), vaddvq_f64(vaddq_f64(yy0, yy1)),
+				vaddvq_f64(vaddq_f64(xy0, xy1)) };
+			const auto tail = centered_sums_scalar(x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// ---------------------------------------------------------------
+		// Weighted kernels (NEON)
+		// ---------------------------------------------------------------
+
+		// v with the lanes of zero weight cleared
+		inline float64x2_t where_weighted_neon(float64x2_t w, float64x2_t v) noexcept
+		{
+			return vreinterpretq_f64_u64(vandq_u64(vcgtq_f64(w, vdupq_n_f64(0)), vreinterpretq_u64_f64(v)));
+		}
+
+		inline float32x4_t where_weighted_neon(float32x4_t w, float32x4_t v) noexcept
+		{
+			return vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(w, vdupq_n_f32(0)), vreinterpretq_u32_f32(v)));
+		}
+
+		inline void weighted_sums_neon(const double* w, const double* x, const double* y, std::size_t n,
+			double& sw, double& swx, double& swy) noexcept
+		{
+			float64x2_t w0 = vdupq_n_f64(0), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float64x2_t wa = vld1q_f64(w + i), wb = vld1q_f64(w + i + 2);
+				w0 = vaddq_f64(w0, wa);  w1 = vaddq_f64(w1, wb);
+				x0 = vfmaq_f64(x0, wa, where_weighted_neon(wa, vld1q_f64(x + i)));
+				x1 = vfmaq_f64(x1, wb, where_weighted_neon(wb, vld1q_f64(x + i + 2)));
+				y0 = vfmaq_f64(y0, wa, where_weighted_neon(wa, vld1q_f64(y + i)));
+				y1 = vfmaq_f64(y1, wb, where_weighted_neon(wb, vld1q_f64(y + i + 2)));
+			}
+			double tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = vaddvq_f64(vaddq_f64(w0, w1)) + tw;
+			swx = vaddvq_f64(vaddq_f64(x0, x1)) + tx;
+			swy = vaddvq_f64(vaddq_f64(y0, y1)) + ty;
+		}
+
+		inline CenteredSums<double> weighted_centered_sums_neon(const double* w, const double* x, const double* y,
+			std::size_t n, double a, double b) noexcept
+		{
+			const float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+			float64x2_t cx = vdupq_n_f64(0), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				const float64x2_t vw = vld1q_f64(w + i);
+				const float64x2_t dx = where_weighted_neon(vw, vsubq_f64(vld1q_f64(x + i), va));
+				const float64x2_t dy = where_weighted_neon(vw, vsubq_f64(vld1q_f64(y + i), vb));
+				const float64x2_t wdx = vmulq_f64(vw, dx), wdy = vmulq_f64(vw, dy);
+				cx = vaddq_f64(cx, wdx);
+				cy = vaddq_f64(cy, wdy);
+				xx = vfmaq_f64(xx, wdx, dx);
+				yy = vfmaq_f64(yy, wdy, dy);
+				xy = vfmaq_f64(xy, wdx, dy);
+			}
+			const CenteredSums<double> s{ vaddvq_f64(cx), vaddvq_f64(cy), vaddvq_f64(xx), vaddvq_f64(yy), vaddvq_f64(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		inline void weighted_sums_neon(const float* w, const float* x, const float* y, std::size_t n,
+			float& sw, float& swx, float& swy) noexcept
+		{
+			float32x4_t w0 = vdupq_n_f32(0), w1 = w0, x0 = w0, x1 = w0, y0 = w0, y1 = w0;
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				const float32x4_t wa = vld1q_f32(w + i), wb = vld1q_f32(w + i + 4);
+				w0 = vaddq_f32(w0, wa);  w1 = vaddq_f32(w1, wb);
+				x0 = vfmaq_f32(x0, wa, where_weighted_neon(wa, vld1q_f32(x + i)));
+				x1 = vfmaq_f32(x1, wb, where_weighted_neon(wb, vld1q_f32(x + i + 4)));
+				y0 = vfmaq_f32(y0, wa, where_weighted_neon(wa, vld1q_f32(y + i)));
+				y1 = vfmaq_f32(y1, wb, where_weighted_neon(wb, vld1q_f32(y + i + 4)));
+			}
+			float tw, tx, ty;
+			weighted_sums_scalar(w + i, x + i, y + i, n - i, tw, tx, ty);
+			sw = vaddvq_f32(vaddq_f32(w0, w1)) + tw;
+			swx = vaddvq_f32(vaddq_f32(x0, x1)) + tx;
+			swy = vaddvq_f32(vaddq_f32(y0, y1)) + ty;
+		}
+
+		inline CenteredSums<float> weighted_centered_sums_neon(const float* w, const float* x, const float* y,
+			std::size_t n, float a, float b) noexcept
+		{
+			const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+			float32x4_t cx = vdupq_n_f32(0), cy = cx, xx = cx, yy = cx, xy = cx;
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vw = vld1q_f32(w + i);
+				const float32x4_t dx = where_weighted_neon(vw, vsubq_f32(vld1q_f32(x + i), va));
+				const float32x4_t dy = where_weighted_neon(vw, vsubq_f32(vld1q_f32(y + i), vb));
+				const float32x4_t wdx = vmulq_f32(vw, dx), wdy = vmulq_f32(vw, dy);
+				cx = vaddq_f32(cx, wdx);
+				cy = vaddq_f32(cy, wdy);
+				xx = vfmaq_f32(xx, wdx, dx);
+				yy = vfmaq_f32(yy, wdy, dy);
+				xy = vfmaq_f32(xy, wdx, dy);
+			}
+			const CenteredSums<float> s{ vaddvq_f32(cx), vaddvq_f32(cy), vaddvq_f32(xx), vaddvq_f32(yy), vaddvq_f32(xy) };
+			const auto tail = weighted_centered_sums_scalar(w + i, x + i, y + i, n - i, a, b);
+			return { s.dx + tail.dx, s.dy + tail.dy, s.dxx + tail.dxx, s.dyy + tail.dyy, s.dxy + tail.dxy };
+		}
+
+		// ---------------------------------------------------------------
+		// Elementwise kernels (NEON)
+		// ---------------------------------------------------------------
+
+		inline void affine_neon(const double* x, std::size_t n, double a, double b, double* out) noexcept
+		{
+			const float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				vst1q_f64(out + i, vfmaq_f64(va, vld1q_f64(x + i), vb));
+				vst1q_f64(out + i + 2, vfmaq_f64(va, vld1q_f64(x + i + 2), vb));
+			}
+			for (; i + 2 <= n; i += 2)
+				vst1q_f64(out + i, vfmaq_f64(va, vld1q_f64(x + i), vb));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		inline void bands_neon(const double* x, std::size_t n, const BandCoefficients<double>& c,
+			const BandRows<double>& o) noexcept
+		{
+			const float64x2_t b0 = vdupq_n_f64(c.beta0), b1 = vdupq_n_f64(c.beta1), mx = vdupq_n_f64(c.mean_x);
+			const float64x2_t inv_n = vdupq_n_f64(c.inv_n), inv_sxx = vdupq_n_f64(c.inv_sxx);
+			const float64x2_t ts = vdupq_n_f64(c.ts), one = vdupq_n_f64(1.0);
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				const float64x2_t vx = vld1q_f64(x + i);
+				const float64x2_t yhat = vfmaq_f64(b0, vx, b1);
+				const float64x2_t d = vsubq_f64(vx, mx);
+				const float64x2_t q = vfmaq_f64(inv_n, vmulq_f64(d, d), inv_sxx);
+				const float64x2_t hc = vmulq_f64(ts, vsqrtq_f64(q));
+				const float64x2_t hp = vmulq_f64(ts, vsqrtq_f64(vaddq_f64(q, one)));
+				vst1q_f64(o.fit + i, yhat);
+				vst1q_f64(o.ci_lower + i, vsubq_f64(yhat, hc));
+				vst1q_f64(o.ci_upper + i, vaddq_f64(yhat, hc));
+				vst1q_f64(o.pi_lower + i, vsubq_f64(yhat, hp));
+				vst1q_f64(o.pi_upper + i, vaddq_f64(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		inline void affine_neon(const float* x, std::size_t n, float a, float b, float* out) noexcept
+		{
+			const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				vst1q_f32(out + i, vfmaq_f32(va, vld1q_f32(x + i), vb));
+				vst1q_f32(out + i + 4, vfmaq_f32(va, vld1q_f32(x + i + 4), vb));
+			}
+			for (; i + 4 <= n; i += 4)
+				vst1q_f32(out + i, vfmaq_f32(va, vld1q_f32(x + i), vb));
+			affine_scalar(x + i, n - i, a, b, out + i);
+		}
+
+		inline void bands_neon(const float* x, std::size_t n, const BandCoefficients<float>& c,
+			const BandRows<float>& o) noexcept
+		{
+			const float32x4_t b0 = vdupq_n_f32(c.beta0), b1 = vdupq_n_f32(c.beta1), mx = vdupq_n_f32(c.mean_x);
+			const float32x4_t inv_n = vdupq_n_f32(c.inv_n), inv_sxx = vdupq_n_f32(c.inv_sxx);
+			const float32x4_t ts = vdupq_n_f32(c.ts), one = vdupq_n_f32(1.0f);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vx = vld1q_f32(x + i);
+				const float32x4_t yhat = vfmaq_f32(b0, vx, b1);
+				const float32x4_t d = vsubq_f32(vx, mx);
+				const float32x4_t q = vfmaq_f32(inv_n, vmulq_f32(d, d), inv_sxx);
+				const float32x4_t hc = vmulq_f32(ts, vsqrtq_f32(q));
+				const float32x4_t hp = vmulq_f32(ts, vsqrtq_f32(vaddq_f32(q, one)));
+				vst1q_f32(o.fit + i, yhat);
+				vst1q_f32(o.ci_lower + i, vsubq_f32(yhat, hc));
+				vst1q_f32(o.ci_upper + i, vaddq_f32(yhat, hc));
+				vst1q_f32(o.pi_lower + i, vsubq_f32(yhat, hp));
+				vst1q_f32(o.pi_upper + i, vaddq_f32(yhat, hp));
+			}
+			bands_scalar(x + i, n - i, c, o.at(i));
+		}
+
+		inline DiagnosticSums<double> diagnostics_neon(const double* x, const double* y, std::size_t n,
+			const DiagnosticCoefficients<double>& c, const DiagnosticRows<double>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const float64x2_t b0 = vdupq_n_f64(c.beta0), b1 = vdupq_n_f64(c.beta1), mx = vdupq_n_f64(c.mean_x);
+			const float64x2_t inv_n = vdupq_n_f64(c.inv_n), inv_sxx = vdupq_n_f64(c.inv_sxx), inv_s = vdupq_n_f64(c.inv_s);
+			const float64x2_t one = vdupq_n_f64(1.0), half = vdupq_n_f64(0.5);
+			float64x2_t sse = vdupq_n_f64(0), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 2 <= n; i += 2) {
+				const float64x2_t vx = vld1q_f64(x + i);
+				const float64x2_t e = vsubq_f64(vld1q_f64(y + i), vfmaq_f64(b0, vx, b1));
+				const float64x2_t ep = vsubq_f64(vld1q_f64(y + i - 1), vfmaq_f64(b0, vld1q_f64(x + i - 1), b1));
+				const float64x2_t d = vsubq_f64(vx, mx);
+				const float64x2_t h = vfmaq_f64(inv_n, vmulq_f64(d, d), inv_sxx);
+				const float64x2_t q = vsubq_f64(one, h);
+				const float64x2_t r = vdivq_f64(vmulq_f64(e, inv_s), vsqrtq_f64(q));
+				const float64x2_t de = vsubq_f64(e, ep);
+				sse = vfmaq_f64(sse, e, e);
+				dw = vfmaq_f64(dw, de, de);
+				emax = vmaxq_f64(emax, vabsq_f64(e));
+				if (o.residual) vst1q_f64(o.residual + i, e);
+				if (o.leverage) vst1q_f64(o.leverage + i, h);
+				if (o.standardized) vst1q_f64(o.standardized + i, r);
+				if (o.cooks_distance)
+					vst1q_f64(o.cooks_distance + i, vdivq_f64(vmulq_f64(vmulq_f64(r, r), vmulq_f64(h, half)), q));
+			}
+			s = s + DiagnosticSums<double>{ vaddvq_f64(sse), vaddvq_f64(dw), vmaxvq_f64(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+
+		inline DiagnosticSums<float> diagnostics_neon(const float* x, const float* y, std::size_t n,
+			const DiagnosticCoefficients<float>& c, const DiagnosticRows<float>& o, bool with_previous) noexcept
+		{
+			if (n == 0)
+				return {};
+			auto s = diagnostics_scalar(x, y, 1, c, o, with_previous);
+			const float32x4_t b0 = vdupq_n_f32(c.beta0), b1 = vdupq_n_f32(c.beta1), mx = vdupq_n_f32(c.mean_x);
+			const float32x4_t inv_n = vdupq_n_f32(c.inv_n), inv_sxx = vdupq_n_f32(c.inv_sxx), inv_s = vdupq_n_f32(c.inv_s);
+			const float32x4_t one = vdupq_n_f32(1.0f), half = vdupq_n_f32(0.5f);
+			float32x4_t sse = vdupq_n_f32(0), dw = sse, emax = sse;
+			std::size_t i = 1;
+			for (; i + 4 <= n; i += 4) {
+				const float32x4_t vx = vld1q_f32(x + i);
+				const float32x4_t e = vsubq_f32(vld1q_f32(y + i), vfmaq_f32(b0, vx, b1));
+				const float32x4_t ep = vsubq_f32(vld1q_f32(y + i - 1), vfmaq_f32(b0, vld1q_f32(x + i - 1), b1));
+				const float32x4_t d = vsubq_f32(vx, mx);
+				const float32x4_t h = vfmaq_f32(inv_n, vmulq_f32(d, d), inv_sxx);
+				const float32x4_t q = vsubq_f32(one, h);
+				const float32x4_t r = vdivq_f32(vmulq_f32(e, inv_s), vsqrtq_f32(q));
+				const float32x4_t de = vsubq_f32(e, ep);
+				sse = vfmaq_f32(sse, e, e);
+				dw = vfmaq_f32(dw, de, de);
+				emax = vmaxq_f32(emax, vabsq_f32(e));
+				if (o.residual) vst1q_f32(o.residual + i, e);
+				if (o.leverage) vst1q_f32(o.leverage + i, h);
+				if (o.standardized) vst1q_f32(o.standardized + i, r);
+				if (o.cooks_distance)
+					vst1q_f32(o.cooks_distance + i, vdivq_f32(vmulq_f32(vmulq_f32(r, r), vmulq_f32(h, half)), q));
+			}
+			s = s + DiagnosticSums<float>{ vaddvq_f32(sse), vaddvq_f32(dw), vmaxvq_f32(emax) };
+			return s + diagnostics_scalar(x + i, y + i, n - i, c, o.at(i), true);
+		}
+#endif // LINREG_SIMD_NEON
+
+		template <class T>
+		inline constexpr bool vectorized = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+		/// float storage with double accumulation has its own vector path.
+		template <class T, class Acc>
+		inline constexpr bool widened = std::is_same_v<T, float> && std::is_same_v<Acc, double>;
+
+	} // namespace detail
+
+	/// @brief Instruction set the kernels currently dispatch to.
+	[[nodiscard]]
+	inline Isa active_isa() noexcept
+	{
+		return detail::isa_state().load(std::memory_order_relaxed);
+	}
+
+	/// @brief Best instruction set available on this machine.
+	[[nodiscard]]
+	inline Isa best_isa() noexcept
+	{
+		static const Isa isa = detail::detect_isa();
+		return isa;
+	}
+
+	/**
+	 * @brief Restricts dispatch to a given instruction set (e.g. for benchmarks).
+	 * @return The instruction set actually selected: requests the CPU cannot
+	 *         execute fall back to the best supported one.
+	 */
+	inline Isa set_isa(Isa isa) noexcept
+	{
+		const auto best = best_isa();
+		if (isa != Isa::scalar && isa != best && !(isa == Isa::avx2 && best == Isa::avx512))
+			isa = best;
+		detail::isa_state().store(isa, std::memory_order_relaxed);
+		return isa;
+	}
+
+	/**
+	 * @brief Σxᵢ over n elements.
+	 * @tparam Acc Accumulator type (default: T). float data with Acc = double
+	 *         is widened in registers by a dedicated vector path.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T>
+	[[nodiscard]]
+	Acc sum(const T* x, std::size_t n) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::sum_avx512(x, n);
+			case Isa::avx2:   return detail::sum_avx2(x, n);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::sum_neon(x, n);
+#endif
+			default: break;
+			}
+		}
+		else if constexpr (detail::widened<T, Acc>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::sum_widen_avx512(x, n);
+			case Isa::avx2:   return detail::sum_widen_avx2(x, n);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::sum_widen_neon(x, n);
+#endif
+			default: break;
+			}
+		}
+		return detail::sum_scalar<T, Acc>(x, n);
+	}
+
+	/// @brief Σxᵢ and Σyᵢ over n elements in one pass (accumulated in Acc).
+	template <std::floating_point T, std::floating_point Acc>
+	void sum2(const T* x, const T* y, std::size_t n, Acc& sx, Acc& sy) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::sum2_avx512(x, y, n, sx, sy);
+			case Isa::avx2:   return detail::sum2_avx2(x, y, n, sx, sy);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::sum2_neon(x, y, n, sx, sy);
+#endif
+			default: break;
+			}
+		}
+		else if constexpr (detail::widened<T, Acc>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::sum2_widen_avx512(x, y, n, sx, sy);
+			case Isa::avx2:   return detail::sum2_widen_avx2(x, y, n, sx, sy);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::sum2_widen_neon(x, y, n, sx, sy);
+#endif
+			default: break;
+			}
+		}
+		detail::sum2_scalar(x, y, n, sx, sy);
+	}
+
+	/// @brief Σxᵢyᵢ over n elements (accumulated in Acc, default: T).
+	template <std::floating_point T, std::floating_point Acc = T>
+	[[nodiscard]]
+	Acc dot(const T* x, const T* y, std::size_t n) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::dot_avx512(x, y, n);
+			case Isa::avx2:   return detail::dot_avx2(x, y, n);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::dot_neon(x, y, n);
+#endif
+			default: break;
+			}
+		}
+		else if constexpr (detail::widened<T, Acc>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::dot_widen_avx512(x, y, n);
+			case Isa::avx2:   return detail::dot_widen_avx2(x, y, n);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::dot_widen_neon(x, y, n);
+#endif
+			default: break;
+			}
+		}
+		return detail::dot_scalar<T, Acc>(x, y, n);
+	}
+
+	/**
+	 * @brief The five centered sums of (x - a, y - b) over n elements in one pass.
+	 *
+	 * The offsets a, b and the sums have the accumulator type Acc; each
+	 * element is widened to Acc before it is centered.
+	 */
+	template <std::floating_point T, std::floating_point Acc>
+	[[nodiscard]]
+	CenteredSums<Acc> centered_sums(const T* x, const T* y, std::size_t n, Acc a, Acc b) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::centered_sums_avx512(x, y, n, a, b);
+			case Isa::avx2:   return detail::centered_sums_avx2(x, y, n, a, b);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::centered_sums_neon(x, y, n, a, b);
+#endif
+			default: break;
+			}
+		}
+		else if constexpr (detail::widened<T, Acc>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::centered_sums_widen_avx512(x, y, n, a, b);
+			case Isa::avx2:   return detail::centered_sums_widen_avx2(x, y, n, a, b);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::centered_sums_widen_neon(x, y, n, a, b);
+#endif
+			default: break;
+			}
+		}
+		return detail::centered_sums_scalar(x, y, n, a, b);
+	}
+
+	/// @brief Σwᵢ, Σwᵢxᵢ and Σwᵢyᵢ over n elements in one pass (accumulated in Acc).
+	template <std::floating_point T, std::floating_point Acc>
+	void weighted_sums(const T* w, const T* x, const T* y, std::size_t n, Acc& sw, Acc& swx, Acc& swy) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::weighted_sums_avx512(w, x, y, n, sw, swx, swy);
+			case Isa::avx2:   return detail::weighted_sums_avx2(w, x, y, n, sw, swx, swy);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::weighted_sums_neon(w, x, y, n, sw, swx, swy);
+#endif
+			default: break;
+			}
+		}
+		detail::weighted_sums_scalar(w, x, y, n, sw, swx, swy);
+	}
+
+	/**
+	 * @brief Weighted centered sums: Σwᵢdxᵢ, Σwᵢdyᵢ, Σwᵢdxᵢ², Σwᵢdyᵢ², Σwᵢdxᵢdyᵢ
+	 *        with dx = x - a, dy = y - b, over n elements in one pass.
+	 */
+	template <std::floating_point T, std::floating_point Acc>
+	[[nodiscard]]
+	CenteredSums<Acc> weighted_centered_sums(const T* w, const T* x, const T* y, std::size_t n, Acc a, Acc b) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::weighted_centered_sums_avx512(w, x, y, n, a, b);
+			case Isa::avx2:   return detail::weighted_centered_sums_avx2(w, x, y, n, a, b);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::weighted_centered_sums_neon(w, x, y, n, a, b);
+#endif
+			default: break;
+			}
+		}
+		return detail::weighted_centered_sums_scalar(w, x, y, n, a, b);
+	}
+
+	/// @brief outᵢ = a + b·xᵢ over n elements (out may alias x).
+	template <std::floating_point T>
+	void affine(const T* x, std::size_t n, T a, T b, T* out) noexcept
+	{
+		if constexpr (detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::affine_avx512(x, n, a, b, out);
+			case Isa::avx2:   return detail::affine_avx2(x, n, a, b, out);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::affine_neon(x, n, a, b, out);
+#endif
+			default: break;
+			}
+		}
+		detail::affine_scalar(x, n, a, b, out);
+	}
+
+	/// @brief Fitted values with confidence and prediction bands over n elements.
+	template <std::floating_point T>
+	void bands(const T* x, std::size_t n, const BandCoefficients<T>& c, const BandRows<T>& out) noexcept
+	{
+		if constexpr (detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::bands_avx512(x, n, c, out);
+			case Isa::avx2:   return detail::bands_avx2(x, n, c, out);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::bands_neon(x, n, c, out);
+#endif
+			default: break;
+			}
+		}
+		detail::bands_scalar(x, n, c, out);
+	}
+
+	/**
+	 * @brief Residual diagnostics over n elements in one pass (see DiagnosticCoefficients).
+	 * @param with_previous x[-1] and y[-1] are valid, so (e₀ - e₋₁)² is included in the Durbin-Watson sum.
+	 *
+	 * Null rows of out are skipped.
+	 */
+	template <std::floating_point T, std::floating_point Acc>
+	[[nodiscard]]
+	DiagnosticSums<Acc> diagnostics(const T* x, const T* y, std::size_t n, const DiagnosticCoefficients<Acc>& c,
+		const DiagnosticRows<Acc>& out, bool with_previous) noexcept
+	{
+		if constexpr (std::is_same_v<T, Acc> && detail::vectorized<T>) {
+			switch (active_isa()) {
+#if defined(LINREG_SIMD_X86)
+			case Isa::avx512: return detail::diagnostics_avx512(x, y, n, c, out, with_previous);
+			case Isa::avx2:   return detail::diagnostics_avx2(x, y, n, c, out, with_previous);
+#elif defined(LINREG_SIMD_NEON)
+			case Isa::neon:   return detail::diagnostics_neon(x, y, n, c, out, with_previous);
+#endif
+			default: break;
+			}
+		}
+		return detail::diagnostics_scalar(x, y, n, c, out, with_previous);
+	}
+
+} // namespace Stats::simd
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <algorithm>   // std::max
-#include <cmath>       // std::fabs
+#include <bit>         // std::bit_cast
+#include <cmath>       // std::sqrt
 #include <concepts>    // std::floating_point, std::convertible_to
 #include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
 #include <limits>      // std::numeric_limits
 #include <span>        // std::span
+#include <type_traits> // std::is_constant_evaluated
 
 namespace Helper {
 
@@ -20,6 +23,8 @@ namespace Helper {
      * @param rel_eps Relative tolerance (default: machine epsilon).
      * @param abs_eps Absolute tolerance (default: machine epsilon).
      * @return true if values are approximately equal, false otherwise.
+     *
+     * Usable in constant expressions.
      */
     template <std::floating_point T>
     [[nodiscard]]
@@ -28,14 +33,99 @@ namespace Helper {
         T rel_eps = std::numeric_limits<T>::epsilon(),
         T abs_eps = std::numeric_limits<T>::epsilon())
     {
-        const T diff = std::fabs(a - b);
+        // std::fabs is not constexpr before C++23
+        constexpr auto abs = [](T v) { return v < T{ 0 } ? -v : v; };
+        const T diff = abs(a - b);
 
         // Absolute comparison (near zero)
         if (diff <= abs_eps)
             return true;
 
         // Relative comparison
-        return diff <= std::max(std::fabs(a), std::fabs(b)) * rel_eps;
+        return diff <= std::max(abs(a), abs(b)) * rel_eps;
+    }
+
+    namespace detail {
+
+        /// x - c·c with the rounding error of c·c compensated (Dekker's exact product).
+        template <std::floating_point T>
+        [[nodiscard]]
+        constexpr T square_residual(T x, T c)
+        {
+            constexpr T split = static_cast<T>(std::uint64_t{ 1 } << ((std::numeric_limits<T>::digits + 1) / 2)) + T{ 1 };
+            const T p = c * c;
+            const T t = split * c;
+            const T hi = t - (t - c);
+            const T lo = c - hi;
+            const T err = ((hi * hi - p) + T{ 2 } * hi * lo) + lo * lo;
+            return (x - p) - err;
+        }
+
+        /// Newton's iteration from above, then the neighbour with the smallest residual.
+        template <std::floating_point T>
+        [[nodiscard]]
+        constexpr T sqrt_newton(T x)
+        {
+            // Scale tiny arguments by 4^k (exact) so that the residuals below stay normal
+            constexpr int digits = std::numeric_limits<T>::digits;
+            constexpr T up = static_cast<T>(std::uint64_t{ 1 } << (digits / 2)) * static_cast<T>(std::uint64_t{ 1 } << (digits - digits / 2));
+            constexpr T tiny = std::numeric_limits<T>::min() * up * up;
+            T unscale = T{ 1 };
+            while (x < tiny) {
+                x *= up * up;
+                unscale /= up;
+            }
+
+            T cur = x < T{ 1 } ? T{ 1 } : x;
+            for (;;) {
+                const T next = T{ 0.5 } * (cur + x / cur);
+                if (!(next < cur))
+                    break;
+                cur = next;
+            }
+
+            // The iteration stops within one ulp of the root; pick the
+            // neighbour with the smallest residual (float and double only)
+            if constexpr (std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8)) {
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                constexpr auto abs = [](T v) { return v < T{ 0 } ? -v : v; };
+                const auto bits = std::bit_cast<Bits>(cur);
+                T best = cur;
+                for (const T c : { std::bit_cast<T>(static_cast<Bits>(bits - 1)), std::bit_cast<T>(static_cast<Bits>(bits + 1)) }) {
+                    if (abs(square_residual(x, c)) < abs(square_residual(x, best)))
+                        best = c;
+                }
+                return best * unscale;
+            }
+            else {
+                return cur * unscale;
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Square root that can be evaluated at compile time.
+     *
+     * Calls std::sqrt at run time. In constant evaluation it runs Newton's
+     * iteration and rounds the result to the nearest representable root, so
+     * both paths agree.
+     *
+     * @param x Argument; negative values yield NaN.
+     * @return √x.
+     */
+    template <std::floating_point T>
+    [[nodiscard]]
+    constexpr T sqrt(T x)
+    {
+        if (!std::is_constant_evaluated())
+            return std::sqrt(x);
+
+        if (x < T{ 0 })
+            return std::numeric_limits<T>::quiet_NaN();
+        if (x == T{ 0 } || !(x < std::numeric_limits<T>::infinity()))
+            return x;  // ±0, +inf and NaN are their own roots
+        return detail::sqrt_newton(x);
     }
 
     /**
@@ -1,128 +1,558 @@
 ﻿/**
  * @file stats.h
- * @brief Statistical utility functions (mean-centering, dot product) on spans/containers.
+ * @brief Statistical utility functions (mean-centering, dot product, co-moments) on spans/containers.
  *
  * Notes:
  * - Functions are constrained to floating-point types.
- * - Parallel execution uses std::execution::par and may yield tiny FP rounding differences.
+ * - Every function takes an optional execution policy (see execution.h); the
+ *   default exec::automatic runs small inputs on the calling thread.
+ * - Parallel execution uses std::execution::par and may yield tiny FP rounding differences;
+ *   exec::deterministic gives bit-identical results for any thread count.
+ * - Reductions run chunk-parallel with hand-vectorized kernels inside each chunk
+ *   (see simd_kernels.h).
+ * - co_moments() is a single-pass kernel that allocates no memory; shift_into()
+ *   and the std::pmr overload of shift() let the caller own the centered copy.
+ *   weighted_co_moments() is its counterpart with a weight per point.
+ * - Mixed precision: the span overloads take an accumulator type Acc after the
+ *   storage type T (default: Acc = T), e.g. Stats::co_moments<float, double>(x, y)
+ *   reads float data and accumulates in double. The SIMD kernels widen on load.
  */
 #pragma once
 #include <algorithm>
 #include <concepts>
 #include <execution>
+#include <memory_resource>
 #include <numeric>
 #include <span>
 #include <stdexcept>
 #include <vector>
 
 #include "span_compatible.h"
+#include "execution.h"
+#include "instrumentation.h"
+#include "simd_kernels.h"
 
 namespace Stats {
 
 	/**
 	 * @brief Arithmetic mean of a non-empty dataset.
+	 * @tparam Acc Accumulator and result type (default: T).
 	 * @param data Input values.
+	 * @param policy Execution policy (default: exec::automatic).
 	 * @return Mean value.
 	 * @throws std::invalid_argument if data is empty.
 	 */
-	template <std::floating_point T>
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
 	[[nodiscard]]
-	T mean(std::span<const T> data)
+	Acc mean(std::span<const T> data, const Policy& policy = {})
 	{
 		// Runtime validation: cannot compute mean of empty dataset
 		if (data.empty())
 			throw std::invalid_argument("mean: data must not be empty");
 
-		// using Acc = std::common_type_t<T, double>;
-
 		// Sum all values and divide by count
-		// std::reduce handles the iteration and summation
-		// Initial value T{0} ensures we get floating point precision
-		auto sum = std::reduce(std::execution::par,
-			data.begin(), data.end(),
-			T{ 0 }, std::plus<>{});
-		return sum / static_cast<T>(data.size());
+		// Chunks are summed in parallel, each with the vectorized kernel
+		// Initial value Acc{0} keeps the whole reduction in the accumulator type
+		auto sum = detail::chunked_reduce(policy, data.size(), Acc{ 0 },
+			[p = data.data()](std::size_t begin, std::size_t len) {
+				return simd::sum<T, Acc>(p + begin, len);
+			});
+		return sum / static_cast<Acc>(data.size());
 	}
 
 	/// @brief Convenience overload: accepts any SpanCompatible container.
-	template <Helper::SpanCompatible C>
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
 	[[nodiscard]]
-	auto mean(const C& c)
+	auto mean(const C& c, const Policy& policy = {})
 	{
-		return mean(Helper::as_span(c));
+		return mean(Helper::as_span(c), policy);
 	}
 
 	/**
-	 * @brief Mean-centers a dataset (x[i] -= mean(x)).
+	 * @brief Mean-centers a dataset into caller-provided storage (out[i] = x[i] - mean(x)).
+	 * @tparam Acc Precision of the mean and the subtraction (default: T);
+	 *         the centered values are stored as T.
 	 * @param x Input values.
-	 * @return New vector containing centered values.
-	 * @throws std::invalid_argument if x is empty.
+	 * @param out Output, same size as x; may alias x for in-place centering.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @return The mean that was subtracted.
+	 * @throws std::invalid_argument if x is empty or the sizes differ.
 	 */
-	template <std::floating_point T>
-	[[nodiscard]]
-	std::vector<T> shift(std::span<const T> x)
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	Acc shift_into(std::span<const T> x, std::span<T> out, const Policy& policy = {})
 	{
-		// Create a copy of the data (we'll modify this copy)
-		std::vector<T> data(x.begin(), x.end());
+		// Reads x twice (mean, centering) and writes out once
+		LINREG_STAGE_POLICY(shift, 3 * x.size() * sizeof(T), policy, x.size());
 
 		// Validate input
-		if (data.empty())
+		if (x.empty())
 			throw std::invalid_argument("shift: data must not be empty");
+		if (x.size() != out.size())
+			throw std::invalid_argument("shift: output must have the size of the input");
 
 		// Calculate the mean of the dataset
-		auto m = Stats::mean(data);
+		const auto m = Stats::mean<T, Acc>(x, policy);
+
+		// Subtract mean from each element, chunk by chunk
+		// After this operation, the mean of 'out' will be (approximately) zero
+		const auto chunks = (x.size() + detail::par_chunk - 1) / detail::par_chunk;
+		detail::bulk(policy, x.size(), chunks, [m, x, out](std::size_t c) {
+			const auto begin = c * detail::par_chunk;
+			const auto len = std::min(detail::par_chunk, x.size() - begin);
+			std::transform(x.begin() + begin, x.begin() + begin + len, out.begin() + begin,
+				[m](T v) { return static_cast<T>(static_cast<Acc>(v) - m); });
+		});
 
-		// Subtract mean from each element
-		// After this operation, the mean of 'data' will be (approximately) zero
-		std::transform(std::execution::par,
-			data.begin(), data.end(), data.begin(),
-			[m](T v) { return v - m; });
+		return m;
+	}
 
+	/**
+	 * @brief Mean-centers a dataset (x[i] -= mean(x)).
+	 * @tparam Acc Precision of the mean and the subtraction (default: T);
+	 *         the centered values are stored as T.
+	 * @param x Input values.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @return New vector containing centered values.
+	 * @throws std::invalid_argument if x is empty.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	std::vector<T> shift(std::span<const T> x, const Policy& policy = {})
+	{
+		std::vector<T> data(x.size());
+		LINREG_COUNT_ALLOCATION();
+		shift_into<T, Acc>(x, std::span<T>(data), policy);
+		return data;
+	}
+
+	/**
+	 * @brief Mean-centers a dataset into a vector allocated from a memory resource.
+	 *
+	 * Use with a ScratchScope (see arena.h) to keep temporaries off the global heap.
+	 * @param x Input values.
+	 * @param resource Allocator of the result.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @return New vector containing centered values.
+	 * @throws std::invalid_argument if x is empty.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	std::pmr::vector<T> shift(std::span<const T> x, std::pmr::memory_resource* resource, const Policy& policy = {})
+	{
+		std::pmr::vector<T> data(x.size(), resource);
+		shift_into<T, Acc>(x, std::span<T>(data), policy);
 		return data;
 	}
 
 	/// @brief Convenience overload: accepts any SpanCompatible container.
-	template <Helper::SpanCompatible C>
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
 	[[nodiscard]]
-	auto shift(const C& c)
+	auto shift(const C& c, const Policy& policy = {})
 	{
-		return shift(Helper::as_span(c));
+		return shift(Helper::as_span(c), policy);
 	}
 
 	/**
 	 * @brief Dot product of two equally-sized vectors.
+	 * @tparam Acc Accumulator and result type (default: T).
 	 * @param x First vector.
 	 * @param y Second vector.
 	 * @return Sum of x[i] * y[i].
+	 * @param policy Execution policy (default: exec::automatic).
 	 * @throws std::invalid_argument if sizes differ or size < 2.
 	 *
-	 * Uses std::transform_reduce with std::execution::par.
+	 * Chunks are reduced in parallel with the vectorized kernel simd::dot().
 	 */
-	template <std::floating_point T>
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
 	[[nodiscard]]
-	T inner_product(std::span<const T> x, std::span<const T> y)
+	Acc inner_product(std::span<const T> x, std::span<const T> y, const Policy& policy = {})
 	{
 
+		LINREG_STAGE_POLICY(inner_product, 2 * x.size() * sizeof(T), policy, x.size());
+
 		// Runtime validation: vectors must have same size and at least 2 elements
 		if (x.size() != y.size() || x.size() < 2)
 			throw std::invalid_argument("inner_product: vectors must have same size >= 2");
 
-		// Calculate the dot product using transform_reduce
-		// This is the modern C++17 way to compute element-wise operations
-		return std::transform_reduce(std::execution::par,
-			x.begin(), x.end(),
-			y.begin(),
-			T{},
-			std::plus<>{},
-			std::multiplies<>{});
+		// Calculate the dot product chunk by chunk
+		// Each chunk uses the vectorized kernel with multiple accumulators
+		return detail::chunked_reduce(policy, x.size(), Acc{},
+			[px = x.data(), py = y.data()](std::size_t begin, std::size_t len) {
+				return simd::dot<T, Acc>(px + begin, py + begin, len);
+			});
+	}
+
+	/// @brief Convenience overload: accepts any SpanCompatible container.
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	auto inner_product(const C& x, const C& y, const Policy& policy = {})
+	{
+		return inner_product(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	/// @brief Result of inner_products(): the three dot products of a pair of vectors.
+	template <std::floating_point T>
+	struct InnerProducts {
+		T xx{};  ///< Σxᵢ²
+		T yy{};  ///< Σyᵢ²
+		T xy{};  ///< Σxᵢyᵢ
+
+		constexpr InnerProducts operator+(const InnerProducts& o) const noexcept
+		{
+			return { xx + o.xx, yy + o.yy, xy + o.xy };
+		}
+	};
+
+	/**
+	 * @brief Fused x·x, y·y and x·y in a single pass.
+	 * @tparam Acc Accumulator and result type (default: T).
+	 * @param x First vector.
+	 * @param y Second vector.
+	 * @return InnerProducts with Σx², Σy² and Σxy.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @throws std::invalid_argument if sizes differ or size < 2.
+	 *
+	 * Equivalent to three inner_product() calls but loads each element once.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	InnerProducts<Acc> inner_products(std::span<const T> x, std::span<const T> y, const Policy& policy = {})
+	{
+		LINREG_STAGE_POLICY(inner_product, 2 * x.size() * sizeof(T), policy, x.size());
+
+		if (x.size() != y.size() || x.size() < 2)
+			throw std::invalid_argument("inner_products: vectors must have same size >= 2");
+
+		return detail::chunked_reduce(policy, x.size(), InnerProducts<Acc>{},
+			[px = x.data(), py = y.data()](std::size_t begin, std::size_t len) {
+				const auto s = simd::centered_sums(px + begin, py + begin, len, Acc{ 0 }, Acc{ 0 });
+				return InnerProducts<Acc>{ s.dxx, s.dyy, s.dxy };
+			});
+	}
+
+	/// @brief Convenience overload: accepts any SpanCompatible container.
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	auto inner_products(const C& x, const C& y, const Policy& policy = {})
+	{
+		return inner_products(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+	/**
+	 * @brief Sufficient statistics of a paired sample: count, means and co-moments.
+	 *
+	 * sxx, syy and sxy are sums of centered products (Σ(xᵢ - x̄)², ...), so the
+	 * numerical stability of explicit centering is preserved. Two instances are
+	 * combined with merge() using the pairwise formulas of Chan, Golub & LeVeque.
+	 */
+	template <std::floating_point T>
+	struct CoMoments {
+		std::size_t n{};  ///< Number of points
+		T mean_x{};       ///< x̄
+		T mean_y{};       ///< ȳ
+		T sxx{};          ///< Σ(xᵢ - x̄)²
+		T syy{};          ///< Σ(yᵢ - ȳ)²
+		T sxy{};          ///< Σ(xᵢ - x̄)(yᵢ - ȳ)
+
+		/// @brief Adds a single point (Welford update).
+		constexpr void push(T x, T y) noexcept
+		{
+			++n;
+			const T dx = x - mean_x;
+			const T dy = y - mean_y;
+			mean_x += dx / static_cast<T>(n);
+			mean_y += dy / static_cast<T>(n);
+			// Old deviation times new deviation keeps the update exact in exact arithmetic
+			sxx += dx * (x - mean_x);
+			syy += dy * (y - mean_y);
+			sxy += dx * (y - mean_y);
+		}
+
+		/**
+		 * @brief Removes a point previously added (inverse Welford update).
+		 *
+		 * Rounding errors of repeated push/pop pairs accumulate slowly; callers
+		 * that pop indefinitely should recompute from the data now and then.
+		 */
+		constexpr void pop(T x, T y) noexcept
+		{
+			if (n <= 1) {
+				*this = {};
+				return;
+			}
+			--n;
+			const T dx_new = x - mean_x;
+			const T dy_new = y - mean_y;
+			mean_x -= dx_new / static_cast<T>(n);
+			mean_y -= dy_new / static_cast<T>(n);
+			const T dx = x - mean_x;
+			sxx = std::max(sxx - dx * dx_new, T{ 0 });
+			syy = std::max(syy - (y - mean_y) * dy_new, T{ 0 });
+			sxy -= dx * dy_new;
+		}
+
+		/// @brief Combines another partial result into this one.
+		constexpr void merge(const CoMoments& other) noexcept
+		{
+			if (other.n == 0)
+				return;
+			if (n == 0) {
+				*this = other;
+				return;
+			}
+			const auto na = static_cast<T>(n);
+			const auto nb = static_cast<T>(other.n);
+			const auto nab = na + nb;
+			const T dx = other.mean_x - mean_x;
+			const T dy = other.mean_y - mean_y;
+			const T f = na * nb / nab;
+
+			sxx += other.sxx + dx * dx * f;
+			syy += other.syy + dy * dy * f;
+			sxy += other.sxy + dx * dy * f;
+			mean_x += dx * (nb / nab);
+			mean_y += dy * (nb / nab);
+			n += other.n;
+		}
+	};
+
+	namespace detail {
+
+		/// Block length of the co-moment kernel; a block of x and y stays in L1.
+		inline constexpr std::size_t co_moment_block = 256;
+
+		/**
+		 * @brief Corrected two-pass co-moments of one cache-resident block.
+		 *
+		 * The second pass re-reads the block from L1, so main memory is only
+		 * streamed once. The Σdx, Σdy terms compensate for rounding in the
+		 * block mean (Chan, Golub & LeVeque, "corrected two-pass algorithm").
+		 */
+		template <std::floating_point T, std::floating_point Acc = T>
+		[[nodiscard]]
+		CoMoments<Acc> block_co_moments(const T* x, const T* y, std::size_t n) noexcept
+		{
+			Acc sx{}, sy{};
+			simd::sum2(x, y, n, sx, sy);
+			const auto cnt = static_cast<Acc>(n);
+			const Acc mx = sx / cnt;
+			const Acc my = sy / cnt;
+
+			const auto c = simd::centered_sums(x, y, n, mx, my);
+			return { n, mx, my,
+				c.dxx - c.dx * c.dx / cnt,
+				c.dyy - c.dy * c.dy / cnt,
+				c.dxy - c.dx * c.dy / cnt };
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Means and centered co-moments of a paired sample in one streaming pass.
+	 * @tparam Acc Accumulator and result type (default: T).
+	 * @param x First variable.
+	 * @param y Second variable.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @return CoMoments with n, x̄, ȳ, Sxx, Syy and Sxy (all zero if empty).
+	 * @throws std::invalid_argument if sizes differ.
+	 *
+	 * Processes the data in cache-sized blocks and merges the block results,
+	 * so no heap memory is allocated and each element is loaded from memory once.
+	 * Under a parallel policy, chunks of blocks are reduced concurrently and merged.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	CoMoments<Acc> co_moments(std::span<const T> x, std::span<const T> y, const Policy& policy = {})
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("co_moments: vectors must have same size");
+
+		return detail::chunked_reduce(policy, x.size(), CoMoments<Acc>{},
+			[px = x.data(), py = y.data()](std::size_t begin, std::size_t len) {
+				CoMoments<Acc> result{};
+				for (std::size_t i = begin; i < begin + len; i += detail::co_moment_block) {
+					const auto blk = std::min(detail::co_moment_block, begin + len - i);
+					result.merge(detail::block_co_moments<T, Acc>(px + i, py + i, blk));
+				}
+				return result;
+			},
+			[](CoMoments<Acc> a, const CoMoments<Acc>& b) {
+				a.merge(b);
+				return a;
+			});
+	}
+
+	/// @brief Convenience overload: accepts any SpanCompatible container.
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	auto co_moments(const C& x, const C& y, const Policy& policy = {})
+	{
+		return co_moments(Helper::as_span(x), Helper::as_span(y), policy);
+	}
+
+
+	/**
+	 * @brief Weighted sufficient statistics of a paired sample.
+	 *
+	 * Like CoMoments, with each point counted with its weight wᵢ ≥ 0:
+	 * x̄ = Σwᵢxᵢ / Σwᵢ, Sxx = Σwᵢ(xᵢ - x̄)², and so on. n counts the points
+	 * with positive weight; points of weight zero leave the moments unchanged.
+	 */
+	template <std::floating_point T>
+	struct WeightedCoMoments {
+		std::size_t n{};  ///< Number of points with wᵢ > 0
+		T sum_w{};        ///< Σwᵢ
+		T mean_x{};       ///< Weighted mean of x
+		T mean_y{};       ///< Weighted mean of y
+		T sxx{};          ///< Σwᵢ(xᵢ - x̄)²
+		T syy{};          ///< Σwᵢ(yᵢ - ȳ)²
+		T sxy{};          ///< Σwᵢ(xᵢ - x̄)(yᵢ - ȳ)
+
+		/// @brief Adds a single weighted point (West's weighted Welford update).
+		constexpr void push(T x, T y, T w) noexcept
+		{
+			if (!(w > T{ 0 }))
+				return;
+			++n;
+			sum_w += w;
+			const T dx = x - mean_x;
+			const T dy = y - mean_y;
+			const T r = w / sum_w;
+			mean_x += dx * r;
+			mean_y += dy * r;
+			sxx += w * dx * (x - mean_x);
+			syy += w * dy * (y - mean_y);
+			sxy += w * dx * (y - mean_y);
+		}
+
+		/// @brief Combines another partial result into this one.
+		constexpr void merge(const WeightedCoMoments& other) noexcept
+		{
+			if (other.n == 0)
+				return;
+			if (n == 0) {
+				*this = other;
+				return;
+			}
+			const auto wab = sum_w + other.sum_w;
+			const T dx = other.mean_x - mean_x;
+			const T dy = other.mean_y - mean_y;
+			const T f = sum_w * other.sum_w / wab;
+
+			sxx += other.sxx + dx * dx * f;
+			syy += other.syy + dy * dy * f;
+			sxy += other.sxy + dx * dy * f;
+			mean_x += dx * (other.sum_w / wab);
+			mean_y += dy * (other.sum_w / wab);
+			n += other.n;
+			sum_w = wab;
+		}
+	};
+
+	namespace detail {
+
+		/// Weighted moments of a block and whether it held an invalid weight (< 0 or NaN).
+		template <std::floating_point Acc>
+		struct WeightedBlock {
+			WeightedCoMoments<Acc> m;
+			bool invalid = false;
+		};
+
+		/**
+		 * @brief Corrected two-pass weighted co-moments of one cache-resident block.
+		 *
+		 * Same scheme as block_co_moments(): the weighted means come from
+		 * simd::weighted_sums(), the second pass re-reads the block from L1.
+		 */
+		template <std::floating_point T, std::floating_point Acc = T>
+		[[nodiscard]]
+		WeightedBlock<Acc> block_weighted_co_moments(const T* w, const T* x, const T* y, std::size_t n) noexcept
+		{
+			std::size_t positive = 0;
+			bool invalid = false;
+			for (std::size_t i = 0; i < n; ++i) {
+				positive += w[i] > T{ 0 };
+				invalid |= !(w[i] >= T{ 0 });
+			}
+			if (positive == 0 || invalid)
+				return { {}, invalid };
+
+			Acc sw{}, swx{}, swy{};
+			simd::weighted_sums(w, x, y, n, sw, swx, swy);
+			const Acc mx = swx / sw;
+			const Acc my = swy / sw;
+
+			const auto c = simd::weighted_centered_sums(w, x, y, n, mx, my);
+			return { { positive, sw, mx, my,
+				c.dxx - c.dx * c.dx / sw,
+				c.dyy - c.dy * c.dy / sw,
+				c.dxy - c.dx * c.dy / sw }, false };
+		}
+
+		/**
+		 * @brief Blockwise weighted co-moments of equally sized x, y, w.
+		 *
+		 * Invalid weights are flagged instead of thrown: the chunks may run on
+		 * std::execution::par, where an exception would terminate.
+		 */
+		template <std::floating_point T, std::floating_point Acc, ExecutionPolicy Policy>
+		[[nodiscard]]
+		WeightedBlock<Acc> weighted_reduce(std::span<const T> x, std::span<const T> y, std::span<const T> w,
+			const Policy& policy)
+		{
+			return chunked_reduce(policy, x.size(), WeightedBlock<Acc>{},
+				[px = x.data(), py = y.data(), pw = w.data()](std::size_t begin, std::size_t len) {
+					WeightedBlock<Acc> acc{};
+					for (std::size_t i = begin; i < begin + len; i += co_moment_block) {
+						const auto blk = std::min(co_moment_block, begin + len - i);
+						const auto b = block_weighted_co_moments<T, Acc>(pw + i, px + i, py + i, blk);
+						acc.m.merge(b.m);
+						acc.invalid |= b.invalid;
+					}
+					return acc;
+				},
+				[](WeightedBlock<Acc> a, const WeightedBlock<Acc>& b) {
+					a.m.merge(b.m);
+					a.invalid |= b.invalid;
+					return a;
+				});
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Weighted means and centered co-moments in one streaming pass.
+	 * @tparam Acc Accumulator and result type (default: T).
+	 * @param x First variable.
+	 * @param y Second variable.
+	 * @param w Non-negative weight of each point.
+	 * @param policy Execution policy (default: exec::automatic).
+	 * @return WeightedCoMoments (all zero if no weight is positive).
+	 * @throws std::invalid_argument if sizes differ or a weight is negative or NaN.
+	 *
+	 * Blockwise like co_moments(): x, y and w are each loaded from memory once,
+	 * and no weighted copies of the data are built.
+	 */
+	template <std::floating_point T, std::floating_point Acc = T, ExecutionPolicy Policy = exec::automatic_policy>
+	[[nodiscard]]
+	WeightedCoMoments<Acc> weighted_co_moments(std::span<const T> x, std::span<const T> y, std::span<const T> w,
+		const Policy& policy = {})
+	{
+		if (x.size() != y.size() || x.size() != w.size())
+			throw std::invalid_argument("weighted_co_moments: vectors must have same size");
+
+		const auto result = detail::weighted_reduce<T, Acc>(x, y, w, policy);
+		if (result.invalid)
+			throw std::invalid_argument("weighted_co_moments: weights must be non-negative");
+		return result.m;
 	}
 
 	/// @brief Convenience overload: accepts any SpanCompatible container.
-	template <Helper::SpanCompatible C>
+	template <Helper::SpanCompatible C, ExecutionPolicy Policy = exec::automatic_policy>
 	[[nodiscard]]
-	auto inner_product(const C& x, const C& y)
+	auto weighted_co_moments(const C& x, const C& y, const C& w, const Policy& policy = {})
 	{
-		return inner_product(Helper::as_span(x), Helper::as_span(y));
+		return weighted_co_moments(Helper::as_span(x), Helper::as_span(y), Helper::as_span(w), policy);
 	}
 
 } // namespace Stats
\ No newline at end of file
@@ -0,0 +1,321 @@
+/**
+ * @file streaming.h
+ * @brief Chunked streaming fit with overlapped reading and reduction
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * fit_streaming() pulls fixed-size chunks from a source on a producer thread
+ * into one of two buffers while the calling thread reduces the other buffer
+ * into an Accumulator. Reading/parsing and reduction therefore overlap, and
+ * memory stays at two chunks regardless of the input size.
+ *
+ * Sources:
+ * - ColumnStreamReader: two columns of a ColumnFile (see mapped_file.h), read
+ *   with buffered file I/O; suited to network storage where mmap page faults
+ *   would stall the reduction
+ * - CsvStreamReader: two fields of a CSV file, parsed block by block
+ * - any type satisfying ChunkSource
+ *
+ * Example:
+ * @code
+ * LinearRegression::CsvStreamReader<double> src("sensor.csv", 0, 3);
+ * auto r = LinearRegression::fit_streaming(src);
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "accumulator.h"
+#include "csv_parser.h"
+#include "mapped_file.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Producer of (x, y) chunks
+	 *
+	 * s.read(x, y) fills up to x.size() points into x and y (same size) and
+	 * returns the number written; 0 signals the end of the input. Errors are
+	 * reported by throwing.
+	 */
+	template <class S>
+	concept ChunkSource = std::is_floating_point_v<typename S::value_type>
+		&& requires(S & s, std::span<typename S::value_type> x, std::span<typename S::value_type> y) {
+			{ s.read(x, y) } -> std::convertible_to<std::size_t>;
+	};
+
+	/// Default number of points per chunk (two buffers of x and y are kept).
+	inline constexpr std::size_t default_stream_chunk = std::size_t{ 1 } << 16;
+
+	/**
+	 * @brief Streams two columns of a ColumnFile with buffered reads
+	 * @tparam T float or double; must match the stored type
+	 * @throws std::runtime_error if the file is not a valid column file
+	 * @throws std::out_of_range / std::invalid_argument as ColumnFile::column()
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	class ColumnStreamReader {
+	public:
+		using value_type = T;
+
+		ColumnStreamReader(const std::filesystem::path& path, std::size_t x_column, std::size_t y_column)
+			: x_(path, std::ios::binary), y_(path, std::ios::binary)
+		{
+			if (!x_ || !y_)
+				throw std::runtime_error("ColumnStreamReader: cannot open " + path.string());
+			std::array<std::byte, detail::column_header_size> raw{};
+			x_.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()));
+			const auto bytes = x_ ? raw.size() : 0;
+			const auto header = detail::parse_column_header(std::span<const std::byte>(raw.data(), bytes),
+				static_cast<std::size_t>(std::filesystem::file_size(path)), path);
+
+			if (x_column >= header.columns || y_column >= header.columns)
+				throw std::out_of_range("ColumnStreamReader: column index out of range");
+			if (detail::column_type_of<T>() != header.type)
+				throw std::invalid_argument("ColumnStreamReader: requested type does not match the stored type");
+
+			remaining_ = header.rows;
+			x_.seekg(static_cast<std::streamoff>(header.offset(x_column)));
+			y_.seekg(static_cast<std::streamoff>(header.offset(y_column)));
+		}
+
+		/// @brief Reads the next min(x.size(), remaining) points.
+		std::size_t read(std::span<T> x, std::span<T> y)
+		{
+			const auto n = std::min({ x.size(), y.size(), remaining_ });
+			const auto bytes = static_cast<std::streamsize>(n * sizeof(T));
+			x_.read(reinterpret_cast<char*>(x.data()), bytes);
+			y_.read(reinterpret_cast<char*>(y.data()), bytes);
+			if (!x_ || !y_)
+				throw std::runtime_error("ColumnStreamReader: read failed");
+			remaining_ -= n;
+			return n;
+		}
+
+	private:
+		std::ifstream x_, y_;
+		std::size_t remaining_ = 0;
+	};
+
+	/**
+	 * @brief Streams two fields of a CSV file, parsing one block at a time
+	 * @tparam T Floating-point type
+	 * @throws std::runtime_error if the file cannot be opened; read() throws on a
+	 *         malformed row if options.malformed == MalformedRows::fail
+	 *
+	 * Lines are parsed as by parse_columns() (see csv_parser.h); skipped rows
+	 * are counted in stats().
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	class CsvStreamReader {
+	public:
+		using value_type = T;
+
+		/**
+		 * @param path CSV file
+		 * @param x_column Zero-based field index of x
+		 * @param y_column Zero-based field index of y
+		 * @param options Text format options
+		 * @param block_bytes Size of the read buffer (grows if a line is longer)
+		 */
+		CsvStreamReader(const std::filesystem::path& path, std::size_t x_column, std::size_t y_column,
+			const CsvOptions& options = {}, std::size_t block_bytes = std::size_t{ 1 } << 20)
+			: in_(path, std::ios::binary), columns_{ x_column, y_column }, options_(options),
+			skip_line_(options.skip_header), buffer_(std::max<std::size_t>(block_bytes, 64))
+		{
+			if (!in_)
+				throw std::runtime_error("CsvStreamReader: cannot open " + path.string());
+		}
+
+		std::size_t read(std::span<T> x, std::span<T> y)
+		{
+			const auto capacity = std::min(x.size(), y.size());
+			std::size_t n = 0;
+			std::array<T, 2> values{};
+			while (n < capacity) {
+				const char* b = buffer_.data() + begin_;
+				const char* e = buffer_.data() + end_;
+				const char* eol = std::find(b, e, '\n');
+				if (eol == e && !eof_) {
+					refill();
+					continue;
+				}
+				if (b == e)
+					break;  // end of input
+
+				const char* stop = detail::line_stop(b, eol);
+				++line_;
+				begin_ = static_cast<std::size_t>(eol - buffer_.data()) + (eol < e);
+				if (skip_line_) {
+					skip_line_ = false;
+					continue;
+				}
+				if (detail::is_ignorable(b, stop, options_)) {
+					++stats_.skipped;
+					continue;
+				}
+				if (!detail::parse_fields(b, stop, std::span<const std::size_t>(columns_), options_,
+					std::span<T>(values))) {
+					if (options_.malformed == MalformedRows::fail)
+						throw std::runtime_error("CsvStreamReader: malformed row in line " + std::to_string(line_));
+					if (stats_.malformed++ == 0)
+						stats_.first_malformed_line = line_;
+					continue;
+				}
+				++stats_.rows;
+				x[n] = values[0];
+				y[n] = values[1];
+				++n;
+			}
+			return n;
+		}
+
+		/// @brief Rows delivered and lines skipped so far.
+		[[nodiscard]] const ParseStats& stats() const noexcept { return stats_; }
+
+	private:
+		/// Moves the partial line to the front and appends the next block.
+		void refill()
+		{
+			const auto tail = end_ - begin_;
+			std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(begin_),
+				buffer_.begin() + static_cast<std::ptrdiff_t>(end_), buffer_.begin());
+			begin_ = 0;
+			end_ = tail;
+			if (end_ == buffer_.size())
+				buffer_.resize(buffer_.size() * 2);  // a single line exceeds the block
+			in_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+			end_ += static_cast<std::size_t>(in_.gcount());
+			eof_ = in_.eof();
+			if (!eof_ && !in_)
+				throw std::runtime_error("CsvStreamReader: read failed");
+		}
+
+		std::ifstream in_;
+		std::array<std::size_t, 2> columns_;
+		CsvOptions options_;
+		ParseStats stats_;
+		bool skip_line_;
+		bool eof_ = false;
+		std::vector<char> buffer_;
+		std::size_t begin_ = 0;
+		std::size_t end_ = 0;
+		std::size_t line_ = 0;
+	};
+
+	/**
+	 * @brief Feeds a source into an accumulator, reading on a producer thread
+	 * @param source Chunk source; read() is only called from the producer thread
+	 * @param acc Accumulator receiving all points
+	 * @param chunk Points per buffer
+	 * @throws whatever source.read() throws, after both threads have stopped
+	 *
+	 * Two buffers alternate between the threads: while the calling thread
+	 * merges chunk k into acc, the producer fills chunk k + 1.
+	 */
+	template <ChunkSource Source>
+	void stream_into(Source& source, Accumulator<typename Source::value_type>& acc,
+		std::size_t chunk = default_stream_chunk)
+	{
+		using T = typename Source::value_type;
+		if (chunk == 0)
+			throw std::invalid_argument("stream_into: chunk must be positive");
+
+		struct Buffer {
+			std::vector<T> x, y;
+			std::size_t n = 0;
+			bool full = false;
+		};
+		std::array<Buffer, 2> buffers;
+		for (auto& b : buffers) {
+			b.x.resize(chunk);
+			b.y.resize(chunk);
+		}
+		std::mutex mutex;
+		std::condition_variable_any cv;
+		std::exception_ptr error;
+
+		std::jthread producer([&](std::stop_token stop) {
+			for (std::size_t i = 0;; i ^= 1) {
+				auto& b = buffers[i];
+				{
+					std::unique_lock lock(mutex);
+					if (!cv.wait(lock, stop, [&] { return !b.full; }))
+						return;
+				}
+				std::size_t n = 0;
+				try {
+					n = source.read(std::span<T>(b.x), std::span<T>(b.y));
+				}
+				catch (...) {
+					std::lock_guard lock(mutex);
+					error = std::current_exception();
+				}
+				{
+					std::lock_guard lock(mutex);
+					b.n = error ? 0 : n;
+					b.full = true;
+				}
+				cv.notify_all();
+				if (b.n == 0)
+					return;
+			}
+		});
+
+		for (std::size_t i = 0;; i ^= 1) {
+			auto& b = buffers[i];
+			{
+				std::unique_lock lock(mutex);
+				cv.wait(lock, [&] { return b.full; });
+			}
+			if (b.n == 0)
+				break;
+			acc.push(std::span<const T>(b.x.data(), b.n), std::span<const T>(b.y.data(), b.n));
+			{
+				std::lock_guard lock(mutex);
+				b.full = false;
+			}
+			cv.notify_all();
+		}
+
+		producer.join();
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	/**
+	 * @brief Fits all points of a source without holding them in memory
+	 * @param source Chunk source (e.g. CsvStreamReader, ColumnStreamReader)
+	 * @param chunk Points per buffer
+	 * @return FitResult of the whole input, as fit() would return it
+	 * @throws whatever source.read() throws
+	 */
+	template <ChunkSource Source>
+	[[nodiscard]]
+	FitResult<typename Source::value_type> fit_streaming(Source& source,
+		std::size_t chunk = default_stream_chunk)
+	{
+		Accumulator<typename Source::value_type> acc;
+		stream_into(source, acc, chunk);
+		return acc.result();
+	}
+
+} // namespace LinearRegression
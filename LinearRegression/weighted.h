@@ -0,0 +1,228 @@
+/**
+ * @file weighted.h
+ * @brief Weighted least squares fit of a line
+ * @author Haasrobertgmxnet
+ * @date 2026
+ *
+ * fit(x, y, w) minimizes Σwᵢ(yᵢ - β₀ - β₁xᵢ)². Typical weights are inverse
+ * variances wᵢ = 1/σᵢ² of the measurements; wᵢ = 0 drops a point.
+ *
+ * All statistics follow from the weighted co-moments
+ *   x̄ = Σwᵢxᵢ / Σwᵢ,  Sxx = Σwᵢ(xᵢ - x̄)²,  Sxy = Σwᵢ(xᵢ - x̄)(yᵢ - ȳ), ...
+ * which Stats::weighted_co_moments() computes in one pass over x, y and w
+ * (see simd::weighted_sums() and simd::weighted_centered_sums()). No
+ * weighted or centered copies of the data are built.
+ *
+ * With these, β₁ = Sxy / Sxx and β₀ = ȳ - β₁x̄ as in fit(). As in fit(),
+ * the weighted residual sum of squares SSE = Σwᵢ(yᵢ - β₀ - β₁xᵢ)² takes an
+ * explicit second pass; the closed form Syy - β₁Sxy (used by
+ * fit_from_moments(), which has no data) cancels badly for float input.
+ *
+ * Standard error of the slope:
+ * - WeightScale::estimated: weights are relative, the residual scale is
+ *   estimated as s² = SSE / (n - 2); SE(β₁) = s / √Sxx with t(n - 2).
+ * - WeightScale::known: wᵢ = 1/σᵢ² with the true σᵢ; SE(β₁) = 1 / √Sxx with
+ *   the normal quantile.
+ *
+ * Example:
+ * @code
+ * std::vector<double> x = ..., y = ..., sigma = ...;
+ * std::vector<double> w(sigma.size());
+ * std::ranges::transform(sigma, w.begin(), [](double s) { return 1.0 / (s * s); });
+ * auto r = LinearRegression::fit(x, y, w);
+ * auto [lo, hi] = LinearRegression::ci_slope(r, 0.05, LinearRegression::WeightScale::known);
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <boost/math/distributions/normal.hpp>
+#include "linreg.h"
+#include "predict.h"
+#include "span_compatible.h"
+#include "stats.h"
+
+namespace LinearRegression {
+
+	/**
+	 * @brief Result of a weighted fit
+	 *
+	 * The FitResult fields hold the weighted quantities: means, Sxx, Syy, Sxy
+	 * and SSE are weighted sums, rho is the weighted correlation. n counts the
+	 * points with positive weight.
+	 */
+	template <class T>
+	struct WeightedFitResult : FitResult<T> {
+		T sum_w;  ///< Σwᵢ
+	};
+
+	/// @brief How ci_slope() interprets the weights of a WeightedFitResult.
+	enum class WeightScale {
+		estimated,  ///< Relative weights; the residual variance is estimated from the fit
+		known       ///< wᵢ = 1/σᵢ² with known σᵢ; no variance is estimated
+	};
+
+	/**
+	 * @brief Builds a WeightedFitResult from precomputed weighted co-moments
+	 * @tparam T Floating-point type
+	 * @param m Weighted count, means and centered co-moments of the data
+	 * @return WeightedFitResult<T> derived from the moments
+	 *
+	 * The SSE is taken in closed form, SSE = Syy - β₁Sxy, which loses
+	 * accuracy when the fit explains most of Syy; fit(x, y, w) recomputes it
+	 * from the residuals.
+	 *
+	 * @note Returns empty WeightedFitResult if fewer than 3 points have a
+	 *       positive weight or Sxx = 0.
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	constexpr WeightedFitResult<T> fit_from_moments(const Stats::WeightedCoMoments<T>& m)
+	{
+		if (m.n < 3 || m.sxx == T{ 0 }) {
+			return {};
+		}
+
+		auto fitResult = WeightedFitResult<T>{};
+		fitResult.n = m.n;
+		fitResult.sum_w = m.sum_w;
+		fitResult.mean_x = m.mean_x;
+		fitResult.mean_y = m.mean_y;
+		fitResult.sxx = m.sxx;
+		fitResult.syy = m.syy;
+		fitResult.sxy = m.sxy;
+
+		fitResult.beta1 = m.sxy / m.sxx;
+		fitResult.beta0 = m.mean_y - fitResult.beta1 * m.mean_x;
+		fitResult.rho = m.sxy / Helper::sqrt(m.sxx * m.syy);
+		fitResult.sse = std::max(m.syy - fitResult.beta1 * m.sxy, T{ 0 });
+
+		return fitResult;
+	}
+
+	namespace detail {
+
+		/// @brief Explicit weighted SSE = Σwᵢ(yᵢ - β₀ - β₁xᵢ)²; points with wᵢ = 0 are skipped.
+		template <typename T, typename Acc, Stats::ExecutionPolicy Policy>
+		[[nodiscard]]
+		Acc weighted_residual_sum_of_squares(const FitResult<Acc>& fitResult, std::span<const T> x,
+			std::span<const T> y, std::span<const T> w, const Policy& policy)
+		{
+			return Stats::detail::chunked_reduce(policy, x.size(), Acc{},
+				[&fitResult, px = x.data(), py = y.data(), pw = w.data()](std::size_t begin, std::size_t len) {
+					Acc acc{};
+					for (std::size_t i = begin; i < begin + len; ++i) {
+						const Acc wi = static_cast<Acc>(pw[i]);
+						if (!(wi > Acc{ 0 }))
+							continue;
+						const Acc diff = static_cast<Acc>(py[i]) - (fitResult.beta0 + fitResult.beta1 * static_cast<Acc>(px[i]));
+						acc += wi * diff * diff;
+					}
+					return acc;
+				}
+			);
+		}
+
+	} // namespace detail
+
+	/**
+	 * @brief Fits a line by weighted least squares
+	 * @tparam T Numeric type (must be arithmetic, typically float or double)
+	 * @tparam Acc Accumulator type of the reduction and of the result (default: T)
+	 * @param x Independent variable values (features)
+	 * @param y Dependent variable values (targets)
+	 * @param w Non-negative weight of each point
+	 * @param policy Execution policy for the reduction (default: Stats::exec::automatic)
+	 * @return WeightedFitResult<Acc> containing all regression statistics
+	 *
+	 * With all weights equal, the coefficients equal those of fit().
+	 *
+	 * @note Returns empty WeightedFitResult if:
+	 *       - x, y and w have different sizes
+	 *       - a weight is negative or NaN
+	 *       - fewer than 3 points have a positive weight
+	 *       - the weighted Sxx is 0
+	 */
+	template <typename T, typename Acc = T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T> && std::is_floating_point_v<Acc>
+	[[nodiscard]]
+	WeightedFitResult<Acc> fit(std::span<const T> x, std::span<const T> y, std::span<const T> w,
+		const Policy& policy = {})
+	{
+		if (x.size() != y.size() || x.size() != w.size() || x.size() < 3) {
+			return {};
+		}
+		const auto result = Stats::detail::weighted_reduce<T, Acc>(x, y, w, policy);
+		if (result.invalid) {
+			return {};
+		}
+		auto fitResult = fit_from_moments(result.m);
+		if (fitResult.n == 0) {
+			return {};
+		}
+		fitResult.sse = detail::weighted_residual_sum_of_squares(fitResult, x, y, w, policy);
+		return fitResult;
+	}
+
+	/// @brief Container overload for the weighted fit function
+	template <Helper::SpanCompatible C, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+	[[nodiscard]]
+	WeightedFitResult<typename C::value_type> fit(const C& x, const C& y, const C& w, const Policy& policy = {})
+	{
+		return fit(Helper::as_span(x), Helper::as_span(y), Helper::as_span(w), policy);
+	}
+
+	/**
+	 * @brief Confidence interval for the slope of a weighted fit
+	 * @param fitResult The result from a weighted fit() call
+	 * @param alpha Significance level (e.g., 0.05 for 95% confidence)
+	 * @param scale Whether the weights are relative or absolute inverse variances
+	 * @return Pair of (lower bound, upper bound) for the slope
+	 *
+	 * estimated: β₁ ± t(1-α/2, n-2) × √(SSE / (n-2) / Sxx), the formula of
+	 * ci_slope(FitResult) applied to the weighted sums.
+	 * known:     β₁ ± z(1-α/2) / √Sxx.
+	 */
+	template <typename T>
+		requires std::is_floating_point_v<T>
+	[[nodiscard]]
+	std::pair<T, T> ci_slope(const WeightedFitResult<T>& fitResult, const T alpha,
+		const WeightScale scale = WeightScale::estimated)
+	{
+		if (scale == WeightScale::estimated) {
+			return ci_slope<T>(static_cast<const FitResult<T>&>(fitResult), alpha);
+		}
+
+		const auto sb = T{ 1 } / std::sqrt(fitResult.sxx);
+		const auto quantile = boost::math::quantile(
+			boost::math::normal_distribution<T>{}, T{ 1 } - T{ 0.5 } * alpha);
+		const auto k = quantile * sb;
+		return { fitResult.beta1 - k, fitResult.beta1 + k };
+	}
+
+	/**
+	 * @brief Confidence and prediction bands of a weighted fit
+	 *
+	 * As predict_bands(FitResult) with the residual scale s² = SSE / (n - 2)
+	 * and 1/Σwᵢ in place of 1/n. The prediction band is that of a new
+	 * observation of weight 1.
+	 *
+	 * @throws std::invalid_argument if a buffer differs in size from x_new or
+	 *         the fit is empty
+	 */
+	template <typename T, Stats::ExecutionPolicy Policy = Stats::exec::automatic_policy>
+		requires std::is_floating_point_v<T>
+	void predict_bands(const WeightedFitResult<T>& fitResult, std::span<const T> x_new, const T alpha,
+		const PredictionBands<T>& out, const Policy& policy = {})
+	{
+		detail::predict_bands(static_cast<const FitResult<T>&>(fitResult), x_new, alpha, out,
+			T{ 1 } / fitResult.sum_w, policy);
+	}
+
+} // namespace LinearRegression
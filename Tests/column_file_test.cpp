@@ -0,0 +1,100 @@
+/**
+ * @file column_file_test.cpp
+ * @brief Header validation of ColumnFile and ColumnStreamReader
+ * @author Haasrobertgmxnet
+ * @date 2026
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "mapped_file.h"
+#include "streaming.h"
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool ok, const char* what)
+	{
+		if (!ok) {
+			std::fprintf(stderr, "FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	/// Writes a header with the given counts followed by payload_bytes zero bytes.
+	void write_crafted(const std::filesystem::path& path, std::uint64_t columns, std::uint64_t rows,
+		std::size_t payload_bytes)
+	{
+		std::array<char, LinearRegression::detail::column_header_size> header{};
+		const std::uint32_t version = LinearRegression::detail::column_version;
+		const auto type = static_cast<std::uint32_t>(LinearRegression::ColumnType::float64);
+		std::memcpy(header.data(), LinearRegression::detail::column_magic.data(), 8);
+		std::memcpy(header.data() + 8, &version, 4);
+		std::memcpy(header.data() + 12, &type, 4);
+		std::memcpy(header.data() + 16, &columns, 8);
+		std::memcpy(header.data() + 24, &rows, 8);
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(header.data(), header.size());
+		const std::vector<char> payload(payload_bytes);
+		out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+	}
+
+	template <class Open>
+	bool rejects(Open open)
+	{
+		try {
+			open();
+		}
+		catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	void check_rejected(const std::filesystem::path& path, const char* what)
+	{
+		check(rejects([&] { LinearRegression::ColumnFile f(path); }), what);
+		check(rejects([&] { LinearRegression::ColumnStreamReader<double> s(path, 0, 0); }), what);
+	}
+
+} // namespace
+
+int main()
+{
+	const auto path = std::filesystem::temp_directory_path() / "linreg_column_file_test.lrc";
+
+	// rows * sizeof(double) wraps to 0: must not pass the truncation check
+	write_crafted(path, 2, std::uint64_t{ 1 } << 62, 128);
+	check_rejected(path, "rows * type size overflowing to zero");
+
+	write_crafted(path, 1, std::uint64_t{ 1 } << 61, 128);
+	check_rejected(path, "rows * type size overflowing past the payload");
+
+	write_crafted(path, 0, 8, 128);
+	check_rejected(path, "zero columns");
+
+	write_crafted(path, 2, 9, 128);
+	check_rejected(path, "padded columns longer than the payload");
+
+	// A well-formed file still opens
+	const std::vector<double> x{ 1, 2, 3 }, y{ 2, 4, 6 };
+	const std::array<std::span<const double>, 2> columns{ x, y };
+	LinearRegression::write_columns(path, std::span<const std::span<const double>>(columns));
+	try {
+		LinearRegression::ColumnFile f(path);
+		check(f.rows() == 3 && f.column<double>(1)[2] == 6, "reading a valid file");
+	}
+	catch (const std::exception&) {
+		check(false, "opening a valid file");
+	}
+
+	std::filesystem::remove(path);
+	return failures == 0 ? 0 : 1;
+}
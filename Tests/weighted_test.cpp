@@ -0,0 +1,108 @@
+/**
+ * @file weighted_test.cpp
+ * @brief Zero weights in the weighted kernels, and the SSE of the weighted fit
+ * @author Haasrobertgmxnet
+ * @date 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "simd_kernels.h"
+#include "stats.h"
+#include "weighted.h"
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool ok, const char* what, Stats::simd::Isa isa)
+	{
+		if (!ok) {
+			std::fprintf(stderr, "FAILED (%s): %s\n", Stats::simd::isa_name(isa), what);
+			++failures;
+		}
+	}
+
+	template <typename T>
+	bool approx_equal(T a, T b)
+	{
+		const T tol = std::is_same_v<T, float> ? T(1e-3) : T(1e-10);
+		return std::abs(a - b) <= tol * std::max<T>(T(1), std::abs(b));
+	}
+
+	template <typename T>
+	void check_zero_weight_rows(Stats::simd::Isa isa)
+	{
+		constexpr std::size_t n = 1000;  // several blocks, with vector bodies and scalar tails
+		std::mt19937 gen(42);
+		std::uniform_real_distribution<T> value(-10, 10), weight(T(0.5), T(2));
+		std::vector<T> x(n), y(n), w(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			x[i] = value(gen);
+			y[i] = T(3) + T(2) * x[i] + value(gen);
+			w[i] = weight(gen);
+			if (i % 7 == 3) {
+				// A dropped row may hold anything
+				w[i] = 0;
+				x[i] = std::numeric_limits<T>::quiet_NaN();
+				y[i] = i % 2 ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::quiet_NaN();
+			}
+		}
+
+		Stats::WeightedCoMoments<T> expected;
+		for (std::size_t i = 0; i < n; ++i)
+			expected.push(x[i], y[i], w[i]);
+		const auto m = Stats::weighted_co_moments(std::span<const T>(x), std::span<const T>(y),
+			std::span<const T>(w), Stats::exec::seq);
+
+		check(m.n == expected.n, "number of points", isa);
+		check(approx_equal(m.sum_w, expected.sum_w), "sum of weights", isa);
+		check(approx_equal(m.mean_x, expected.mean_x) && approx_equal(m.mean_y, expected.mean_y), "weighted means", isa);
+		check(approx_equal(m.sxx, expected.sxx) && approx_equal(m.syy, expected.syy) && approx_equal(m.sxy, expected.sxy),
+			"centered co-moments", isa);
+	}
+
+	/// The weighted SSE of a float fit must match the brute-force sum for its coefficients.
+	void check_float_sse(Stats::simd::Isa isa)
+	{
+		constexpr std::size_t n = 70001;  // Syy is about 1e6 times the SSE
+		std::mt19937 gen(7);
+		std::uniform_real_distribution<float> value(0, 1000), weight(0.5f, 2.0f);
+		std::normal_distribution<float> noise(0, 1);
+		std::vector<float> x(n), y(n), w(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			x[i] = value(gen);
+			y[i] = 5.0f + 3.0f * x[i] + noise(gen);
+			w[i] = i % 11 == 0 ? 0.0f : weight(gen);
+		}
+
+		const auto r = LinearRegression::fit(x, y, w);
+		long double sse = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			const long double e = static_cast<long double>(y[i]) - r.beta0 - static_cast<long double>(r.beta1) * x[i];
+			sse += w[i] * e * e;
+		}
+		check(r.n == n - (n + 10) / 11, "points with positive weight", isa);
+		check(std::abs(static_cast<long double>(r.sse) - sse) <= 1e-3L * sse, "weighted SSE of a float fit", isa);
+	}
+
+} // namespace
+
+int main()
+{
+	using Stats::simd::Isa;
+	for (const auto requested : { Isa::scalar, Isa::avx2, Isa::avx512, Isa::neon }) {
+		const auto isa = Stats::simd::set_isa(requested);
+		check_zero_weight_rows<float>(isa);
+		check_zero_weight_rows<double>(isa);
+		check_float_sse(isa);
+	}
+	return failures == 0 ? 0 : 1;
+}